@@ -0,0 +1,75 @@
+#ifndef ADMISSION_CONTROL_H
+#define ADMISSION_CONTROL_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// 예산 초과 시 처리 정책
+enum class OverflowPolicy
+{
+    Reject,     // 새 프레임을 읽어서 버리고 Rejected ACK 회신
+    DropOldest, // 해당 연결에서 가장 오래 대기 중인 프레임을 버리고 새 프레임 수용
+};
+
+// 서버 수신 측 입장 제어 설정
+struct AdmissionConfig
+{
+    uint32_t maxFrameSize = 16u * 1024 * 1024;         // 프레임 하나의 최대 크기. 초과 시 연결 종료
+    size_t connectionBudget = 64u * 1024 * 1024;       // 연결당 버퍼링 가능한 프레임 바이트 합
+    size_t globalBudget = 512u * 1024 * 1024;          // 전체 연결의 버퍼링 프레임 바이트 합
+    uint32_t maxQueuedFrames = 16;                     // 연결당 대기 + 처리 중 프레임 수 (credit 상한)
+    uint32_t maxConcurrentFrames = 2;                  // 연결당 동시에 작업 스레드에서 처리되는 프레임 수
+    OverflowPolicy policy = OverflowPolicy::Reject;
+};
+
+static inline bool parseOverflowPolicy(const std::string &name, OverflowPolicy &policy)
+{
+    if (name == "reject")
+    {
+        policy = OverflowPolicy::Reject;
+        return true;
+    }
+    if (name == "drop-oldest")
+    {
+        policy = OverflowPolicy::DropOldest;
+        return true;
+    }
+    return false;
+}
+
+// 전체 연결이 공유하는 메모리 예산. 여러 스레드에서 호출될 수 있으므로 원자적으로 관리
+class MemoryBudget
+{
+public:
+    explicit MemoryBudget(size_t limit) : limit_(limit) {}
+
+    // limit 를 넘지 않으면 bytes 만큼 예약하고 true 반환
+    bool tryAcquire(size_t bytes)
+    {
+        size_t current = used_.load(std::memory_order_relaxed);
+        while (current + bytes <= limit_)
+        {
+            if (used_.compare_exchange_weak(current, current + bytes, std::memory_order_acq_rel))
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void release(size_t bytes)
+    {
+        used_.fetch_sub(bytes, std::memory_order_acq_rel);
+    }
+
+    size_t used() const { return used_.load(std::memory_order_relaxed); }
+    size_t limit() const { return limit_; }
+
+private:
+    const size_t limit_;
+    std::atomic<size_t> used_{0};
+};
+
+#endif // ADMISSION_CONTROL_H
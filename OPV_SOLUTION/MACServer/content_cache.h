@@ -0,0 +1,145 @@
+#ifndef CONTENT_CACHE_H
+#define CONTENT_CACHE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+
+// 수신 바이트 내용 기준 결과 캐시
+//
+// 고정 카메라는 거의 같은 JPEG 를 반복해서 보내므로, 인코딩된 바이트의 해시로 분석 결과를 찾아
+// 같은 프레임이면 픽셀을 디코딩하지 않고 결과를 재사용함. 용량을 넘으면 가장 오래 쓰이지 않은 항목부터 버림 (LRU).
+// 여러 작업 스레드에서 호출되므로 뮤텍스로 보호 (조회/삽입은 해시 테이블 연산 한 번).
+
+// 64비트 내용 해시 (xxHash64 와 같은 4 레인 곱셈-회전 구조, 8 바이트씩 처리)
+static inline uint64_t contentHash(const void *data, size_t size, uint64_t seed = 0)
+{
+    static const uint64_t P1 = 0x9E3779B185EBCA87ULL;
+    static const uint64_t P2 = 0xC2B2AE3D27D4EB4FULL;
+    static const uint64_t P3 = 0x165667B19E3779F9ULL;
+    static const uint64_t P4 = 0x85EBCA77C2B2AE63ULL;
+    static const uint64_t P5 = 0x27D4EB2F165667C5ULL;
+    auto rotl = [](uint64_t x, int r)
+    { return (x << r) | (x >> (64 - r)); };
+    auto read64 = [](const unsigned char *p)
+    {
+        uint64_t v;
+        std::memcpy(&v, p, 8);
+        return v;
+    };
+    auto round = [&](uint64_t acc, uint64_t input)
+    { return rotl(acc + input * P2, 31) * P1; };
+
+    const unsigned char *p = static_cast<const unsigned char *>(data);
+    const unsigned char *end = p + size;
+    uint64_t h;
+    if (size >= 32)
+    {
+        uint64_t v1 = seed + P1 + P2, v2 = seed + P2, v3 = seed, v4 = seed - P1;
+        for (; p + 32 <= end; p += 32)
+        {
+            v1 = round(v1, read64(p));
+            v2 = round(v2, read64(p + 8));
+            v3 = round(v3, read64(p + 16));
+            v4 = round(v4, read64(p + 24));
+        }
+        h = rotl(v1, 1) + rotl(v2, 7) + rotl(v3, 12) + rotl(v4, 18);
+        for (uint64_t v : {v1, v2, v3, v4})
+        {
+            h = (h ^ round(0, v)) * P1 + P4;
+        }
+    }
+    else
+    {
+        h = seed + P5;
+    }
+    h += size;
+
+    for (; p + 8 <= end; p += 8)
+    {
+        h = rotl(h ^ round(0, read64(p)), 27) * P1 + P4;
+    }
+    for (; p < end; ++p)
+    {
+        h = rotl(h ^ (*p * P5), 11) * P1;
+    }
+
+    h ^= h >> 33;
+    h *= P2;
+    h ^= h >> 29;
+    h *= P3;
+    h ^= h >> 32;
+    return h;
+}
+
+template <class Value>
+class ContentCache
+{
+public:
+    explicit ContentCache(size_t capacity) : capacity_(capacity) {}
+
+    size_t capacity() const { return capacity_; }
+
+    // 같은 해시 + 길이의 항목이 있으면 value 에 복사하고 가장 최근 사용으로 옮김
+    bool lookup(uint64_t hash, size_t size, Value &value)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = index_.find(hash);
+        if (it == index_.end() || it->second->size != size)
+        {
+            return false;
+        }
+        entries_.splice(entries_.begin(), entries_, it->second);
+        value = it->second->value;
+        return true;
+    }
+
+    void insert(uint64_t hash, size_t size, Value value)
+    {
+        if (capacity_ == 0)
+        {
+            return;
+        }
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = index_.find(hash);
+        if (it != index_.end())
+        {
+            it->second->size = size;
+            it->second->value = std::move(value);
+            entries_.splice(entries_.begin(), entries_, it->second);
+            return;
+        }
+        if (entries_.size() >= capacity_)
+        {
+            index_.erase(entries_.back().hash);
+            entries_.pop_back();
+        }
+        entries_.push_front(Entry{hash, size, std::move(value)});
+        index_.emplace(hash, entries_.begin());
+    }
+
+    size_t size() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return entries_.size();
+    }
+
+private:
+    struct Entry
+    {
+        uint64_t hash;
+        size_t size;
+        Value value;
+    };
+
+    size_t capacity_;
+    mutable std::mutex mutex_;
+    std::list<Entry> entries_; // 앞쪽이 최근 사용
+    std::unordered_map<uint64_t, typename std::list<Entry>::iterator> index_;
+};
+
+#endif // CONTENT_CACHE_H
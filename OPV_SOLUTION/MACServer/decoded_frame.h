@@ -0,0 +1,124 @@
+#ifndef DECODED_FRAME_H
+#define DECODED_FRAME_H
+
+#include <opencv2/opencv.hpp>
+#include <array>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "metrics.h"
+#include "trace.h"
+
+// 디코딩 해상도 단계
+// 1/2, 1/4, 1/8 은 libjpeg 의 DCT 영역 축소 디코딩(IMREAD_REDUCED_COLOR_*)을 사용하므로
+// 전체 디코딩 후 resize 하는 것보다 훨씬 적은 연산으로 끝남
+enum class DecodeScale
+{
+    Full = 0,
+    Half = 1,
+    Quarter = 2,
+    Eighth = 3,
+};
+
+static constexpr size_t DECODE_SCALE_COUNT = 4;
+
+static inline int decodeScaleDivisor(DecodeScale scale)
+{
+    return 1 << static_cast<int>(scale);
+}
+
+static inline int decodeScaleFlag(DecodeScale scale)
+{
+    switch (scale)
+    {
+    case DecodeScale::Half:
+        return cv::IMREAD_REDUCED_COLOR_2;
+    case DecodeScale::Quarter:
+        return cv::IMREAD_REDUCED_COLOR_4;
+    case DecodeScale::Eighth:
+        return cv::IMREAD_REDUCED_COLOR_8;
+    case DecodeScale::Full:
+    default:
+        return cv::IMREAD_COLOR;
+    }
+}
+
+static inline bool parseDecodeScale(const std::string &name, DecodeScale &scale)
+{
+    static const char *names[] = {"full", "half", "quarter", "eighth"};
+    for (size_t i = 0; i < DECODE_SCALE_COUNT; ++i)
+    {
+        if (name == names[i])
+        {
+            scale = static_cast<DecodeScale>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+// 해상도별 디코딩 시간 기록용 (없으면 기록하지 않음)
+using DecodeTimers = std::array<Histogram *, DECODE_SCALE_COUNT>;
+
+// 수신한 JPEG 프레임 하나의 해상도별 디코딩 결과 캐시
+// 소비자는 필요한 해상도만 요청하고, 각 해상도는 처음 요청될 때 한 번만 만들어짐.
+// 더 큰 해상도가 이미 캐시되어 있으면 다시 디코딩하지 않고 그 이미지를 축소해서 사용.
+// 여러 작업 스레드의 소비자가 같은 프레임을 공유할 수 있도록 스레드 안전.
+class DecodedFrame
+{
+public:
+    DecodedFrame(const std::vector<char> &encoded, const DecodeTimers *timers = nullptr)
+        : encoded_(encoded), timers_(timers) {}
+
+    // 요청한 해상도의 BGR 이미지. 디코딩 실패 시 빈 Mat
+    cv::Mat at(DecodeScale scale)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        size_t index = static_cast<size_t>(scale);
+        if (!cache_[index].empty())
+        {
+            return cache_[index];
+        }
+
+        // 가장 가까운 더 큰 해상도가 캐시에 있으면 INTER_AREA 로 축소
+        for (size_t finer = index; finer-- > 0;)
+        {
+            if (!cache_[finer].empty())
+            {
+                int factor = 1 << (index - finer);
+                cv::resize(cache_[finer], cache_[index],
+                           cv::Size((cache_[finer].cols + factor - 1) / factor, (cache_[finer].rows + factor - 1) / factor),
+                           0, 0, cv::INTER_AREA);
+                return cache_[index];
+            }
+        }
+
+        if (failed_)
+        {
+            return cv::Mat();
+        }
+
+        // 수신 버퍼를 복사 없이 감싸서 디코딩
+        cv::Mat buffer(1, static_cast<int>(encoded_.size()), CV_8UC1, const_cast<char *>(encoded_.data()));
+        uint64_t startNs = metricsNowNs();
+        TRACE_SCOPE("imdecode");
+        cache_[index] = cv::imdecode(buffer, decodeScaleFlag(scale));
+        if (timers_ && (*timers_)[index])
+        {
+            (*timers_)[index]->record(metricsNowNs() - startNs);
+        }
+        failed_ = cache_[index].empty();
+        return cache_[index];
+    }
+
+    const std::vector<char> &encoded() const { return encoded_; }
+
+private:
+    const std::vector<char> &encoded_;
+    const DecodeTimers *timers_;
+    std::mutex mutex_;
+    std::array<cv::Mat, DECODE_SCALE_COUNT> cache_;
+    bool failed_ = false; // 한 번 디코딩에 실패한 프레임은 다른 해상도로도 다시 시도하지 않음
+};
+
+#endif // DECODED_FRAME_H
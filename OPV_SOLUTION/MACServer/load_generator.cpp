@@ -0,0 +1,499 @@
+#include <iostream>
+#include <boost/asio.hpp>
+#include <opencv2/opencv.hpp>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include "frame_protocol.h"
+#include "frame_results.h"
+#include "metrics.h"
+
+// mac_server 부하 생성기
+// 루프백에서 N 개의 가상 Edge 클라이언트를 띄워 실제 프로토콜(레거시 / 세션 모드)로 프레임을 전송하고
+// 서버가 달성한 처리량, ACK 지연 분위수, 오류율을 보고함.
+
+using boost::asio::ip::tcp;
+
+struct LoadConfig
+{
+    std::string host = "127.0.0.1";
+    unsigned short port = 12345;
+    int clients = 4;
+    int durationSec = 10;
+    bool sessionMode = true;         // false: 레거시 (프레임마다 연결, "Acknowledged" 대기)
+    uint32_t window = FRAME_DEFAULT_WINDOW;
+    int framesPerConnection = 0;     // 세션 모드에서 N 프레임마다 재연결 (0: 연결 유지)
+    double rate = 0;                 // 클라이언트당 초당 프레임 수 (0: 제한 없음)
+    int burst = 0;                   // burst 개 연속 전송 후 burstIntervalMs 동안 대기 (0: 비활성화)
+    int burstIntervalMs = 1000;
+    std::string jpegPath;            // 전송할 JPEG 파일. 없으면 합성 이미지 사용
+    int width = 640;                 // 합성 이미지 크기
+    int height = 480;
+    size_t rawBytes = 0;             // 0 이 아니면 JPEG 대신 임의 바이트 페이로드 (전송 계층만 측정, 디코딩 실패 예상)
+    bool results = false;            // JPEG 대신 결과 전용 업링크 레코드 전송 (세션 모드만)
+    bool rawFrames = false;          // JPEG 를 처리 안 된 원본(FRAME_FLAG_RAW)으로 표시해 서버 처리 부하 측정 (세션 모드만)
+};
+
+// 모든 클라이언트 스레드가 공유하는 결과
+struct LoadStats
+{
+    std::atomic<uint64_t> framesSent{0};
+    std::atomic<uint64_t> bytesSent{0};
+    std::atomic<uint64_t> framesAcked{0};
+    std::atomic<uint64_t> connects{0};
+    std::atomic<uint64_t> connectErrors{0};
+    std::atomic<uint64_t> ioErrors{0};
+    std::atomic<uint64_t> protocolErrors{0};
+    std::atomic<uint64_t> status[7]{}; // AckStatus 별 개수
+    Histogram ackLatency{"ack_latency", "", "ACK latency"};
+};
+
+static std::vector<uchar> buildPayload(const LoadConfig &config)
+{
+    std::vector<uchar> payload;
+    if (config.results)
+    {
+        // Edge 한 프레임 분량과 비슷한 결과 레코드: QR 2 개, 직선 12 개, 윤곽선 사각형 64 개, 허브 4 개 x 기기 25 개
+        FrameResults results;
+        results.width = static_cast<uint16_t>(config.width);
+        results.height = static_cast<uint16_t>(config.height);
+        results.captureUs = 1790000000ULL * 1000000;
+        std::mt19937 rng(42);
+        for (int i = 0; i < 2; ++i)
+        {
+            QrResult code{"HUB-" + std::to_string(1000 + i), {}};
+            for (int k = 0; k < 8; ++k)
+                code.corners[k] = static_cast<float>(rng() % 480);
+            results.qrCodes.push_back(code);
+        }
+        for (int i = 0; i < 12; ++i)
+            results.lines.push_back({static_cast<float>(rng() % 800), static_cast<float>(rng() % 314) / 100.0f});
+        for (int i = 0; i < 64; ++i)
+            results.boxes.push_back({static_cast<uint16_t>(rng() % 600), static_cast<uint16_t>(rng() % 440), 24, 24});
+        results.hasScans = true;
+        for (int h = 0; h < 4; ++h)
+        {
+            ScanResult scan;
+            scan.hubId = "Hub_" + std::to_string(1000 + h);
+            for (int d = 0; d < 25; ++d)
+                scan.logList.push_back({"Server_" + std::to_string(d % 16 + 1), 10000 + h * 100 + d});
+            results.scans.push_back(scan);
+        }
+        encodeFrameResults(results, payload);
+        return payload;
+    }
+
+    if (config.rawBytes > 0)
+    {
+        payload.resize(config.rawBytes);
+        std::mt19937 rng(42);
+        for (auto &byte : payload)
+        {
+            byte = static_cast<uchar>(rng());
+        }
+        return payload;
+    }
+
+    if (!config.jpegPath.empty())
+    {
+        std::ifstream file(config.jpegPath, std::ios::binary);
+        if (!file)
+        {
+            throw std::runtime_error("Failed to open " + config.jpegPath);
+        }
+        payload.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        return payload;
+    }
+
+    // 압축률이 실제 장면과 비슷하도록 그라데이션 + 노이즈 이미지를 합성
+    cv::Mat image(config.height, config.width, CV_8UC3);
+    for (int y = 0; y < image.rows; ++y)
+    {
+        for (int x = 0; x < image.cols; ++x)
+        {
+            image.at<cv::Vec3b>(y, x) = cv::Vec3b(static_cast<uchar>(x * 255 / image.cols),
+                                                  static_cast<uchar>(y * 255 / image.rows), 128);
+        }
+    }
+    cv::Mat noise(image.rows, image.cols, CV_8UC3);
+    cv::randu(noise, cv::Scalar::all(0), cv::Scalar::all(32));
+    image += noise;
+    cv::imencode(".jpg", image, payload);
+    return payload;
+}
+
+// 동기 소켓 read 가 서버 정지 시 무한 대기하지 않도록 수신 타임아웃 설정
+static void setReceiveTimeout(tcp::socket &socket, int seconds)
+{
+    struct timeval tv;
+    tv.tv_sec = seconds;
+    tv.tv_usec = 0;
+    setsockopt(socket.native_handle(), SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+}
+
+class LoadClient
+{
+public:
+    LoadClient(const LoadConfig &config, const std::vector<uchar> &payload, LoadStats &stats,
+               std::chrono::steady_clock::time_point deadline)
+        : config_(config), payload_(payload), stats_(stats), deadline_(deadline) {}
+
+    void run()
+    {
+        auto start = std::chrono::steady_clock::now();
+        uint64_t sent = 0;
+        auto nextBurst = start;
+
+        while (std::chrono::steady_clock::now() < deadline_)
+        {
+            // 전송 패턴: burst 우선, 그 다음 고정 rate, 아니면 최대 속도
+            if (config_.burst > 0)
+            {
+                std::this_thread::sleep_until(nextBurst);
+                for (int i = 0; i < config_.burst && std::chrono::steady_clock::now() < deadline_; ++i)
+                {
+                    sendOne();
+                }
+                nextBurst += std::chrono::milliseconds(config_.burstIntervalMs);
+                continue;
+            }
+
+            if (config_.rate > 0)
+            {
+                auto due = start + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                                       std::chrono::duration<double>(sent / config_.rate));
+                std::this_thread::sleep_until(due);
+            }
+            sendOne();
+            ++sent;
+        }
+
+        drain();
+    }
+
+private:
+    void sendOne()
+    {
+        try
+        {
+            if (config_.sessionMode)
+            {
+                sendSessionFrame();
+            }
+            else
+            {
+                sendLegacyFrame();
+            }
+        }
+        catch (const std::exception &)
+        {
+            stats_.ioErrors++;
+            inFlight_.clear();
+            socket_.reset();
+        }
+    }
+
+    bool connect()
+    {
+        try
+        {
+            tcp::resolver resolver(io_context_);
+            auto endpoints = resolver.resolve(config_.host, std::to_string(config_.port));
+            socket_ = std::make_unique<tcp::socket>(io_context_);
+            boost::asio::connect(*socket_, endpoints);
+            socket_->set_option(tcp::no_delay(true));
+            setReceiveTimeout(*socket_, 5);
+            stats_.connects++;
+            return true;
+        }
+        catch (const std::exception &)
+        {
+            stats_.connectErrors++;
+            socket_.reset();
+            // 서버가 연결을 받지 못하는 동안 바쁜 재시도 방지
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            return false;
+        }
+    }
+
+    void sendLegacyFrame()
+    {
+        if (!connect())
+        {
+            return;
+        }
+
+        uint32_t size = htonl(static_cast<uint32_t>(payload_.size()));
+        std::array<boost::asio::const_buffer, 2> buffers = {
+            boost::asio::buffer(&size, sizeof(size)), boost::asio::buffer(payload_)};
+        boost::asio::write(*socket_, buffers);
+        stats_.framesSent++;
+        stats_.bytesSent += payload_.size();
+        uint64_t sentNs = metricsNowNs();
+
+        char response[32] = {};
+        size_t expected = std::strlen(FRAME_LEGACY_ACK);
+        boost::asio::read(*socket_, boost::asio::buffer(response, expected));
+        if (std::string(response, expected) != FRAME_LEGACY_ACK)
+        {
+            stats_.protocolErrors++;
+        }
+        else
+        {
+            stats_.ackLatency.record(metricsNowNs() - sentNs);
+            stats_.framesAcked++;
+            stats_.status[static_cast<int>(AckStatus::Ok)]++;
+        }
+        socket_.reset();
+    }
+
+    void sendSessionFrame()
+    {
+        // 연결 재사용 한도에 도달하면 남은 ACK 를 받고 재연결
+        if (socket_ && config_.framesPerConnection > 0 && framesOnConnection_ >= config_.framesPerConnection)
+        {
+            drain();
+        }
+
+        if (!socket_)
+        {
+            if (!connect())
+            {
+                return;
+            }
+            uint32_t magic = htonl(FRAME_SESSION_MAGIC);
+            boost::asio::write(*socket_, boost::asio::buffer(&magic, sizeof(magic)));
+            framesOnConnection_ = 0;
+            credits_ = config_.window;
+        }
+
+        receiveAcks(false);
+        while (!inFlight_.empty() && (inFlight_.size() >= config_.window || credits_ == 0))
+        {
+            receiveAcks(true);
+        }
+
+        FrameType type = config_.results ? FrameType::Results : FrameType::Jpeg;
+        uint16_t flags = config_.rawFrames ? FRAME_FLAG_RAW : 0;
+        FrameHeader header{static_cast<uint32_t>(payload_.size()), nextSeq_++, static_cast<uint16_t>(type), flags};
+        unsigned char headerBuffer[FRAME_HEADER_SIZE];
+        encodeFrameHeader(header, headerBuffer);
+        std::array<boost::asio::const_buffer, 2> buffers = {
+            boost::asio::buffer(headerBuffer, sizeof(headerBuffer)), boost::asio::buffer(payload_)};
+        boost::asio::write(*socket_, buffers);
+
+        inFlight_[header.seq] = metricsNowNs();
+        stats_.framesSent++;
+        stats_.bytesSent += payload_.size();
+        ++framesOnConnection_;
+        if (credits_ > 0)
+        {
+            --credits_;
+        }
+    }
+
+    void receiveAcks(bool blocking)
+    {
+        unsigned char buffer[ACK_MESSAGE_SIZE];
+        while (socket_ && (blocking || socket_->available() >= ACK_MESSAGE_SIZE))
+        {
+            boost::asio::read(*socket_, boost::asio::buffer(buffer, sizeof(buffer)));
+            blocking = false;
+
+            AckMessage ack = decodeAck(buffer);
+            if (ack.magic != FRAME_ACK_MAGIC || ack.status >= 7)
+            {
+                stats_.protocolErrors++;
+                throw std::runtime_error("Invalid ACK");
+            }
+
+            credits_ = ack.credits;
+            if (ack.status == static_cast<uint16_t>(AckStatus::Credit))
+            {
+                continue;
+            }
+
+            stats_.status[ack.status]++;
+            auto it = inFlight_.find(ack.seq);
+            if (it != inFlight_.end())
+            {
+                stats_.ackLatency.record(metricsNowNs() - it->second);
+                stats_.framesAcked++;
+                inFlight_.erase(it);
+            }
+            if (ack.status == static_cast<uint16_t>(AckStatus::TooLarge))
+            {
+                throw std::runtime_error("Frame too large");
+            }
+        }
+    }
+
+    // 세션의 미확인 프레임 ACK 를 모두 받고 연결 종료
+    void drain()
+    {
+        try
+        {
+            while (socket_ && !inFlight_.empty())
+            {
+                receiveAcks(true);
+            }
+        }
+        catch (const std::exception &)
+        {
+            stats_.ioErrors++;
+        }
+        inFlight_.clear();
+        socket_.reset();
+    }
+
+    const LoadConfig &config_;
+    const std::vector<uchar> &payload_;
+    LoadStats &stats_;
+    std::chrono::steady_clock::time_point deadline_;
+
+    boost::asio::io_context io_context_;
+    std::unique_ptr<tcp::socket> socket_;
+    std::map<uint32_t, uint64_t> inFlight_; // seq -> 전송 시각(ns)
+    uint32_t nextSeq_ = 0;
+    uint32_t credits_ = 0;
+    int framesOnConnection_ = 0;
+};
+
+static void printReport(const LoadConfig &config, const LoadStats &stats, double elapsedSec, size_t payloadSize)
+{
+    Histogram::Snapshot latency = stats.ackLatency.snapshot();
+    uint64_t sent = stats.framesSent.load();
+    uint64_t acked = stats.framesAcked.load();
+    uint64_t ok = stats.status[static_cast<int>(AckStatus::Ok)].load();
+    auto ms = [](uint64_t ns)
+    { return static_cast<double>(ns) / 1e6; };
+    auto pct = [sent](uint64_t n)
+    { return sent ? 100.0 * static_cast<double>(n) / static_cast<double>(sent) : 0.0; };
+
+    std::cout << "===== mac_server load report =====" << std::endl;
+    std::cout << "mode            : " << (config.sessionMode ? "session" : "legacy")
+              << (config.sessionMode ? " (window " + std::to_string(config.window) + ")" : "")
+              << (config.results ? ", results-only records" : config.rawFrames ? ", raw frames (server processing)" : ", JPEG frames")
+              << std::endl;
+    std::cout << "clients         : " << config.clients << ", duration " << elapsedSec << " s, payload " << payloadSize << " bytes" << std::endl;
+    std::cout << "connections     : " << stats.connects.load() << " (connect errors " << stats.connectErrors.load() << ")" << std::endl;
+    std::cout << "frames sent     : " << sent << std::endl;
+    std::cout << "frames acked    : " << acked << " (ok " << ok << ")" << std::endl;
+    std::cout << "throughput      : " << ok / elapsedSec << " frames/s, "
+              << static_cast<double>(ok) * payloadSize / elapsedSec / (1024.0 * 1024.0) << " MiB/s (server-confirmed)" << std::endl;
+    std::cout << "ack latency ms  : p50 " << ms(latency.quantile(0.5)) << ", p90 " << ms(latency.quantile(0.9))
+              << ", p99 " << ms(latency.quantile(0.99)) << ", p99.9 " << ms(latency.quantile(0.999))
+              << ", max " << ms(latency.max) << std::endl;
+    std::cout << "errors          : decode " << pct(stats.status[static_cast<int>(AckStatus::DecodeError)].load()) << "%"
+              << ", rejected " << pct(stats.status[static_cast<int>(AckStatus::Rejected)].load()) << "%"
+              << ", dropped " << pct(stats.status[static_cast<int>(AckStatus::Dropped)].load()) << "%"
+              << ", too-large " << pct(stats.status[static_cast<int>(AckStatus::TooLarge)].load()) << "%"
+              << ", unacked " << pct(sent - acked) << "%"
+              << ", io " << stats.ioErrors.load() << ", protocol " << stats.protocolErrors.load() << std::endl;
+}
+
+static void printUsage(const char *program)
+{
+    std::cerr << "Usage: " << program << " [--host HOST] [--port PORT] [--clients N] [--duration SEC]"
+              << " [--mode session|legacy] [--window N] [--frames-per-connection N]"
+              << " [--rate FPS] [--burst N] [--burst-interval MS]"
+              << " [--jpeg FILE | --width W --height H | --raw-bytes N | --payload jpeg|results|raw]" << std::endl;
+}
+
+int main(int argc, char *argv[])
+{
+    LoadConfig config;
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        if (i + 1 >= argc)
+        {
+            printUsage(argv[0]);
+            return 1;
+        }
+        std::string value = argv[++i];
+
+        if (arg == "--host")
+            config.host = value;
+        else if (arg == "--port")
+            config.port = static_cast<unsigned short>(std::stoi(value));
+        else if (arg == "--clients")
+            config.clients = std::max(1, std::stoi(value));
+        else if (arg == "--duration")
+            config.durationSec = std::max(1, std::stoi(value));
+        else if (arg == "--mode" && (value == "session" || value == "legacy"))
+            config.sessionMode = value == "session";
+        else if (arg == "--window")
+            config.window = std::max(1, std::stoi(value));
+        else if (arg == "--frames-per-connection")
+            config.framesPerConnection = std::stoi(value);
+        else if (arg == "--rate")
+            config.rate = std::stod(value);
+        else if (arg == "--burst")
+            config.burst = std::stoi(value);
+        else if (arg == "--burst-interval")
+            config.burstIntervalMs = std::stoi(value);
+        else if (arg == "--jpeg")
+            config.jpegPath = value;
+        else if (arg == "--width")
+            config.width = std::stoi(value);
+        else if (arg == "--height")
+            config.height = std::stoi(value);
+        else if (arg == "--raw-bytes")
+            config.rawBytes = std::stoull(value);
+        else if (arg == "--payload" && (value == "jpeg" || value == "results" || value == "raw"))
+        {
+            config.results = value == "results";
+            config.rawFrames = value == "raw";
+        }
+        else
+        {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    if ((config.results || config.rawFrames) && !config.sessionMode)
+    {
+        std::cerr << "--payload " << (config.results ? "results" : "raw") << " requires --mode session" << std::endl;
+        return 1;
+    }
+
+    try
+    {
+        std::vector<uchar> payload = buildPayload(config);
+        LoadStats stats;
+
+        auto start = std::chrono::steady_clock::now();
+        auto deadline = start + std::chrono::seconds(config.durationSec);
+
+        std::vector<std::thread> threads;
+        for (int i = 0; i < config.clients; ++i)
+        {
+            threads.emplace_back([&config, &payload, &stats, deadline]()
+                                 { LoadClient(config, payload, stats, deadline).run(); });
+        }
+        for (auto &thread : threads)
+        {
+            thread.join();
+        }
+
+        double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        printReport(config, stats, elapsed, payload.size());
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
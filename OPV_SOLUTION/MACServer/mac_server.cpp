@@ -5,22 +5,214 @@
 #include <memory>
 #include <fstream>
 #include <cstdlib>
+#include <cstring>
+#include <array>
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include <algorithm>
+#include <csignal>
+#include "frame_protocol.h"
+#include "admission_control.h"
+#include "metrics.h"
+#include "metrics_http.h"
+#include "decoded_frame.h"
+#include "frame_results.h"
+#include "scan_store.h"
+#include "content_cache.h"
+#include "qr_detect.h"
+#include "image_ops.h"
+#include "trace.h"
+#include <functional>
 
 using boost::asio::ip::tcp;
 
+// 서버 단계별 계측 지점 (시작 시 한 번 등록하고 참조만 보관)
+struct ServerMetrics
+{
+    ServerMetrics()
+        : connectionsAccepted(registry().counter("mac_server_connections_accepted_total", "Accepted client connections")),
+          framesReceived(registry().counter("mac_server_frames_received_total", "Frames fully received")),
+          bytesReceived(registry().counter("mac_server_bytes_received_total", "Frame payload bytes received")),
+          framesRejected(registry().counter("mac_server_frames_rejected_total", "Frames rejected by admission control")),
+          framesDropped(registry().counter("mac_server_frames_dropped_total", "Queued frames dropped by drop-oldest policy")),
+          decodeErrors(registry().counter("mac_server_decode_errors_total", "Frames that failed to decode")),
+          resultsReceived(registry().counter("mac_server_results_received_total", "Results-only uplink records received")),
+          keyframesRequested(registry().counter("mac_server_keyframes_requested_total", "Keyframes requested from results-only clients")),
+          keyframesThrottled(registry().counter("mac_server_keyframes_throttled_total", "Keyframe requests withheld by the per-client crop interval")),
+          qrCropsReceived(registry().counter("mac_server_qr_crops_received_total", "Full-resolution crops of undecoded QR codes received")),
+          qrCacheHits(registry().counter("mac_server_qr_cache_hits_total", "Frames whose QR results came from the content-hash cache")),
+          qrCacheMisses(registry().counter("mac_server_qr_cache_misses_total", "Frames decoded and scanned for QR codes")),
+          qrCodes(registry().counter("mac_server_qr_codes_total", "QR codes found in received frames (including cached)")),
+          rawFrames(registry().counter("mac_server_raw_frames_total", "Raw frames processed on the server for offloading clients")),
+          accept(stage("accept")),
+          receive(stage("receive")),
+          queue(stage("queue")),
+          decode{&decodeStage("full"), &decodeStage("half"), &decodeStage("quarter"), &decodeStage("eighth")},
+          persist(stage("persist")),
+          qrHash(stage("qr_hash")),
+          qr(stage("qr")),
+          process(stage("process")),
+          ack(stage("ack")) {}
+
+    Counter &connectionsAccepted;
+    Counter &framesReceived;
+    Counter &bytesReceived;
+    Counter &framesRejected;
+    Counter &framesDropped;
+    Counter &decodeErrors;
+    Counter &resultsReceived;
+    Counter &keyframesRequested;
+    Counter &keyframesThrottled;
+    Counter &qrCropsReceived;
+    Counter &qrCacheHits;
+    Counter &qrCacheMisses;
+    Counter &qrCodes;
+    Counter &rawFrames;
+
+    Histogram &accept;  // 연결 수락 후 세션 시작까지
+    Histogram &receive; // 프레임 헤더 수신부터 페이로드 수신 완료까지
+    Histogram &queue;   // 연결 대기 큐에서 작업 스레드 투입까지
+    DecodeTimers decode; // 해상도별 imdecode
+    Histogram &persist; // imwrite
+    Histogram &qrHash;  // 수신 JPEG 바이트 내용 해시 + 캐시 조회
+    Histogram &qr;      // 캐시 미스 프레임의 QR 검출/디코딩 (이미지 디코딩 제외)
+    Histogram &process; // 원본 프레임(FRAME_FLAG_RAW)의 image_ops 처리 (Edge 대신 수행)
+    Histogram &ack;     // ACK 송신 큐 적재부터 전송 완료까지
+
+private:
+    static MetricsRegistry &registry() { return MetricsRegistry::instance(); }
+    static Histogram &stage(const std::string &name)
+    {
+        return registry().histogram("mac_server_stage_latency_seconds", "stage=\"" + name + "\"", "Per-stage latency of the MAC server pipeline");
+    }
+    static Histogram &decodeStage(const std::string &scale)
+    {
+        return registry().histogram("mac_server_stage_latency_seconds", "stage=\"decode\",scale=\"" + scale + "\"", "Per-stage latency of the MAC server pipeline");
+    }
+};
+
+// 디코딩된 프레임 소비자
+// 각 소비자는 필요한 해상도를 선언하고, 프레임은 요청된 해상도로만 (한 번씩) 디코딩됨
+struct FrameConsumer
+{
+    std::string name;
+    DecodeScale scale;
+    std::function<void(const cv::Mat &image, const FrameHeader &header)> consume;
+};
+
+// 서버 QR 분석 단계 설정
+struct QrAnalysisConfig
+{
+    DecodeScale scale = DecodeScale::Full; // QR 검출에 쓸 디코딩 해상도
+    size_t cacheEntries = 1024;            // 내용 해시 결과 캐시 크기 (0 이면 캐시 안 함)
+    int cropIntervalMs = 1000;             // 클라이언트마다 QR crop 요청(Keyframe ACK) 최소 간격 (0 이면 제한 없음)
+};
+
+// 결과 전용 업링크 레코드(FrameType::Results) 소비자
+struct ResultsConsumer
+{
+    std::string name;
+    std::function<void(const FrameResults &results, const FrameHeader &header)> consume;
+};
+
 class Server
 {
 public:
     // Server 객체가 생성되면서 io_context_ 객체도 생성
     // tcp::endpoint(tcp::v4(), port) : TCP 프로토콜을 사용하여 IPv4 주소의 port번호에 바인딩하는 endpoint를 생성
-    explicit Server(unsigned short port) : acceptor_(io_context_, tcp::endpoint(tcp::v4(), port)) {}
+    // admission : 프레임 크기/메모리 예산/credit 관련 입장 제어 설정
+    // persistScale : 수신 이미지를 파일로 저장할 해상도
+    // workerThreads : 이미지 디코딩/저장을 수행할 작업 스레드 수
+    explicit Server(unsigned short port, const AdmissionConfig &admission = AdmissionConfig(),
+                    DecodeScale persistScale = DecodeScale::Full,
+                    size_t workerThreads = std::max(1u, std::thread::hardware_concurrency()))
+        : acceptor_(io_context_, tcp::endpoint(tcp::v4(), port)), signals_(io_context_, SIGINT, SIGTERM), workers_(workerThreads),
+          admission_(admission), globalBudget_(admission.globalBudget)
+    {
+        addConsumer(FrameConsumer{"persist", persistScale, [this](const cv::Mat &image, const FrameHeader &)
+                                  { persistImage(image); }});
+
+// GUI 환경에서만 이미지 표시 (미리보기이므로 1/4 해상도면 충분)
+// HighGUI 는 스레드 안전하지 않으므로 작업 스레드는 최신 프레임만 넘기고 표시는 전용 스레드 하나에서만 함
+#ifdef SHOW_GUI
+        previewThread_ = std::thread(&Server::runPreview, this);
+        addConsumer(FrameConsumer{"preview", DecodeScale::Quarter, [this](const cv::Mat &image, const FrameHeader &)
+                                  {
+                                      {
+                                          std::lock_guard<std::mutex> lock(previewMutex_);
+                                          previewFrame_ = image; // 표시 전에 새 프레임이 오면 이전 것은 건너뜀
+                                      }
+                                      previewCv_.notify_one();
+                                  }});
+#endif
+    }
 
+    ~Server()
+    {
+        workers_.join();
+#ifdef SHOW_GUI
+        {
+            std::lock_guard<std::mutex> lock(previewMutex_);
+            previewStopping_ = true;
+        }
+        previewCv_.notify_one();
+        previewThread_.join();
+#endif
+    }
+
+    // SIGINT / SIGTERM 을 받으면 io_context 를 멈추고 돌아옴. 호출한 쪽이 Server 를 소멸시키면 작업 스레드가 끝날 때까지 기다림
     void start()
     {
+        signals_.async_wait([this](const boost::system::error_code &ec, int signo)
+                            {
+                                if (!ec)
+                                {
+                                    std::cout << "Received signal " << signo << ", shutting down" << std::endl;
+                                    io_context_.stop();
+                                }
+                            });
         acceptConnection();
         io_context_.run();
     }
 
+    // 디코딩된 프레임 소비자 등록. start() 이전에 호출해야 함
+    void addConsumer(FrameConsumer consumer)
+    {
+        consumers_.push_back(std::move(consumer));
+    }
+
+    // 수신 JPEG 프레임의 QR 검출 활성화. 결과는 결과 레코드 소비자에게 전달됨. start() 이전에 호출해야 함
+    void enableQrAnalysis(const QrAnalysisConfig &config)
+    {
+        qrConfig_ = config;
+        qrCache_ = std::make_unique<ContentCache<QrCacheEntry>>(config.cacheEntries);
+    }
+
+    // 원본 프레임(FRAME_FLAG_RAW)을 처리해 소비자에게 넘길 합성 이미지 배치. start() 이전에 호출해야 함
+    void setCompositeLayout(const CompositeLayout &layout)
+    {
+        compositeLayout_ = layout;
+    }
+
+    // 원본 프레임 분석 해상도 (pyrDown 횟수, 0 = 원본). 직선 / 윤곽선은 원본 좌표로 돌려받음. start() 이전에 호출해야 함
+    void setAnalysisLevels(int levels)
+    {
+        analysisLevels_ = std::min(std::max(levels, 0), ANALYSIS_MAX_LEVELS);
+    }
+
+    // 결과 레코드 소비자 등록. start() 이전에 호출해야 함
+    void addResultsConsumer(ResultsConsumer consumer)
+    {
+        resultsConsumers_.push_back(std::move(consumer));
+    }
+
+    // 127.0.0.1:port 에서 Prometheus 텍스트 포맷 메트릭 제공
+    void enableMetricsEndpoint(unsigned short port)
+    {
+        metricsEndpoint_ = std::make_unique<MetricsHttpEndpoint>(io_context_, port);
+    }
+
     void printHexDump(const std::string &filePath)
     {
         std::string command = "hexdump -C " + filePath;
@@ -33,6 +225,8 @@ public:
     }
 
 private:
+    class Session;
+
     void acceptConnection()
     {
         auto socket = std::make_shared<tcp::socket>(io_context_);
@@ -41,6 +235,11 @@ private:
                                {
                                    if (!ec)
                                    {
+                                       ScopedTimer timer(metrics_.accept);
+                                       metrics_.connectionsAccepted.add();
+                                       // 작은 ACK 메시지가 Nagle 알고리즘에 의해 지연되지 않도록 설정
+                                       boost::system::error_code ignored;
+                                       socket->set_option(tcp::no_delay(true), ignored);
                                        std::cout << "Client connected: " << socket->remote_endpoint() << std::endl;
                                        receiveData(socket);
                                    }
@@ -48,103 +247,340 @@ private:
                                });
     }
 
-    void receiveData(const std::shared_ptr<tcp::socket> &socket)
+    // 연결 하나를 세션으로 만들어 프레임을 반복 수신
+    void receiveData(const std::shared_ptr<tcp::socket> &socket);
+
+    void saveDebugData(const std::string &data)
+    {
+        std::string debugFilePath = "./debug/debug_image_data.raw";
+        std::ofstream debugFile(debugFilePath, std::ios::binary);
+        if (debugFile)
+        {
+            debugFile.write(data.data(), data.size());
+            std::cout << "Raw image data saved to " << debugFilePath << std::endl;
+        }
+        else
+        {
+            std::cerr << "Failed to save debug data to " << debugFilePath << std::endl;
+        }
+    }
+
+    // 프레임 종류에 따라 처리하고 ACK 상태를 반환 (작업 스레드에서 호출됨)
+    AckStatus processFrame(const std::vector<char> &data, const FrameHeader &header)
+    {
+        switch (static_cast<FrameType>(header.type))
+        {
+        case FrameType::Jpeg:
+            return processImage(data, header) ? AckStatus::Ok : AckStatus::DecodeError;
+        case FrameType::Results:
+            return processResults(data, header);
+        case FrameType::QrCrop:
+            return processQrCrop(data, header);
+        default:
+            metrics_.decodeErrors.add();
+            std::cerr << "Unknown frame type " << header.type << " (seq " << header.seq << ")" << std::endl;
+            return AckStatus::DecodeError;
+        }
+    }
+
+    // 결과 레코드를 복원해 소비자에게 전달. 디코딩하지 못한 QR 이 있고 QR 분석이 켜져 있으면 crop 요청
+    // (요청 간격 제한은 연결별로 Session 이 ACK 를 보낼 때 적용)
+    AckStatus processResults(const std::vector<char> &data, const FrameHeader &header)
+    {
+        FrameResults results;
+        if (!decodeFrameResults(reinterpret_cast<const unsigned char *>(data.data()), data.size(), results))
+        {
+            metrics_.decodeErrors.add();
+            std::cerr << "Failed to decode results record (seq " << header.seq << ")" << std::endl;
+            return AckStatus::DecodeError;
+        }
+        metrics_.resultsReceived.add();
+
+        for (const auto &consumer : resultsConsumers_)
+        {
+            consumer.consume(results, header);
+        }
+
+        bool undecoded = std::any_of(results.qrCodes.begin(), results.qrCodes.end(), [](const QrResult &code)
+                                     { return code.text.empty(); });
+        return undecoded && qrCache_ ? AckStatus::Keyframe : AckStatus::Ok;
+    }
+
+    // 디코딩 못 한 QR 주변을 원본 해상도로 자른 JPEG. crop 에서 QR 을 다시 찾아 원본 좌표로 옮긴 뒤 결과 소비자에게 전달
+    AckStatus processQrCrop(const std::vector<char> &data, const FrameHeader &header)
+    {
+        if (data.size() <= QR_CROP_HEADER_SIZE)
+        {
+            metrics_.decodeErrors.add();
+            std::cerr << "QR crop too short (seq " << header.seq << ")" << std::endl;
+            return AckStatus::DecodeError;
+        }
+        metrics_.qrCropsReceived.add();
+        QrCropHeader crop = decodeQrCropHeader(reinterpret_cast<const unsigned char *>(data.data()));
+        std::vector<char> jpeg(data.begin() + QR_CROP_HEADER_SIZE, data.end());
+        DecodedFrame frame(jpeg, &metrics_.decode);
+        if (!qrCache_)
+        {
+            return frame.at(DecodeScale::Eighth).empty() ? AckStatus::DecodeError : AckStatus::Ok;
+        }
+
+        FrameResults results;
+        bool decoded;
+        {
+            TRACE_SCOPE("qr_decode");
+            decoded = analyzeQr(frame, results, DecodeScale::Full); // 작게 찍힌 코드라서 보낸 것이므로 축소하지 않음
+        }
+        if (!decoded)
+        {
+            metrics_.decodeErrors.add();
+            std::cerr << "Failed to decode QR crop (seq " << header.seq << ")" << std::endl;
+            return AckStatus::DecodeError;
+        }
+        results.width = crop.frameWidth;
+        results.height = crop.frameHeight;
+        for (auto &code : results.qrCodes)
+        {
+            for (size_t k = 0; k < 4; ++k)
+            {
+                code.corners[2 * k] += crop.x;
+                code.corners[2 * k + 1] += crop.y;
+            }
+        }
+        for (const auto &consumer : resultsConsumers_)
+        {
+            consumer.consume(results, header);
+        }
+        return AckStatus::Ok;
+    }
+
+    // 수신된 프레임을 각 소비자가 요청한 해상도로 디코딩해 전달. 디코딩 성공 여부를 반환 (작업 스레드에서 호출됨)
+    // 원본 프레임(FRAME_FLAG_RAW)이면 Edge 가 하던 처리를 여기서 하고, 소비자에게는 처리된 합성 이미지를 넘김
+    bool processImage(const std::vector<char> &data, const FrameHeader &header)
     {
         try
         {
-            uint32_t data_size_network_order = 0;
-            // 비동기적으로 소켓에서 데이터를 읽어옴(데이터의 크기를 네트워크 바이트 오더로 수신 후 이를 변환)
-            boost::asio::read(*socket, boost::asio::buffer(&data_size_network_order, sizeof(data_size_network_order)));
-            
-            // ntohl: 네트워크 바이트 오더에서 호스트 바이트 오더로 변환 (빅 엔디언)
-            uint32_t data_size = ntohl(data_size_network_order);
+            DecodedFrame frame(data, &metrics_.decode);
+            bool raw = (header.flags & FRAME_FLAG_RAW) != 0;
 
-            std::cout << "Expected data size: " << data_size << " bytes" << std::endl;
+            FrameResults results;
+            cv::Mat processed;
+            bool decoded = true;
+            if (raw)
+            {
+                metrics_.rawFrames.add();
+                cv::Mat image = frame.at(DecodeScale::Full);
+                decoded = !image.empty();
+                if (decoded)
+                {
+                    ScopedTimer timer(metrics_.process);
+                    TRACE_SCOPE("process");
+                    cv::Mat enhanced, edges;
+                    std::vector<cv::Vec2f> lines;
+                    std::vector<std::vector<cv::Point>> contours;
+                    analyze_image(image, enhanced, edges, lines, contours, analysisLevels_);
+                    // 캔버스는 작업 스레드마다 하나. processed 는 이 함수 안에서만 쓰므로 다음 프레임이 덮어써도 됨
+                    thread_local CompositeCanvas canvas;
+                    canvas.setLayout(compositeLayout_);
+                    processed = drawAnalysis(image, enhanced, edges, lines, contours, &canvas);
+                    results.width = static_cast<uint16_t>(std::min(image.cols, 65535));
+                    results.height = static_cast<uint16_t>(std::min(image.rows, 65535));
+                    collectFrameResults(lines, contours, results);
+                    decoded = !processed.empty();
+                }
+            }
+            else if (consumers_.empty())
+            {
+                // 소비자가 없어도 ACK 상태를 위해 가장 저렴한 해상도로 유효성 확인
+                decoded = !frame.at(DecodeScale::Eighth).empty();
+            }
+            else
+            {
+                // 소비자 중 가장 큰 해상도를 먼저 디코딩해 두면 나머지는 그 이미지를 축소해서 씀
+                // (등록 순서가 작은 해상도부터여도 디코딩은 한 번)
+                decoded = !frame.at(finestConsumerScale()).empty();
+            }
 
-            if (data_size == 0)
+            std::array<cv::Mat, DECODE_SCALE_COUNT> scaled; // 원본 프레임일 때 해상도별 합성 이미지
+            for (const auto &consumer : consumers_)
             {
-                std::cerr << "Error: Received data size is zero. Client may not have sent data." << std::endl;
-                return;
+                if (!decoded)
+                {
+                    break;
+                }
+                cv::Mat image;
+                if (raw)
+                {
+                    cv::Mat &target = scaled[static_cast<size_t>(consumer.scale)];
+                    int divisor = decodeScaleDivisor(consumer.scale);
+                    if (target.empty() && divisor == 1)
+                    {
+                        target = processed;
+                    }
+                    else if (target.empty())
+                    {
+                        cv::resize(processed, target,
+                                   cv::Size((processed.cols + divisor - 1) / divisor, (processed.rows + divisor - 1) / divisor),
+                                   0, 0, cv::INTER_AREA);
+                    }
+                    image = target;
+                }
+                else
+                {
+                    image = frame.at(consumer.scale);
+                }
+                if (image.empty())
+                {
+                    decoded = false;
+                    break;
+                }
+                consumer.consume(image, header);
             }
 
-            std::vector<char> image_buffer(data_size);
-            size_t total_read = 0;
-            while (total_read < data_size)
+            if (decoded && qrCache_)
             {
-                size_t bytes_read = boost::asio::read(*socket, boost::asio::buffer(image_buffer.data() + total_read, data_size - total_read));
-                total_read += bytes_read;
-                std::cout << "Read " << bytes_read << " bytes, total: " << total_read << "/" << data_size << " bytes" << std::endl;
+                TRACE_SCOPE("qr_decode");
+                decoded = analyzeQr(frame, results, qrConfig_.scale);
             }
 
-            std::cout << "Received " << total_read << " bytes of image data." << std::endl;
+            if (!decoded)
+            {
+                metrics_.decodeErrors.add();
+                std::cerr << "Failed to decode the image." << std::endl;
+                saveDebugData(std::string(data.begin(), data.end()));
+                return false;
+            }
 
-            processImage(std::string(image_buffer.begin(), image_buffer.end()));
-            sendResponse(socket, "Acknowledged");
+            // 원본 프레임은 Edge 처리 때의 결과 레코드와 같은 내용을, 아니면 QR 이 있을 때만 전달
+            if (raw || !results.qrCodes.empty())
+            {
+                for (const auto &consumer : resultsConsumers_)
+                {
+                    consumer.consume(results, header);
+                }
+            }
+            return true;
         }
         catch (const std::exception &e)
         {
-            std::cerr << "Error in receiveData: " << e.what() << std::endl;
+            std::cerr << "Error in processImage: " << e.what() << std::endl;
+            return false;
         }
     }
 
-    void sendResponse(const std::shared_ptr<tcp::socket> &socket, const std::string &message)
+    struct QrCacheEntry
     {
-        // 비동기적으로 소켓에 데이터를 전송
-        boost::asio::async_write(*socket, boost::asio::buffer(message), [socket](const boost::system::error_code &ec, std::size_t)
-                                 {
-            if (!ec) {
-                std::cout << "Response sent." << std::endl;
-            } });
-    }
+        uint16_t width;
+        uint16_t height;
+        std::vector<QrResult> codes;
+    };
 
-    void saveDebugData(const std::string &data)
+    // 수신 바이트 해시로 캐시를 먼저 찾고, 없을 때만 이미지를 디코딩해 QR 검출. 디코딩 실패 시 false
+    // 찾은 코드와 프레임 크기를 results 에 채움
+    bool analyzeQr(DecodedFrame &frame, FrameResults &results, DecodeScale scale)
     {
-        std::string debugFilePath = "./debug/debug_image_data.raw";
-        std::ofstream debugFile(debugFilePath, std::ios::binary);
-        if (debugFile)
+        const std::vector<char> &encoded = frame.encoded();
+        QrCacheEntry entry;
+        bool hit;
+        uint64_t hash;
         {
-            debugFile.write(data.data(), data.size());
-            std::cout << "Raw image data saved to " << debugFilePath << std::endl;
+            ScopedTimer timer(metrics_.qrHash);
+            hash = contentHash(encoded.data(), encoded.size());
+            hit = qrCache_->lookup(hash, encoded.size(), entry);
+        }
+
+        if (hit)
+        {
+            metrics_.qrCacheHits.add();
         }
         else
         {
-            std::cerr << "Failed to save debug data to " << debugFilePath << std::endl;
+            metrics_.qrCacheMisses.add();
+            cv::Mat image = frame.at(scale);
+            if (image.empty())
+            {
+                return false;
+            }
+
+            std::vector<QrDetection> detections;
+            {
+                ScopedTimer timer(metrics_.qr);
+                std::unique_ptr<QrDetectStage> stage = acquireQrStage();
+                detections = stage->detect(image);
+                releaseQrStage(std::move(stage));
+            }
+
+            // 축소 디코딩한 경우 원본 좌표로 환산
+            float divisor = static_cast<float>(decodeScaleDivisor(scale));
+            entry.width = static_cast<uint16_t>(std::min(image.cols * decodeScaleDivisor(scale), 65535));
+            entry.height = static_cast<uint16_t>(std::min(image.rows * decodeScaleDivisor(scale), 65535));
+            for (const auto &detection : detections)
+            {
+                QrResult code;
+                code.text = detection.text;
+                for (size_t k = 0; k < 4; ++k)
+                {
+                    code.corners[2 * k] = detection.corners[k].x * divisor;
+                    code.corners[2 * k + 1] = detection.corners[k].y * divisor;
+                }
+                entry.codes.push_back(std::move(code));
+            }
+            qrCache_->insert(hash, encoded.size(), entry);
+        }
+
+        metrics_.qrCodes.add(entry.codes.size());
+        if (results.width == 0)
+        {
+            results.width = entry.width;
+            results.height = entry.height;
         }
+        results.qrCodes = std::move(entry.codes);
+        return true;
     }
 
-    void processImage(const std::string &data)
+    // 작업 스레드마다 따로 쓰는 검출기 (QrDetectStage 는 스레드 안전하지 않음). 프레임 사이 추적은 하지 않음
+    std::unique_ptr<QrDetectStage> acquireQrStage()
     {
-        try
         {
-            // 데이터를 JPEG 이미지로 디코딩
-            std::vector<uchar> imageBuffer(data.begin(), data.end());
-            cv::Mat receivedImage = cv::imdecode(imageBuffer, cv::IMREAD_COLOR);
-
-            if (receivedImage.empty())
+            std::lock_guard<std::mutex> lock(qrStagesMutex_);
+            if (!qrStages_.empty())
             {
-                std::cerr << "Failed to decode the image." << std::endl;
-                saveDebugData(data);
-                return;
+                std::unique_ptr<QrDetectStage> stage = std::move(qrStages_.back());
+                qrStages_.pop_back();
+                return stage;
             }
+        }
+        QrDetectConfig config;
+        config.track = false;
+        return std::make_unique<QrDetectStage>(config);
+    }
 
-            // 이미지를 파일로 저장
-            std::string outputFilename = "received_image.png";
-            cv::imwrite(outputFilename, receivedImage);
-            std::cout << "Image saved to " << outputFilename << std::endl;
+    void releaseQrStage(std::unique_ptr<QrDetectStage> stage)
+    {
+        std::lock_guard<std::mutex> lock(qrStagesMutex_);
+        qrStages_.push_back(std::move(stage));
+    }
 
-// GUI 환경에서만 이미지 표시
-#ifdef SHOW_GUI
-            cv::imshow("Received Image", receivedImage);
-            cv::waitKey(1);
-            std::cout << "Image displayed." << std::endl;
-#else
-            std::cout << "GUI display is disabled." << std::endl;
-#endif
+    DecodeScale finestConsumerScale() const
+    {
+        DecodeScale finest = DecodeScale::Eighth;
+        for (const auto &consumer : consumers_)
+        {
+            finest = std::min(finest, consumer.scale);
         }
-        catch (const std::exception &e)
+        return finest;
+    }
+
+    void persistImage(const cv::Mat &image)
+    {
+        // 이미지를 파일로 저장 (여러 작업 스레드가 같은 파일에 쓰지 않도록 보호)
+        std::string outputFilename = "received_image.png";
         {
-            std::cerr << "Error in processImage: " << e.what() << std::endl;
+            ScopedTimer timer(metrics_.persist);
+            std::lock_guard<std::mutex> lock(outputMutex_);
+            TRACE_SCOPE("imwrite");
+            cv::imwrite(outputFilename, image);
         }
+        std::cout << "Image saved to " << outputFilename << std::endl;
     }
 
     // io_context_: I/O 작업을 위한 컨텍스트 객체. Boost.Asio 라이브러리에서 비동기 I/O 작업을 수행하기 위한 핵심 객체
@@ -152,14 +588,638 @@ private:
     
     // 생성된 엔드포인트에서 들어오는 연결 요청을 수락하는 역할
     tcp::acceptor acceptor_;
+
+    // 정상 종료 신호 (Ctrl-C / kill). 받으면 start() 가 돌아옴
+    boost::asio::signal_set signals_;
+
+    // 디코딩/저장을 수행하는 작업 스레드 풀. 소켓 수신 루프가 처리 완료를 기다리지 않도록 분리
+    boost::asio::thread_pool workers_;
+
+    std::mutex outputMutex_;
+
+#ifdef SHOW_GUI
+    // 미리보기 표시 스레드 (imshow / waitKey 는 이 스레드에서만 호출)
+    void runPreview()
+    {
+        std::unique_lock<std::mutex> lock(previewMutex_);
+        while (true)
+        {
+            previewCv_.wait(lock, [this]
+                            { return previewStopping_ || !previewFrame_.empty(); });
+            if (previewStopping_)
+            {
+                return;
+            }
+            cv::Mat image = std::move(previewFrame_);
+            previewFrame_ = cv::Mat();
+            lock.unlock();
+            cv::imshow("Received Image", image);
+            cv::waitKey(1);
+            std::cout << "Image displayed." << std::endl;
+            lock.lock();
+        }
+    }
+
+    std::thread previewThread_;
+    std::mutex previewMutex_;
+    std::condition_variable previewCv_;
+    cv::Mat previewFrame_; // 아직 표시하지 않은 최신 프레임
+    bool previewStopping_ = false;
+#endif
+
+    // 수신 프레임 입장 제어
+    AdmissionConfig admission_;
+    MemoryBudget globalBudget_;
+
+    ServerMetrics metrics_;
+    std::unique_ptr<MetricsHttpEndpoint> metricsEndpoint_;
+
+    std::vector<FrameConsumer> consumers_;
+    std::vector<ResultsConsumer> resultsConsumers_;
+
+    CompositeLayout compositeLayout_;
+    int analysisLevels_ = 0;
+
+    QrAnalysisConfig qrConfig_;
+    std::unique_ptr<ContentCache<QrCacheEntry>> qrCache_; // 없으면 QR 분석 비활성화
+    std::mutex qrStagesMutex_;
+    std::vector<std::unique_ptr<QrDetectStage>> qrStages_;
 };
 
-int main()
+// 클라이언트 연결 하나에 대응하는 세션
+// 프레임을 연속으로 읽어 연결별 대기 큐에 넣고, 연결당 maxConcurrentFrames 개까지만 작업 스레드 풀에 넘김.
+// 따라서 한 클라이언트가 폭주해도 다른 클라이언트의 프레임이 작업 스레드를 나눠 쓸 수 있음.
+// 버퍼링된 프레임은 연결별/전체 메모리 예산으로 제한되며, 남은 수용량은 ACK 의 credits 로 클라이언트에 알림.
+// 모든 멤버는 io_context 스레드에서만 접근함.
+class Server::Session : public std::enable_shared_from_this<Server::Session>
+{
+public:
+    Session(Server &server, std::shared_ptr<tcp::socket> socket)
+        : server_(server), socket_(std::move(socket)) {}
+
+    void start()
+    {
+        readPrefix();
+    }
+
+private:
+    struct PendingFrame
+    {
+        FrameHeader header;
+        std::shared_ptr<std::vector<char>> payload;
+        uint64_t enqueuedNs; // 대기 큐 적재 시각 (queue 단계 계측)
+    };
+
+    struct OutgoingMessage
+    {
+        std::vector<unsigned char> bytes;
+        uint64_t enqueuedNs; // 송신 큐 적재 시각 (ack 단계 계측)
+    };
+
+    // 첫 4바이트: 세션 매직이면 세션 모드, 아니면 레거시 길이 프리픽스
+    void readPrefix()
+    {
+        auto self = shared_from_this();
+        boost::asio::async_read(*socket_, boost::asio::buffer(&prefix_, sizeof(prefix_)),
+                                [this, self](const boost::system::error_code &ec, std::size_t)
+                                {
+                                    if (ec)
+                                    {
+                                        closeWithError(ec);
+                                        return;
+                                    }
+
+                                    // ntohl: 네트워크 바이트 오더에서 호스트 바이트 오더로 변환 (빅 엔디언)
+                                    uint32_t value = ntohl(prefix_);
+                                    if (value == FRAME_SESSION_MAGIC)
+                                    {
+                                        sessionMode_ = true;
+                                        std::cout << "Session mode enabled for " << endpoint() << std::endl;
+                                        // 초기 credit 통지
+                                        sendAck(0, AckStatus::Credit);
+                                        readHeader();
+                                    }
+                                    else
+                                    {
+                                        readPayload(FrameHeader{value, legacySeq_++, static_cast<uint16_t>(FrameType::Jpeg), 0});
+                                    }
+                                });
+    }
+
+    void readHeader()
+    {
+        auto self = shared_from_this();
+        boost::asio::async_read(*socket_, boost::asio::buffer(headerBuffer_),
+                                [this, self](const boost::system::error_code &ec, std::size_t)
+                                {
+                                    if (ec)
+                                    {
+                                        closeWithError(ec);
+                                        return;
+                                    }
+                                    readPayload(decodeFrameHeader(headerBuffer_.data()));
+                                });
+    }
+
+    void readNext()
+    {
+        if (sessionMode_)
+        {
+            readHeader();
+        }
+        else
+        {
+            readPrefix();
+        }
+    }
+
+    void readPayload(const FrameHeader &header)
+    {
+        std::cout << "Expected data size: " << header.payloadSize << " bytes (seq " << header.seq << ")" << std::endl;
+
+        // 빈 프레임도 ACK 를 보내 클라이언트의 윈도우 슬롯을 돌려주고 다음 프레임을 계속 읽음
+        if (header.payloadSize == 0)
+        {
+            std::cerr << "Error: Received data size is zero. Client may not have sent data." << std::endl;
+            server_.metrics_.decodeErrors.add();
+            sendAck(header.seq, AckStatus::DecodeError);
+            readNext();
+            return;
+        }
+
+        // 길이 필드를 그대로 믿고 할당하지 않음. 최대 크기를 넘으면 연결을 끊음
+        if (header.payloadSize > server_.admission_.maxFrameSize)
+        {
+            std::cerr << "Error: Frame of " << header.payloadSize << " bytes exceeds limit of "
+                      << server_.admission_.maxFrameSize << " bytes. Closing " << endpoint() << std::endl;
+            if (!sessionMode_)
+            {
+                boost::system::error_code ignored;
+                socket_->close(ignored);
+                return;
+            }
+            sendAck(header.seq, AckStatus::TooLarge);
+            closeAfterWrite_ = true;
+            return;
+        }
+
+        if (!admit(header.payloadSize))
+        {
+            server_.metrics_.framesRejected.add();
+            std::cerr << "Rejecting frame seq " << header.seq << " from " << endpoint()
+                      << ": buffer budget exceeded" << std::endl;
+            if (!sessionMode_)
+            {
+                sendAck(header.seq, AckStatus::Rejected); // 레거시: 페이로드를 버릴 필요 없이 연결을 끊음
+                return;
+            }
+            discardPayload(header, header.payloadSize);
+            return;
+        }
+
+        auto self = shared_from_this();
+        auto payload = std::make_shared<std::vector<char>>(header.payloadSize);
+        uint64_t startNs = metricsNowNs();
+        boost::asio::async_read(*socket_, boost::asio::buffer(*payload),
+                                [this, self, payload, header, startNs](const boost::system::error_code &ec, std::size_t bytes_read)
+                                {
+                                    if (ec)
+                                    {
+                                        releaseBytes(payload->size());
+                                        closeWithError(ec);
+                                        return;
+                                    }
+                                    uint64_t nowNs = metricsNowNs();
+                                    server_.metrics_.receive.record(nowNs - startNs);
+                                    {
+                                        TRACE_FRAME(header.seq);
+                                        TRACE_COMPLETE("read", startNs, nowNs);
+                                    }
+                                    server_.metrics_.framesReceived.add();
+                                    server_.metrics_.bytesReceived.add(bytes_read);
+                                    std::cout << "Received " << bytes_read << " bytes of image data." << std::endl;
+
+                                    queue_.push_back(PendingFrame{header, payload, nowNs});
+                                    pump();
+
+                                    // 처리 완료를 기다리지 않고 다음 프레임 수신
+                                    readNext();
+                                });
+    }
+
+    // 연결/전체 예산과 프레임 수 한도 안에서 bytes 를 예약. 정책이 drop-oldest 이면 대기 중인 프레임을 버려 공간 확보
+    bool admit(size_t bytes)
+    {
+        const AdmissionConfig &config = server_.admission_;
+        while (true)
+        {
+            bool fitsConnection = bufferedBytes_ + bytes <= config.connectionBudget &&
+                                  queue_.size() + active_ < config.maxQueuedFrames;
+            if (fitsConnection && server_.globalBudget_.tryAcquire(bytes))
+            {
+                bufferedBytes_ += bytes;
+                return true;
+            }
+
+            if (config.policy != OverflowPolicy::DropOldest || queue_.empty())
+            {
+                return false;
+            }
+
+            PendingFrame oldest = std::move(queue_.front());
+            queue_.pop_front();
+            releaseBytes(oldest.payload->size());
+            server_.metrics_.framesDropped.add();
+            std::cerr << "Dropping queued frame seq " << oldest.header.seq << " from " << endpoint() << std::endl;
+            sendAck(oldest.header.seq, AckStatus::Dropped);
+        }
+    }
+
+    void releaseBytes(size_t bytes)
+    {
+        bufferedBytes_ -= bytes;
+        server_.globalBudget_.release(bytes);
+    }
+
+    // 예산 초과 프레임은 고정 크기 스크래치 버퍼로 읽어서 버림 (추가 메모리 할당 없음)
+    void discardPayload(const FrameHeader &header, size_t remaining)
+    {
+        if (remaining == 0)
+        {
+            sendAck(header.seq, AckStatus::Rejected);
+            readNext();
+            return;
+        }
+
+        auto self = shared_from_this();
+        size_t chunk = std::min(remaining, scratch_.size());
+        boost::asio::async_read(*socket_, boost::asio::buffer(scratch_.data(), chunk),
+                                [this, self, header, remaining](const boost::system::error_code &ec, std::size_t bytes_read)
+                                {
+                                    if (ec)
+                                    {
+                                        closeWithError(ec);
+                                        return;
+                                    }
+                                    discardPayload(header, remaining - bytes_read);
+                                });
+    }
+
+    // 대기 큐의 프레임을 연결당 동시 처리 한도까지 작업 스레드로 넘기고, 완료되면 io_context 에서 ACK 전송
+    void pump()
+    {
+        auto self = shared_from_this();
+        while (active_ < server_.admission_.maxConcurrentFrames && !queue_.empty())
+        {
+            PendingFrame frame = std::move(queue_.front());
+            queue_.pop_front();
+            ++active_;
+
+            boost::asio::post(server_.workers_, [this, self, frame]()
+                              {
+                                  uint64_t dequeuedNs = metricsNowNs();
+                                  server_.metrics_.queue.record(dequeuedNs - frame.enqueuedNs);
+                                  TRACE_FRAME(frame.header.seq);
+                                  TRACE_COMPLETE("queue", frame.enqueuedNs, dequeuedNs);
+                                  AckStatus status;
+                                  {
+                                      TRACE_SCOPE("frame");
+                                      status = server_.processFrame(*frame.payload, frame.header);
+                                  }
+                                  boost::asio::post(server_.io_context_, [this, self, frame, status]()
+                                                    {
+                                                        --active_;
+                                                        releaseBytes(frame.payload->size());
+                                                        sendAck(frame.header.seq, throttleKeyframe(status));
+                                                        pump();
+                                                    });
+                              });
+        }
+    }
+
+    // 디코딩 못 한 QR 이 계속 보이면 결과 레코드마다 Keyframe 이 나가므로, 연결마다 cropIntervalMs 에 한 번만 요청
+    AckStatus throttleKeyframe(AckStatus status)
+    {
+        if (status != AckStatus::Keyframe)
+        {
+            return status;
+        }
+        uint64_t nowNs = metricsNowNs();
+        uint64_t intervalNs = static_cast<uint64_t>(std::max(0, server_.qrConfig_.cropIntervalMs)) * 1000000ull;
+        if (lastKeyframeNs_ != 0 && nowNs - lastKeyframeNs_ < intervalNs)
+        {
+            server_.metrics_.keyframesThrottled.add();
+            return AckStatus::Ok;
+        }
+        lastKeyframeNs_ = nowNs;
+        server_.metrics_.keyframesRequested.add();
+        return status;
+    }
+
+    // 이 연결에서 추가로 수용 가능한 프레임 수
+    uint16_t credits() const
+    {
+        const AdmissionConfig &config = server_.admission_;
+        size_t inUse = queue_.size() + active_;
+        size_t frames = inUse < config.maxQueuedFrames ? config.maxQueuedFrames - inUse : 0;
+
+        // 전체 예산이 최대 프레임 하나도 받을 수 없을 만큼 찼으면 전송 중단 요청
+        if (server_.globalBudget_.used() + config.maxFrameSize > server_.globalBudget_.limit())
+        {
+            frames = 0;
+        }
+        return static_cast<uint16_t>(std::min<size_t>(frames, UINT16_MAX));
+    }
+
+    void sendAck(uint32_t seq, AckStatus status)
+    {
+        std::vector<unsigned char> message;
+        if (sessionMode_)
+        {
+            message.resize(ACK_MESSAGE_SIZE);
+            encodeAck(AckMessage{FRAME_ACK_MAGIC, seq, static_cast<uint16_t>(status), credits()}, message.data());
+        }
+        else if (status == AckStatus::Ok || status == AckStatus::DecodeError || status == AckStatus::Keyframe)
+        {
+            message.assign(FRAME_LEGACY_ACK, FRAME_LEGACY_ACK + std::strlen(FRAME_LEGACY_ACK));
+        }
+        else
+        {
+            // 레거시 클라이언트에는 거부/드롭을 알릴 수단이 없으므로 (TooLarge 와 같이) 연결을 끊어
+            // "Acknowledged" 를 계속 기다리지 않도록 함. 보낼 응답이 남아 있으면 다 보낸 뒤 끊음
+            std::cerr << "Closing legacy connection " << endpoint() << ": frame seq " << seq << " not accepted" << std::endl;
+            if (outbox_.empty())
+            {
+                boost::system::error_code ignored;
+                socket_->close(ignored);
+            }
+            else
+            {
+                closeAfterWrite_ = true;
+            }
+            return;
+        }
+
+        outbox_.push_back(OutgoingMessage{std::move(message), metricsNowNs()});
+        if (outbox_.size() == 1)
+        {
+            writeNext();
+        }
+    }
+
+    // 송신 큐의 메시지를 순서대로 하나씩 비동기 전송 (async_write 중첩 호출 방지)
+    void writeNext()
+    {
+        auto self = shared_from_this();
+        boost::asio::async_write(*socket_, boost::asio::buffer(outbox_.front().bytes),
+                                 [this, self](const boost::system::error_code &ec, std::size_t)
+                                 {
+                                     if (ec)
+                                     {
+                                         std::cerr << "Error in sendResponse: " << ec.message() << std::endl;
+                                         outbox_.clear();
+                                         return;
+                                     }
+                                     server_.metrics_.ack.record(metricsNowNs() - outbox_.front().enqueuedNs);
+                                     outbox_.pop_front();
+                                     if (!outbox_.empty())
+                                     {
+                                         writeNext();
+                                     }
+                                     else if (closeAfterWrite_)
+                                     {
+                                         boost::system::error_code ignored;
+                                         socket_->close(ignored);
+                                     }
+                                 });
+    }
+
+    void closeWithError(const boost::system::error_code &ec)
+    {
+        if (ec == boost::asio::error::eof)
+        {
+            std::cout << "Client disconnected: " << endpoint() << std::endl;
+        }
+        else
+        {
+            std::cerr << "Error in receiveData: " << ec.message() << std::endl;
+        }
+
+        // 아직 처리되지 않은 프레임의 예산 반환
+        for (const auto &frame : queue_)
+        {
+            releaseBytes(frame.payload->size());
+        }
+        queue_.clear();
+    }
+
+    std::string endpoint() const
+    {
+        boost::system::error_code ec;
+        auto remote = socket_->remote_endpoint(ec);
+        return ec ? std::string("<unknown>") : remote.address().to_string() + ":" + std::to_string(remote.port());
+    }
+
+    Server &server_;
+    std::shared_ptr<tcp::socket> socket_;
+
+    uint32_t prefix_ = 0;
+    std::array<unsigned char, FRAME_HEADER_SIZE> headerBuffer_{};
+    std::array<char, 64 * 1024> scratch_{};
+    bool sessionMode_ = false;
+    bool closeAfterWrite_ = false;
+    uint32_t legacySeq_ = 0;
+    uint64_t lastKeyframeNs_ = 0; // 마지막으로 Keyframe(QR crop)을 요청한 시각 (metricsNowNs, 0 이면 아직 없음)
+
+    std::deque<PendingFrame> queue_; // 작업 스레드 투입을 기다리는 프레임
+    size_t active_ = 0;              // 작업 스레드에서 처리 중인 프레임 수
+    size_t bufferedBytes_ = 0;       // queue_ + 처리 중 프레임의 페이로드 바이트 합
+
+    std::deque<OutgoingMessage> outbox_;
+};
+
+void Server::receiveData(const std::shared_ptr<tcp::socket> &socket)
+{
+    std::make_shared<Session>(*this, socket)->start();
+}
+
+static void printUsage(const char *program)
+{
+    std::cerr << "Usage: " << program << " [port] [--max-frame BYTES] [--conn-budget BYTES] [--global-budget BYTES]"
+              << " [--max-queued N] [--max-concurrent N] [--policy reject|drop-oldest]"
+              << " [--metrics-port PORT] [--metrics-file PATH] [--metrics-interval SEC]"
+              << " [--persist-scale full|half|quarter|eighth] [--scan-store DIR]"
+              << " [--qr on|off] [--qr-scale full|half|quarter|eighth] [--qr-cache ENTRIES] [--qr-crop-interval MS]"
+              << " [--composite row|grid|panels=A+B,cols=N] [--analysis-scale full|half]"
+              << " [--trace PATH]" << std::endl;
+}
+
+int main(int argc, char *argv[])
 {
     try
     {
         unsigned short port = 12345; // 서버에서 사용할 포트 번호
-        Server server(port);
+        AdmissionConfig admission;
+        unsigned short metricsPort = 0; // 0 이면 HTTP 메트릭 엔드포인트 비활성화
+        std::string metricsFile;        // 비어 있으면 파일 덤프 비활성화
+        int metricsInterval = 10;
+        DecodeScale persistScale = DecodeScale::Full;
+        std::string scanStoreDir; // 비어 있으면 결과 레코드의 스캔 결과를 저장하지 않음
+        bool qrAnalysis = true;
+        QrAnalysisConfig qrConfig;
+        CompositeLayout compositeLayout;
+        int analysisLevels = 0;
+        std::string tracePath; // 비어 있으면 트레이스 비활성화 (FRAME_TRACE 로 빌드했을 때만 사용)
+
+        for (int i = 1; i < argc; ++i)
+        {
+            std::string arg = argv[i];
+            bool hasValue = i + 1 < argc;
+            if (arg == "--max-frame" && hasValue)
+                admission.maxFrameSize = static_cast<uint32_t>(std::stoul(argv[++i]));
+            else if (arg == "--conn-budget" && hasValue)
+                admission.connectionBudget = std::stoull(argv[++i]);
+            else if (arg == "--global-budget" && hasValue)
+                admission.globalBudget = std::stoull(argv[++i]);
+            else if (arg == "--max-queued" && hasValue)
+                admission.maxQueuedFrames = static_cast<uint32_t>(std::stoul(argv[++i]));
+            else if (arg == "--max-concurrent" && hasValue)
+                admission.maxConcurrentFrames = std::max(1u, static_cast<uint32_t>(std::stoul(argv[++i])));
+            else if (arg == "--policy" && hasValue)
+            {
+                if (!parseOverflowPolicy(argv[++i], admission.policy))
+                {
+                    printUsage(argv[0]);
+                    return 1;
+                }
+            }
+            else if (arg == "--metrics-port" && hasValue)
+                metricsPort = static_cast<unsigned short>(std::stoi(argv[++i]));
+            else if (arg == "--metrics-file" && hasValue)
+                metricsFile = argv[++i];
+            else if (arg == "--metrics-interval" && hasValue)
+                metricsInterval = std::max(1, std::stoi(argv[++i]));
+            else if (arg == "--persist-scale" && hasValue)
+            {
+                if (!parseDecodeScale(argv[++i], persistScale))
+                {
+                    printUsage(argv[0]);
+                    return 1;
+                }
+            }
+            else if (arg == "--scan-store" && hasValue)
+                scanStoreDir = argv[++i];
+            else if (arg == "--qr" && hasValue && (std::string(argv[i + 1]) == "on" || std::string(argv[i + 1]) == "off"))
+                qrAnalysis = std::string(argv[++i]) == "on";
+            else if (arg == "--qr-scale" && hasValue)
+            {
+                if (!parseDecodeScale(argv[++i], qrConfig.scale))
+                {
+                    printUsage(argv[0]);
+                    return 1;
+                }
+            }
+            else if (arg == "--qr-cache" && hasValue)
+                qrConfig.cacheEntries = std::stoull(argv[++i]);
+            else if (arg == "--qr-crop-interval" && hasValue)
+                qrConfig.cropIntervalMs = std::max(0, std::stoi(argv[++i]));
+            else if (arg == "--composite" && hasValue)
+            {
+                if (!parseCompositeLayout(argv[++i], compositeLayout))
+                {
+                    printUsage(argv[0]);
+                    return 1;
+                }
+            }
+            else if (arg == "--analysis-scale" && hasValue)
+            {
+                if (!parseAnalysisScale(argv[++i], analysisLevels))
+                {
+                    printUsage(argv[0]);
+                    return 1;
+                }
+            }
+            else if (arg == "--trace" && hasValue)
+                tracePath = argv[++i];
+            else if (!arg.empty() && arg[0] != '-')
+                port = static_cast<unsigned short>(std::stoi(arg));
+            else
+            {
+                printUsage(argv[0]);
+                return 1;
+            }
+        }
+
+        // 서버보다 먼저 만들어 작업 스레드가 모두 끝난 뒤 봉인(flush)되도록 함. SIGINT / SIGTERM 이면 server.start() 가
+        // 돌아와 이 블록을 벗어나면서 Server -> ScanStore 순으로 소멸함. 비정상 종료로 잃는 양은 maxUnsealedSec 이내
+        std::unique_ptr<ScanStore> scanStore;
+        if (!scanStoreDir.empty())
+        {
+            ScanStoreConfig storeConfig;
+            storeConfig.directory = scanStoreDir;
+            scanStore = std::make_unique<ScanStore>(storeConfig);
+            if (!scanStore->open())
+            {
+                return 1;
+            }
+        }
+
+        Server server(port, admission, persistScale);
+        server.setCompositeLayout(compositeLayout);
+        server.setAnalysisLevels(analysisLevels);
+        if (qrAnalysis)
+        {
+            server.enableQrAnalysis(qrConfig);
+        }
+        server.addResultsConsumer(ResultsConsumer{"log", [](const FrameResults &results, const FrameHeader &header)
+                                                  {
+                                                      std::cout << "Results (seq " << header.seq << "): " << results.qrCodes.size()
+                                                                << " QR, " << results.lines.size() << " lines, " << results.boxes.size()
+                                                                << " boxes, " << results.scans.size() << " hubs" << std::endl;
+                                                      for (const auto &code : results.qrCodes)
+                                                      {
+                                                          std::cout << "  QR: " << (code.text.empty() ? "<undecoded>" : code.text) << std::endl;
+                                                      }
+                                                  }});
+        if (scanStore)
+        {
+            ScanStore *store = scanStore.get();
+            server.addResultsConsumer(ResultsConsumer{"scan_store", [store](const FrameResults &results, const FrameHeader &)
+                                                      {
+                                                          if (results.hasScans)
+                                                          {
+                                                              store->append(results.captureUs, results.scans);
+                                                          }
+                                                      }});
+        }
+        if (metricsPort != 0)
+        {
+            server.enableMetricsEndpoint(metricsPort);
+            std::cout << "Metrics available at http://127.0.0.1:" << metricsPort << "/metrics" << std::endl;
+        }
+
+        std::unique_ptr<MetricsFileDumper> metricsDumper;
+        if (!metricsFile.empty())
+        {
+            metricsDumper = std::make_unique<MetricsFileDumper>(metricsFile, std::chrono::seconds(metricsInterval));
+        }
+
+#if FRAME_TRACE
+        // 프레임 단계별 트레이스를 10초마다 Chrome trace JSON 으로 기록 (Edge 의 EDGE_TRACE 결과와 trace_merge 로 합침)
+        std::unique_ptr<TraceFileDumper> traceDumper;
+        if (!tracePath.empty())
+        {
+            FrameTracer::instance().start("server");
+            traceDumper = std::make_unique<TraceFileDumper>(tracePath, std::chrono::seconds(10));
+            std::cout << "Frame trace written to " << tracePath << std::endl;
+        }
+#else
+        if (!tracePath.empty())
+        {
+            std::cerr << "Warning: built without FRAME_TRACE, --trace ignored" << std::endl;
+        }
+#endif
+
         std::cout << "Server is running on port " << port << std::endl;
         server.start();
     }
@@ -0,0 +1,76 @@
+#ifndef METRICS_HTTP_H
+#define METRICS_HTTP_H
+
+#include <boost/asio.hpp>
+#include <iostream>
+#include <memory>
+#include <string>
+#include "metrics.h"
+
+// 로컬 전용 메트릭 HTTP 엔드포인트
+// 127.0.0.1:<port> 로 들어오는 모든 요청에 Prometheus 텍스트 포맷 스냅샷을 응답하고 연결을 닫음.
+// 서버의 io_context 를 공유하므로 별도 스레드가 필요 없음.
+class MetricsHttpEndpoint
+{
+public:
+    MetricsHttpEndpoint(boost::asio::io_context &io_context, unsigned short port)
+        : io_context_(io_context),
+          acceptor_(io_context, boost::asio::ip::tcp::endpoint(boost::asio::ip::address_v4::loopback(), port))
+    {
+        acceptConnection();
+    }
+
+private:
+    struct Connection
+    {
+        explicit Connection(boost::asio::io_context &io_context) : socket(io_context) {}
+        boost::asio::ip::tcp::socket socket;
+        boost::asio::streambuf request;
+        std::string response;
+    };
+
+    void acceptConnection()
+    {
+        auto connection = std::make_shared<Connection>(io_context_);
+        acceptor_.async_accept(connection->socket, [this, connection](const boost::system::error_code &ec)
+                               {
+                                   if (!ec)
+                                   {
+                                       handleRequest(connection);
+                                   }
+                                   acceptConnection();
+                               });
+    }
+
+    // 요청 헤더 끝까지만 읽고 경로와 관계없이 스냅샷 응답
+    void handleRequest(const std::shared_ptr<Connection> &connection)
+    {
+        boost::asio::async_read_until(connection->socket, connection->request, "\r\n\r\n",
+                                      [connection](const boost::system::error_code &ec, std::size_t)
+                                      {
+                                          if (ec)
+                                          {
+                                              return;
+                                          }
+
+                                          std::string body = MetricsRegistry::instance().renderPrometheus();
+                                          connection->response = "HTTP/1.0 200 OK\r\n"
+                                                                 "Content-Type: text/plain; version=0.0.4\r\n"
+                                                                 "Content-Length: " +
+                                                                 std::to_string(body.size()) + "\r\n"
+                                                                 "Connection: close\r\n\r\n" +
+                                                                 body;
+                                          boost::asio::async_write(connection->socket, boost::asio::buffer(connection->response),
+                                                                   [connection](const boost::system::error_code &, std::size_t)
+                                                                   {
+                                                                       boost::system::error_code ignored;
+                                                                       connection->socket.shutdown(boost::asio::ip::tcp::socket::shutdown_both, ignored);
+                                                                   });
+                                      });
+    }
+
+    boost::asio::io_context &io_context_;
+    boost::asio::ip::tcp::acceptor acceptor_;
+};
+
+#endif // METRICS_HTTP_H
@@ -0,0 +1,955 @@
+#ifndef SCAN_STORE_H
+#define SCAN_STORE_H
+
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "scan_result.h"
+
+// 수신한 스캔 결과의 시계열 저장소 (MAC Server 내장)
+//
+// - 허브별 디렉토리 아래에 시간 구간(partition, 기본 1시간)마다 세그먼트 파일을 추가만 함
+// - 세그먼트는 열(column) 단위로 저장: 시각은 델타 + zigzag varint, serverId 는 세그먼트 사전 번호 varint,
+//   uuid 는 델타 + zigzag varint, 요약(ScanStats) 은 관측 횟수 varint + (시각 - 처음 관측) varint + rssi 최소/최대/평균 3 바이트.
+//   블록(기본 1024 레코드)마다 델타 기준값을 다시 잡고 블록 색인에 시각 범위와 오프셋을 기록
+// - 레코드 시각은 항목의 마지막 관측 시각 (모르면 결과 레코드의 captureUs). 버전 1 세그먼트(요약 열 없음)도 읽음
+// - 봉인된 세그먼트는 읽기 전용 mmap 으로 열어 두고, 질의는 세그먼트/블록 시각 범위로 건너뛴 뒤 필요한 블록만 풀어 읽음
+// - 아직 봉인되지 않은 레코드는 메모리의 열 배열에 있으며 질의에 함께 포함됨 (flush 또는 소멸 시 봉인).
+//   구간이 바뀌거나 크기가 차지 않아도 maxUnsealedSec 이 지나면 백그라운드 스레드가 봉인하므로 비정상 종료 시 잃는 양이 제한됨
+// - 봉인(파일 쓰기)에 실패하면 허브마다 1초부터 두 배씩 늘어나는 간격으로만 다시 시도하고, 그동안 메모리에 쌓인
+//   레코드가 maxUnsealedRecords 에 닿으면 새 레코드는 버리고 droppedRecords 로 셈
+//
+// 정수는 호스트 바이트 오더로 기록함 (같은 서버에서만 읽음)
+
+struct ScanStoreConfig
+{
+    std::string directory = "scan_store";
+    uint64_t partitionUs = 3600ULL * 1000000; // 세그먼트가 걸칠 수 있는 최대 시간 구간
+    size_t maxSegmentRecords = 1 << 20;       // 이 수에 도달하면 봉인
+    uint32_t blockRecords = 1024;             // 블록 색인 간격
+    size_t maxUnsealedRecords = 4 << 20;      // 봉인 실패가 이어질 때 허브마다 메모리에 둘 최대 레코드 수
+    uint32_t sealRetryMaxSec = 60;            // 봉인 재시도 간격 상한
+    uint32_t maxUnsealedSec = 60;             // 봉인하지 않은 레코드를 메모리에 두는 최대 시간 (0 이면 구간 / 크기로만 봉인)
+};
+
+// 질의 결과 한 행 (serverId 는 질의 콜백 안에서만 유효)
+struct ScanStoreRow
+{
+    uint64_t timeUs;
+    std::string_view serverId;
+    int32_t uuid;
+    ScanStats stats; // 버전 1 세그먼트면 기본값
+};
+
+// 특정 serverId 를 본 기록
+struct ScanSighting
+{
+    std::string hubId;
+    uint64_t timeUs;
+    int32_t uuid;
+    ScanStats stats;
+};
+
+static inline void scanStorePutVarint(std::string &out, uint64_t value)
+{
+    while (value >= 0x80)
+    {
+        out += static_cast<char>(value | 0x80);
+        value >>= 7;
+    }
+    out += static_cast<char>(value);
+}
+
+// 잘린 데이터면 p 를 end 로 옮기고 0 반환
+static inline uint64_t scanStoreGetVarint(const uint8_t *&p, const uint8_t *end)
+{
+    uint64_t value = 0;
+    for (int shift = 0; p < end && shift < 64; shift += 7)
+    {
+        uint8_t byte = *p++;
+        value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+        if (!(byte & 0x80))
+        {
+            return value;
+        }
+    }
+    p = end;
+    return 0;
+}
+
+static inline uint64_t scanStoreZigzag(int64_t value)
+{
+    return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+}
+
+static inline int64_t scanStoreUnzigzag(uint64_t value)
+{
+    return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+}
+
+// 세그먼트 파일 헤더
+struct ScanSegmentHeader
+{
+    char magic[4]; // "AZTS"
+    uint32_t version;
+    uint32_t recordCount;
+    uint32_t dictCount;
+    uint32_t blockCount;
+    uint32_t blockRecords;
+    uint64_t minTimeUs;
+    uint64_t maxTimeUs;
+    uint64_t hubOffset; // u16 길이 + hubId
+    uint64_t dictOffset; // (u16 길이 + serverId) * dictCount
+    uint64_t indexOffset; // ScanBlockIndex * blockCount
+    uint64_t timeOffset;
+    uint64_t serverOffset;
+    uint64_t uuidOffset;
+    uint64_t fileSize;
+    uint64_t statsOffset; // 버전 2 부터 (요약 열, uuid 열 다음)
+};
+
+static constexpr uint32_t SCAN_SEGMENT_VERSION = 2;
+static constexpr size_t SCAN_SEGMENT_HEADER_V1_SIZE = offsetof(ScanSegmentHeader, statsOffset);
+
+// 블록 하나의 색인. 블록 첫 레코드의 델타 기준은 firstTimeUs / firstUuid
+struct ScanBlockIndex
+{
+    uint64_t firstTimeUs;
+    uint64_t minTimeUs;
+    uint64_t maxTimeUs;
+    uint32_t timeOffset; // 각 열 시작 기준 오프셋
+    uint32_t serverOffset;
+    uint32_t uuidOffset;
+    int32_t firstUuid;
+    uint32_t statsOffset; // 버전 2 부터
+    uint32_t reserved;
+};
+
+static constexpr size_t SCAN_BLOCK_INDEX_V1_SIZE = offsetof(ScanBlockIndex, statsOffset);
+
+// 봉인된 세그먼트 (읽기 전용 mmap)
+class ScanSegment
+{
+public:
+    ~ScanSegment()
+    {
+        if (data_)
+        {
+            munmap(const_cast<uint8_t *>(data_), size_);
+        }
+    }
+
+    // 파일을 열어 헤더/사전을 검증. 실패하면 nullptr
+    static std::unique_ptr<ScanSegment> open(const std::string &path)
+    {
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+        {
+            std::cerr << "Failed to open scan segment " << path << ": " << strerror(errno) << std::endl;
+            return nullptr;
+        }
+        struct stat st;
+        if (fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < SCAN_SEGMENT_HEADER_V1_SIZE)
+        {
+            std::cerr << "Invalid scan segment " << path << std::endl;
+            ::close(fd);
+            return nullptr;
+        }
+        void *mapped = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (mapped == MAP_FAILED)
+        {
+            std::cerr << "Failed to map scan segment " << path << ": " << strerror(errno) << std::endl;
+            return nullptr;
+        }
+
+        std::unique_ptr<ScanSegment> segment(new ScanSegment());
+        segment->data_ = static_cast<const uint8_t *>(mapped);
+        segment->size_ = static_cast<size_t>(st.st_size);
+        if (!segment->parse())
+        {
+            std::cerr << "Corrupt scan segment " << path << std::endl;
+            return nullptr;
+        }
+        return segment;
+    }
+
+    const std::string &hubId() const { return hubId_; }
+    uint64_t minTimeUs() const { return header_.minTimeUs; }
+    uint64_t maxTimeUs() const { return header_.maxTimeUs; }
+    uint32_t recordCount() const { return header_.recordCount; }
+    size_t bytes() const { return size_; }
+    const std::vector<std::string_view> &dictionary() const { return dictionary_; }
+
+    bool overlaps(uint64_t fromUs, uint64_t toUs) const
+    {
+        return header_.recordCount > 0 && header_.maxTimeUs >= fromUs && header_.minTimeUs <= toUs;
+    }
+
+    // serverId 의 세그먼트 사전 번호 (없으면 -1)
+    int64_t serverIndex(std::string_view serverId) const
+    {
+        auto it = dictionaryIndex_.find(serverId);
+        return it != dictionaryIndex_.end() ? it->second : -1;
+    }
+
+    // [fromUs, toUs] 에 속한 레코드마다 fn(timeUs, serverIndex, uuid, stats)
+    template <class Fn>
+    void scan(uint64_t fromUs, uint64_t toUs, Fn &&fn) const
+    {
+        bool hasStats = header_.version >= 2;
+        const uint8_t *timeEnd = data_ + header_.serverOffset;
+        const uint8_t *serverEnd = data_ + header_.uuidOffset;
+        const uint8_t *uuidEnd = data_ + (hasStats ? header_.statsOffset : header_.fileSize);
+        const uint8_t *statsEnd = data_ + header_.fileSize;
+        for (uint32_t b = 0; b < header_.blockCount; ++b)
+        {
+            ScanBlockIndex block = {};
+            std::memcpy(&block, data_ + header_.indexOffset + b * indexStride(), indexStride());
+            if (block.maxTimeUs < fromUs || block.minTimeUs > toUs)
+            {
+                continue;
+            }
+            const uint8_t *t = data_ + header_.timeOffset + block.timeOffset;
+            const uint8_t *s = data_ + header_.serverOffset + block.serverOffset;
+            const uint8_t *u = data_ + header_.uuidOffset + block.uuidOffset;
+            const uint8_t *st = hasStats ? data_ + header_.statsOffset + block.statsOffset : statsEnd;
+            uint32_t count = std::min(header_.blockRecords, header_.recordCount - b * header_.blockRecords);
+            uint64_t time = block.firstTimeUs;
+            int64_t uuid = block.firstUuid;
+            ScanStats stats;
+            for (uint32_t i = 0; i < count; ++i)
+            {
+                time += static_cast<uint64_t>(scanStoreUnzigzag(scanStoreGetVarint(t, timeEnd)));
+                uint64_t server = scanStoreGetVarint(s, serverEnd);
+                uuid += scanStoreUnzigzag(scanStoreGetVarint(u, uuidEnd));
+                if (hasStats)
+                {
+                    stats.count = static_cast<uint32_t>(scanStoreGetVarint(st, statsEnd));
+                    uint64_t span = scanStoreGetVarint(st, statsEnd);
+                    stats.firstSeenUs = time - std::min(time, span);
+                    stats.lastSeenUs = time;
+                    int8_t rssi[3] = {SCAN_RSSI_UNKNOWN, SCAN_RSSI_UNKNOWN, SCAN_RSSI_UNKNOWN};
+                    if (statsEnd - st >= 3)
+                    {
+                        std::memcpy(rssi, st, 3);
+                        st += 3;
+                    }
+                    stats.rssiMin = rssi[0];
+                    stats.rssiMax = rssi[1];
+                    stats.rssiMean = rssi[2];
+                }
+                if (time >= fromUs && time <= toUs && server < dictionary_.size())
+                {
+                    fn(time, static_cast<uint32_t>(server), static_cast<int32_t>(uuid), stats);
+                }
+            }
+        }
+    }
+
+private:
+    ScanSegment() = default;
+
+    size_t indexStride() const
+    {
+        return header_.version >= 2 ? sizeof(ScanBlockIndex) : SCAN_BLOCK_INDEX_V1_SIZE;
+    }
+
+    bool parse()
+    {
+        header_ = ScanSegmentHeader();
+        std::memcpy(&header_, data_, SCAN_SEGMENT_HEADER_V1_SIZE);
+        if (header_.version >= 2)
+        {
+            if (size_ < sizeof(header_))
+            {
+                return false;
+            }
+            std::memcpy(&header_, data_, sizeof(header_));
+        }
+        uint64_t uuidEnd = header_.version >= 2 ? header_.statsOffset : header_.fileSize;
+        if (std::memcmp(header_.magic, "AZTS", 4) != 0 || header_.version < 1 || header_.version > SCAN_SEGMENT_VERSION ||
+            header_.fileSize != size_ || header_.blockRecords == 0 ||
+            header_.indexOffset + static_cast<uint64_t>(header_.blockCount) * indexStride() > size_ ||
+            header_.timeOffset > header_.serverOffset || header_.serverOffset > header_.uuidOffset ||
+            header_.uuidOffset > uuidEnd || uuidEnd > size_ ||
+            header_.blockCount != (header_.recordCount + header_.blockRecords - 1) / header_.blockRecords)
+        {
+            return false;
+        }
+
+        const uint8_t *p = data_ + header_.hubOffset;
+        const uint8_t *end = data_ + header_.indexOffset;
+        std::string_view hub;
+        if (!readString(p, end, hub))
+        {
+            return false;
+        }
+        hubId_ = std::string(hub);
+
+        p = data_ + header_.dictOffset;
+        dictionary_.reserve(header_.dictCount);
+        for (uint32_t i = 0; i < header_.dictCount; ++i)
+        {
+            std::string_view name;
+            if (!readString(p, end, name))
+            {
+                return false;
+            }
+            dictionaryIndex_.emplace(name, i);
+            dictionary_.push_back(name);
+        }
+        return true;
+    }
+
+    static bool readString(const uint8_t *&p, const uint8_t *end, std::string_view &value)
+    {
+        if (end - p < 2)
+        {
+            return false;
+        }
+        uint16_t length;
+        std::memcpy(&length, p, 2);
+        p += 2;
+        if (end - p < length)
+        {
+            return false;
+        }
+        value = std::string_view(reinterpret_cast<const char *>(p), length);
+        p += length;
+        return true;
+    }
+
+    const uint8_t *data_ = nullptr;
+    size_t size_ = 0;
+    ScanSegmentHeader header_;
+    std::string hubId_;
+    std::vector<std::string_view> dictionary_; // mmap 영역을 가리킴
+    std::unordered_map<std::string_view, uint32_t> dictionaryIndex_;
+};
+
+class ScanStore
+{
+public:
+    explicit ScanStore(const ScanStoreConfig &config = ScanStoreConfig()) : config_(config)
+    {
+        config_.blockRecords = std::max<uint32_t>(config_.blockRecords, 1);
+        config_.partitionUs = std::max<uint64_t>(config_.partitionUs, 1);
+        config_.maxSegmentRecords = std::max<size_t>(config_.maxSegmentRecords, 1);
+        config_.maxUnsealedRecords = std::max(config_.maxUnsealedRecords, config_.maxSegmentRecords);
+        config_.sealRetryMaxSec = std::max<uint32_t>(config_.sealRetryMaxSec, 1);
+    }
+
+    ~ScanStore()
+    {
+        if (sealer_.joinable())
+        {
+            {
+                std::lock_guard<std::mutex> lock(sealerMutex_);
+                stopping_ = true;
+            }
+            sealerCv_.notify_one();
+            sealer_.join();
+        }
+        flush();
+    }
+
+    ScanStore(const ScanStore &) = delete;
+    ScanStore &operator=(const ScanStore &) = delete;
+
+    // 저장소 디렉토리를 만들고 기존 세그먼트를 모두 mmap 으로 염
+    bool open()
+    {
+        std::unique_lock<std::shared_mutex> lock(mutex_);
+        if (!makeDirectory(config_.directory))
+        {
+            return false;
+        }
+        DIR *root = opendir(config_.directory.c_str());
+        if (!root)
+        {
+            std::cerr << "Failed to open scan store " << config_.directory << ": " << strerror(errno) << std::endl;
+            return false;
+        }
+        while (struct dirent *hubEntry = readdir(root))
+        {
+            std::string hubDir = config_.directory + "/" + hubEntry->d_name;
+            DIR *segments = hubEntry->d_name[0] != '.' ? opendir(hubDir.c_str()) : nullptr;
+            if (!segments)
+            {
+                continue;
+            }
+            while (struct dirent *segmentEntry = readdir(segments))
+            {
+                std::string name = segmentEntry->d_name;
+                if (name.size() < 4 || name.compare(name.size() - 4, 4, ".seg") != 0)
+                {
+                    continue;
+                }
+                auto segment = ScanSegment::open(hubDir + "/" + name);
+                if (segment)
+                {
+                    Hub &hub = hubLocked(segment->hubId());
+                    hub.nextSequence = std::max(hub.nextSequence, parseSequence(name) + 1);
+                    hub.segments.push_back(std::move(segment));
+                }
+            }
+            closedir(segments);
+        }
+        closedir(root);
+
+        // 질의 결과가 대체로 시각순이 되도록 세그먼트를 시작 시각순으로 정렬
+        for (auto &hub : hubs_)
+        {
+            std::sort(hub.second->segments.begin(), hub.second->segments.end(),
+                      [](const std::unique_ptr<ScanSegment> &a, const std::unique_ptr<ScanSegment> &b)
+                      { return a->minTimeUs() < b->minTimeUs(); });
+        }
+        if (config_.maxUnsealedSec > 0 && !sealer_.joinable())
+        {
+            sealer_ = std::thread(&ScanStore::runSealer, this);
+        }
+        return true;
+    }
+
+    void append(uint64_t timeUs, std::string_view hubId, std::string_view serverId, int32_t uuid,
+                const ScanStats &stats = ScanStats())
+    {
+        std::unique_lock<std::shared_mutex> lock(mutex_);
+        appendLocked(hubLocked(hubId), timeUs, serverId, uuid, stats);
+    }
+
+    // 스캔 결과 하나를 추가. 항목 시각은 마지막 관측 시각, 모르면 timeUs (결과 레코드의 captureUs)
+    void append(uint64_t timeUs, const std::vector<ScanResult> &results)
+    {
+        std::unique_lock<std::shared_mutex> lock(mutex_);
+        for (const auto &result : results)
+        {
+            Hub &hub = hubLocked(result.hubId);
+            for (const auto &entry : result.logList)
+            {
+                appendLocked(hub, entry.stats.lastSeenUs != 0 ? entry.stats.lastSeenUs : timeUs, entry.serverId, entry.uuid,
+                             entry.stats);
+            }
+        }
+    }
+
+    // 메모리에 남은 레코드를 모두 세그먼트 파일로 봉인 (재시도 대기 중인 허브도 바로 시도)
+    void flush()
+    {
+        std::unique_lock<std::shared_mutex> lock(mutex_);
+        for (auto &hub : hubs_)
+        {
+            sealLocked(*hub.second);
+        }
+    }
+
+    // 첫 레코드가 maxUnsealedSec 보다 오래 메모리에 있는 허브만 봉인 (재시도 대기 중인 허브는 건너뜀)
+    void sealExpired()
+    {
+        std::unique_lock<std::shared_mutex> lock(mutex_);
+        auto now = std::chrono::steady_clock::now();
+        for (auto &hub : hubs_)
+        {
+            const ActiveSegment &active = hub.second->active;
+            if (!active.times.empty() && now - active.openedAt >= std::chrono::seconds(config_.maxUnsealedSec) &&
+                now >= hub.second->sealRetryAt)
+            {
+                sealLocked(*hub.second);
+            }
+        }
+    }
+
+    // hubId 가 [fromUs, toUs] 사이에 기록한 레코드마다 fn(ScanStoreRow)
+    void query(std::string_view hubId, uint64_t fromUs, uint64_t toUs, const std::function<void(const ScanStoreRow &)> &fn) const
+    {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        auto it = hubs_.find(hubId);
+        if (it == hubs_.end())
+        {
+            return;
+        }
+        const Hub &hub = *it->second;
+        for (const auto &segment : hub.segments)
+        {
+            if (segment->overlaps(fromUs, toUs))
+            {
+                const auto &dictionary = segment->dictionary();
+                segment->scan(fromUs, toUs, [&](uint64_t time, uint32_t server, int32_t uuid, const ScanStats &stats)
+                              { fn(ScanStoreRow{time, dictionary[server], uuid, stats}); });
+            }
+        }
+        if (hub.active.overlaps(fromUs, toUs))
+        {
+            hub.active.scan(fromUs, toUs, [&](uint64_t time, uint32_t server, int32_t uuid, const ScanStats &stats)
+                            { fn(ScanStoreRow{time, hub.active.dictionary[server], uuid, stats}); });
+        }
+    }
+
+    // hubId 가 [fromUs, toUs] 사이에 본 serverId 목록 (정렬, 중복 없음)
+    // 구간에 완전히 포함된 세그먼트는 사전만 보고 답함
+    std::vector<std::string> serversSeen(std::string_view hubId, uint64_t fromUs, uint64_t toUs) const
+    {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        std::vector<std::string_view> seen;
+        auto it = hubs_.find(hubId);
+        if (it != hubs_.end())
+        {
+            const Hub &hub = *it->second;
+            for (const auto &segment : hub.segments)
+            {
+                if (!segment->overlaps(fromUs, toUs))
+                {
+                    continue;
+                }
+                const auto &dictionary = segment->dictionary();
+                if (segment->minTimeUs() >= fromUs && segment->maxTimeUs() <= toUs)
+                {
+                    seen.insert(seen.end(), dictionary.begin(), dictionary.end());
+                    continue;
+                }
+                std::vector<bool> hit(dictionary.size(), false);
+                segment->scan(fromUs, toUs, [&](uint64_t, uint32_t server, int32_t, const ScanStats &)
+                              { hit[server] = true; });
+                for (size_t i = 0; i < hit.size(); ++i)
+                {
+                    if (hit[i])
+                        seen.push_back(dictionary[i]);
+                }
+            }
+            if (hub.active.overlaps(fromUs, toUs))
+            {
+                std::vector<bool> hit(hub.active.dictionary.size(), false);
+                hub.active.scan(fromUs, toUs, [&](uint64_t, uint32_t server, int32_t, const ScanStats &)
+                                { hit[server] = true; });
+                for (size_t i = 0; i < hit.size(); ++i)
+                {
+                    if (hit[i])
+                        seen.push_back(hub.active.dictionary[i]);
+                }
+            }
+        }
+        std::sort(seen.begin(), seen.end());
+        seen.erase(std::unique(seen.begin(), seen.end()), seen.end());
+        return std::vector<std::string>(seen.begin(), seen.end());
+    }
+
+    // serverId 가 [fromUs, toUs] 사이에 어느 허브에서 보였는지 (시각순)
+    // 사전에 serverId 가 없는 세그먼트는 풀지 않음
+    std::vector<ScanSighting> findServer(std::string_view serverId, uint64_t fromUs, uint64_t toUs) const
+    {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        std::vector<ScanSighting> sightings;
+        for (const auto &entry : hubs_)
+        {
+            const Hub &hub = *entry.second;
+            for (const auto &segment : hub.segments)
+            {
+                int64_t wanted = segment->overlaps(fromUs, toUs) ? segment->serverIndex(serverId) : -1;
+                if (wanted < 0)
+                {
+                    continue;
+                }
+                segment->scan(fromUs, toUs, [&](uint64_t time, uint32_t server, int32_t uuid, const ScanStats &stats)
+                              {
+                                  if (server == wanted)
+                                      sightings.push_back({hub.hubId, time, uuid, stats}); });
+            }
+            auto active = hub.active.dictionaryIndex.find(std::string(serverId));
+            if (active != hub.active.dictionaryIndex.end() && hub.active.overlaps(fromUs, toUs))
+            {
+                hub.active.scan(fromUs, toUs, [&](uint64_t time, uint32_t server, int32_t uuid, const ScanStats &stats)
+                                {
+                                    if (server == active->second)
+                                        sightings.push_back({hub.hubId, time, uuid, stats}); });
+            }
+        }
+        std::sort(sightings.begin(), sightings.end(), [](const ScanSighting &a, const ScanSighting &b)
+                  { return a.timeUs < b.timeUs; });
+        return sightings;
+    }
+
+    struct Stats
+    {
+        size_t hubs = 0;
+        size_t segments = 0;
+        uint64_t sealedRecords = 0;
+        uint64_t activeRecords = 0;
+        uint64_t bytesOnDisk = 0;
+        uint64_t droppedRecords = 0; // 봉인 실패로 메모리 상한에 닿아 버린 레코드 수
+    };
+
+    Stats stats() const
+    {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        Stats stats;
+        stats.hubs = hubs_.size();
+        for (const auto &entry : hubs_)
+        {
+            for (const auto &segment : entry.second->segments)
+            {
+                ++stats.segments;
+                stats.sealedRecords += segment->recordCount();
+                stats.bytesOnDisk += segment->bytes();
+            }
+            stats.activeRecords += entry.second->active.times.size();
+            stats.droppedRecords += entry.second->droppedRecords;
+        }
+        return stats;
+    }
+
+private:
+    // 아직 봉인되지 않은 세그먼트 (열 배열)
+    struct ActiveSegment
+    {
+        uint64_t partition = 0;
+        uint64_t minTimeUs = UINT64_MAX;
+        uint64_t maxTimeUs = 0;
+        std::chrono::steady_clock::time_point openedAt{}; // 첫 레코드를 추가한 시각 (maxUnsealedSec 기준)
+        std::vector<uint64_t> times;
+        std::vector<uint32_t> servers;
+        std::vector<int32_t> uuids;
+        std::vector<uint32_t> counts; // 요약 (ScanStats)
+        std::vector<uint32_t> spans;  // 시각 - 처음 관측 (us, 모르면 0)
+        std::vector<std::array<int8_t, 3>> rssis; // 최소 / 최대 / 평균
+        std::vector<std::string> dictionary;
+        std::unordered_map<std::string, uint32_t> dictionaryIndex;
+
+        bool overlaps(uint64_t fromUs, uint64_t toUs) const
+        {
+            return !times.empty() && maxTimeUs >= fromUs && minTimeUs <= toUs;
+        }
+
+        template <class Fn>
+        void scan(uint64_t fromUs, uint64_t toUs, Fn &&fn) const
+        {
+            for (size_t i = 0; i < times.size(); ++i)
+            {
+                if (times[i] >= fromUs && times[i] <= toUs)
+                {
+                    fn(times[i], servers[i], uuids[i], stats(i));
+                }
+            }
+        }
+
+        ScanStats stats(size_t i) const
+        {
+            ScanStats stats;
+            stats.count = counts[i];
+            stats.firstSeenUs = times[i] - std::min<uint64_t>(times[i], spans[i]);
+            stats.lastSeenUs = times[i];
+            stats.rssiMin = rssis[i][0];
+            stats.rssiMax = rssis[i][1];
+            stats.rssiMean = rssis[i][2];
+            return stats;
+        }
+
+        void clear()
+        {
+            *this = ActiveSegment();
+        }
+    };
+
+    struct Hub
+    {
+        std::string hubId;
+        std::string directory;
+        uint64_t nextSequence = 0;
+        std::vector<std::unique_ptr<ScanSegment>> segments;
+        ActiveSegment active;
+        std::chrono::steady_clock::time_point sealRetryAt{}; // 봉인 실패 후 다음 시도 시각
+        std::chrono::seconds sealRetryDelay{0};
+        uint64_t droppedRecords = 0;
+    };
+
+    Hub &hubLocked(std::string_view hubId)
+    {
+        auto it = hubs_.find(hubId);
+        if (it != hubs_.end())
+        {
+            return *it->second;
+        }
+        auto hub = std::make_unique<Hub>();
+        hub->hubId = std::string(hubId);
+        hub->directory = config_.directory + "/" + directoryName(hubId);
+        Hub &ref = *hub;
+        hubs_.emplace(hub->hubId, std::move(hub));
+        return ref;
+    }
+
+    void appendLocked(Hub &hub, uint64_t timeUs, std::string_view serverId, int32_t uuid, const ScanStats &stats)
+    {
+        ActiveSegment &active = hub.active;
+        uint64_t partition = timeUs / config_.partitionUs;
+        if (!active.times.empty() && (active.partition != partition || active.times.size() >= config_.maxSegmentRecords))
+        {
+            if (std::chrono::steady_clock::now() >= hub.sealRetryAt)
+            {
+                sealLocked(hub);
+            }
+            if (active.times.size() >= config_.maxUnsealedRecords)
+            {
+                if (hub.droppedRecords++ == 0)
+                {
+                    std::cerr << "Scan store for hub " << hub.hubId << " cannot seal segments, dropping new records" << std::endl;
+                }
+                return;
+            }
+        }
+        if (active.times.empty())
+        {
+            active.partition = partition; // 봉인이 밀린 동안에는 다음 구간 레코드도 처음 구간 세그먼트에 함께 기록
+            active.openedAt = std::chrono::steady_clock::now();
+        }
+
+        std::string key(serverId);
+        auto it = active.dictionaryIndex.find(key);
+        if (it == active.dictionaryIndex.end())
+        {
+            it = active.dictionaryIndex.emplace(key, static_cast<uint32_t>(active.dictionary.size())).first;
+            active.dictionary.push_back(key.substr(0, UINT16_MAX));
+        }
+        active.times.push_back(timeUs);
+        active.servers.push_back(it->second);
+        active.uuids.push_back(uuid);
+        active.counts.push_back(stats.count);
+        uint64_t span = stats.firstSeenUs != 0 ? timeUs - std::min(timeUs, stats.firstSeenUs) : 0;
+        active.spans.push_back(static_cast<uint32_t>(std::min<uint64_t>(span, UINT32_MAX)));
+        active.rssis.push_back({stats.rssiMin, stats.rssiMax, stats.rssiMean});
+        active.minTimeUs = std::min(active.minTimeUs, timeUs);
+        active.maxTimeUs = std::max(active.maxTimeUs, timeUs);
+    }
+
+    // 메모리의 열 배열을 인코딩해 <partition 시작>-<순번>.seg 로 쓰고 mmap 으로 다시 엶
+    void sealLocked(Hub &hub)
+    {
+        ActiveSegment &active = hub.active;
+        if (active.times.empty())
+        {
+            return;
+        }
+
+        uint32_t count = static_cast<uint32_t>(active.times.size());
+        uint32_t blockRecords = config_.blockRecords;
+        uint32_t blockCount = (count + blockRecords - 1) / blockRecords;
+        std::vector<ScanBlockIndex> index(blockCount);
+        std::string timeColumn, serverColumn, uuidColumn, statsColumn;
+        timeColumn.reserve(count * 2);
+        serverColumn.reserve(count);
+        uuidColumn.reserve(count * 2);
+        statsColumn.reserve(count * 5);
+
+        for (uint32_t b = 0; b < blockCount; ++b)
+        {
+            uint32_t begin = b * blockRecords;
+            uint32_t end = std::min(count, begin + blockRecords);
+            ScanBlockIndex &block = index[b];
+            block.firstTimeUs = active.times[begin];
+            block.firstUuid = active.uuids[begin];
+            block.minTimeUs = UINT64_MAX;
+            block.maxTimeUs = 0;
+            block.timeOffset = static_cast<uint32_t>(timeColumn.size());
+            block.serverOffset = static_cast<uint32_t>(serverColumn.size());
+            block.uuidOffset = static_cast<uint32_t>(uuidColumn.size());
+            block.statsOffset = static_cast<uint32_t>(statsColumn.size());
+
+            uint64_t previousTime = block.firstTimeUs;
+            int64_t previousUuid = block.firstUuid;
+            for (uint32_t i = begin; i < end; ++i)
+            {
+                scanStorePutVarint(timeColumn, scanStoreZigzag(static_cast<int64_t>(active.times[i] - previousTime)));
+                scanStorePutVarint(serverColumn, active.servers[i]);
+                scanStorePutVarint(uuidColumn, scanStoreZigzag(active.uuids[i] - previousUuid));
+                scanStorePutVarint(statsColumn, active.counts[i]);
+                scanStorePutVarint(statsColumn, active.spans[i]);
+                statsColumn.append(reinterpret_cast<const char *>(active.rssis[i].data()), 3);
+                previousTime = active.times[i];
+                previousUuid = active.uuids[i];
+                block.minTimeUs = std::min(block.minTimeUs, active.times[i]);
+                block.maxTimeUs = std::max(block.maxTimeUs, active.times[i]);
+            }
+        }
+
+        std::string strings;
+        appendString(strings, hub.hubId);
+        size_t dictStart = strings.size();
+        for (const auto &name : active.dictionary)
+        {
+            appendString(strings, name);
+        }
+
+        ScanSegmentHeader header = {};
+        std::memcpy(header.magic, "AZTS", 4);
+        header.version = SCAN_SEGMENT_VERSION;
+        header.recordCount = count;
+        header.dictCount = static_cast<uint32_t>(active.dictionary.size());
+        header.blockCount = blockCount;
+        header.blockRecords = blockRecords;
+        header.minTimeUs = active.minTimeUs;
+        header.maxTimeUs = active.maxTimeUs;
+        header.hubOffset = sizeof(header);
+        header.dictOffset = header.hubOffset + dictStart;
+        header.indexOffset = align8(header.hubOffset + strings.size());
+        header.timeOffset = header.indexOffset + blockCount * sizeof(ScanBlockIndex);
+        header.serverOffset = header.timeOffset + timeColumn.size();
+        header.uuidOffset = header.serverOffset + serverColumn.size();
+        header.statsOffset = header.uuidOffset + uuidColumn.size();
+        header.fileSize = header.statsOffset + statsColumn.size();
+
+        std::string file(reinterpret_cast<const char *>(&header), sizeof(header));
+        file += strings;
+        file.resize(header.indexOffset, '\0');
+        file.append(reinterpret_cast<const char *>(index.data()), blockCount * sizeof(ScanBlockIndex));
+        file += timeColumn;
+        file += serverColumn;
+        file += uuidColumn;
+        file += statsColumn;
+
+        // 임시 파일에 다 쓴 뒤 rename (중간에 죽어도 반쯤 쓰인 세그먼트가 남지 않음)
+        std::string path = hub.directory + "/" + std::to_string(active.partition * config_.partitionUs) + "-" +
+                           std::to_string(hub.nextSequence++) + ".seg";
+        std::string temp = path + ".tmp";
+        if (!makeDirectory(hub.directory) || !writeFile(temp, file) || rename(temp.c_str(), path.c_str()) != 0)
+        {
+            std::cerr << "Failed to write scan segment " << path << ": " << strerror(errno) << std::endl;
+            unlink(temp.c_str());
+            // 레코드는 메모리에 남겨 두고, 추가할 때마다 전체를 다시 인코딩하지 않도록 간격을 두고 다시 시도
+            hub.sealRetryDelay = std::min(std::max(hub.sealRetryDelay * 2, std::chrono::seconds(1)),
+                                          std::chrono::seconds(config_.sealRetryMaxSec));
+            hub.sealRetryAt = std::chrono::steady_clock::now() + hub.sealRetryDelay;
+            return;
+        }
+        hub.sealRetryDelay = std::chrono::seconds(0);
+        hub.sealRetryAt = {};
+
+        auto segment = ScanSegment::open(path);
+        if (segment)
+        {
+            hub.segments.push_back(std::move(segment));
+        }
+        active.clear();
+    }
+
+    // maxUnsealedSec 의 1/4 마다 sealExpired (레코드는 최대 maxUnsealedSec * 5/4 까지 메모리에 남음)
+    void runSealer()
+    {
+        auto interval = std::chrono::milliseconds(std::max<uint64_t>(config_.maxUnsealedSec * 250ull, 1));
+        std::unique_lock<std::mutex> lock(sealerMutex_);
+        while (!sealerCv_.wait_for(lock, interval, [this]
+                                   { return stopping_; }))
+        {
+            lock.unlock();
+            sealExpired();
+            lock.lock();
+        }
+    }
+
+    static void appendString(std::string &out, const std::string &value)
+    {
+        uint16_t length = static_cast<uint16_t>(std::min<size_t>(value.size(), UINT16_MAX));
+        out.append(reinterpret_cast<const char *>(&length), 2);
+        out.append(value.data(), length);
+    }
+
+    static uint64_t align8(uint64_t value)
+    {
+        return (value + 7) & ~uint64_t(7);
+    }
+
+    static bool writeFile(const std::string &path, const std::string &data)
+    {
+        int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0)
+        {
+            return false;
+        }
+        size_t written = 0;
+        while (written < data.size())
+        {
+            ssize_t n = ::write(fd, data.data() + written, data.size() - written);
+            if (n < 0 && errno == EINTR)
+            {
+                continue;
+            }
+            if (n <= 0)
+            {
+                ::close(fd);
+                return false;
+            }
+            written += static_cast<size_t>(n);
+        }
+        return ::close(fd) == 0;
+    }
+
+    static bool makeDirectory(const std::string &path)
+    {
+        if (mkdir(path.c_str(), 0755) != 0 && errno != EEXIST)
+        {
+            std::cerr << "Failed to create directory " << path << ": " << strerror(errno) << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    // 허브 디렉토리 이름 (영문/숫자/_/- 외의 문자는 %XX)
+    static std::string directoryName(std::string_view hubId)
+    {
+        static const char hex[] = "0123456789ABCDEF";
+        std::string name;
+        for (unsigned char c : hubId)
+        {
+            if (isalnum(c) || c == '_' || c == '-')
+            {
+                name += static_cast<char>(c);
+            }
+            else
+            {
+                name += '%';
+                name += hex[c >> 4];
+                name += hex[c & 0xF];
+            }
+        }
+        return name.empty() ? "%" : name;
+    }
+
+    // "<partition>-<순번>.seg" 의 순번
+    static uint64_t parseSequence(const std::string &name)
+    {
+        size_t dash = name.find('-');
+        return dash == std::string::npos ? 0 : std::strtoull(name.c_str() + dash + 1, nullptr, 10);
+    }
+
+    ScanStoreConfig config_;
+    mutable std::shared_mutex mutex_;
+    std::map<std::string, std::unique_ptr<Hub>, std::less<>> hubs_;
+
+    std::mutex sealerMutex_;
+    std::condition_variable sealerCv_;
+    bool stopping_ = false;
+    std::thread sealer_; // open() 에서 시작 (maxUnsealedSec > 0)
+};
+
+#endif // SCAN_STORE_H
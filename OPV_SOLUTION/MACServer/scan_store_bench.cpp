@@ -0,0 +1,199 @@
+#include <iostream>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <random>
+#include <string>
+#include <vector>
+#include "scan_store.h"
+#include "metrics.h"
+
+// scan_store 벤치마크
+// 허브 H 개, 서버 S 개의 합성 스캔 레코드 N 개(기본 2천만)를 시각순으로 적재한 뒤
+//   - 적재 처리량과 디스크 사용량(레코드당 바이트)
+//   - 무작위 허브/시간 구간의 serversSeen, query 지연 분위수
+//   - 무작위 serverId 의 findServer 지연 분위수
+// 를 보고함. 적재 후 저장소를 다시 열어(mmap) 질의하므로 재시작 후 읽기 경로를 측정함.
+// --dir 이 없으면 mkdtemp 로 만든 임시 디렉토리에 쓰고 끝나면 지움. --dir 은 없거나 빈 디렉토리만 받고 결과를 남겨 둠.
+
+struct BenchConfig
+{
+    std::string directory; // 비어 있으면 임시 디렉토리
+    uint64_t records = 20000000;
+    int hubs = 64;
+    int servers = 2000;
+    uint64_t spanSec = 24 * 3600; // 레코드가 걸친 전체 시간
+    uint64_t rangeSec = 600;      // 질의 시간 구간
+    int queries = 2000;
+};
+
+static void printQuantiles(const char *name, const Histogram::Snapshot &snapshot)
+{
+    auto us = [](uint64_t ns)
+    { return ns / 1000.0; };
+    printf("%-16s: p50 %.1f us, p90 %.1f us, p99 %.1f us, max %.1f us (n=%llu)\n", name,
+           us(snapshot.quantile(0.5)), us(snapshot.quantile(0.9)), us(snapshot.quantile(0.99)), us(snapshot.max),
+           static_cast<unsigned long long>(snapshot.count));
+}
+
+static void printUsage(const char *program)
+{
+    std::cerr << "Usage: " << program << " [--dir DIR] [--records N] [--hubs N] [--servers N]"
+              << " [--span-sec SEC] [--range-sec SEC] [--queries N]" << std::endl;
+}
+
+int main(int argc, char *argv[])
+{
+    BenchConfig config;
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        if (i + 1 >= argc)
+        {
+            printUsage(argv[0]);
+            return 1;
+        }
+        std::string value = argv[++i];
+
+        if (arg == "--dir")
+            config.directory = value;
+        else if (arg == "--records")
+            config.records = std::max(1ULL, std::stoull(value));
+        else if (arg == "--hubs")
+            config.hubs = std::max(1, std::stoi(value));
+        else if (arg == "--servers")
+            config.servers = std::max(1, std::stoi(value));
+        else if (arg == "--span-sec")
+            config.spanSec = std::max(1ULL, std::stoull(value));
+        else if (arg == "--range-sec")
+            config.rangeSec = std::max(1ULL, std::stoull(value));
+        else if (arg == "--queries")
+            config.queries = std::max(1, std::stoi(value));
+        else
+        {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    // 기존 데이터를 지우지 않도록 새 디렉토리에만 씀
+    bool temporary = config.directory.empty();
+    if (temporary)
+    {
+        char pattern[] = "/tmp/scan_store_bench.XXXXXX";
+        if (!mkdtemp(pattern))
+        {
+            std::cerr << "Failed to create a temporary directory: " << strerror(errno) << std::endl;
+            return 1;
+        }
+        config.directory = pattern;
+    }
+    else
+    {
+        std::error_code ec;
+        if (std::filesystem::exists(config.directory, ec) && !std::filesystem::is_empty(config.directory, ec))
+        {
+            std::cerr << "Refusing to use " << config.directory << ": directory is not empty" << std::endl;
+            return 1;
+        }
+    }
+
+    std::vector<std::string> hubIds, serverIds;
+    for (int i = 0; i < config.hubs; ++i)
+        hubIds.push_back("Hub_" + std::to_string(1000 + i));
+    for (int i = 0; i < config.servers; ++i)
+        serverIds.push_back("Server_" + std::to_string(i));
+
+    const uint64_t startUs = 1790000000ULL * 1000000;
+    const uint64_t spanUs = config.spanSec * 1000000;
+    std::mt19937_64 rng(42);
+
+    // 적재: 시각은 단조 증가 + 약간의 지터, 허브마다 일부 서버만 자주 보이도록 치우친 분포
+    ScanStoreConfig storeConfig;
+    storeConfig.directory = config.directory;
+    storeConfig.maxUnsealedSec = 0; // 적재가 오래 걸려도 구간 / 크기로만 봉인 (세그먼트 배치가 실행마다 같도록)
+    auto ingestStart = std::chrono::steady_clock::now();
+    {
+        ScanStore store(storeConfig);
+        if (!store.open())
+        {
+            return 1;
+        }
+        std::uniform_int_distribution<int> hubPick(0, config.hubs - 1);
+        std::geometric_distribution<int> serverPick(0.01);
+        std::uniform_int_distribution<int> jitter(0, 500);
+        for (uint64_t i = 0; i < config.records; ++i)
+        {
+            int hub = hubPick(rng);
+            int server = (serverPick(rng) + hub * 31) % config.servers;
+            uint64_t timeUs = startUs + i * spanUs / config.records + jitter(rng);
+            store.append(timeUs, hubIds[hub], serverIds[server], 100000 + server);
+        }
+        store.flush();
+    }
+    double ingestSec = std::chrono::duration<double>(std::chrono::steady_clock::now() - ingestStart).count();
+
+    ScanStore store(storeConfig);
+    auto openStart = std::chrono::steady_clock::now();
+    if (!store.open())
+    {
+        return 1;
+    }
+    double openMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - openStart).count();
+    ScanStore::Stats stats = store.stats();
+
+    Histogram serversSeenLatency("scan_store_servers_seen_ns", "", "");
+    Histogram queryLatency("scan_store_query_ns", "", "");
+    Histogram findLatency("scan_store_find_server_ns", "", "");
+    uint64_t rowsRead = 0, serversFound = 0, sightingsFound = 0;
+    std::uniform_int_distribution<uint64_t> offsetPick(0, spanUs - std::min(spanUs, config.rangeSec * 1000000));
+    std::uniform_int_distribution<int> hubPick(0, config.hubs - 1);
+    std::uniform_int_distribution<int> serverPick(0, config.servers - 1);
+    for (int q = 0; q < config.queries; ++q)
+    {
+        uint64_t from = startUs + offsetPick(rng);
+        uint64_t to = from + config.rangeSec * 1000000;
+        const std::string &hub = hubIds[hubPick(rng)];
+
+        uint64_t t0 = metricsNowNs();
+        serversFound += store.serversSeen(hub, from, to).size();
+        uint64_t t1 = metricsNowNs();
+        store.query(hub, from, to, [&](const ScanStoreRow &)
+                    { ++rowsRead; });
+        uint64_t t2 = metricsNowNs();
+        sightingsFound += store.findServer(serverIds[serverPick(rng)], from, to).size();
+        uint64_t t3 = metricsNowNs();
+
+        serversSeenLatency.record(t1 - t0);
+        queryLatency.record(t2 - t1);
+        findLatency.record(t3 - t2);
+    }
+
+    printf("===== scan_store benchmark report =====\n");
+    printf("records         : %llu (%d hubs, %d servers, %llu s span)\n", static_cast<unsigned long long>(config.records),
+           config.hubs, config.servers, static_cast<unsigned long long>(config.spanSec));
+    printf("ingest          : %.2f s, %.0f records/s\n", ingestSec, config.records / ingestSec);
+    printf("on disk         : %llu segments, %.1f MiB, %.2f bytes/record\n", static_cast<unsigned long long>(stats.segments),
+           stats.bytesOnDisk / 1048576.0, static_cast<double>(stats.bytesOnDisk) / std::max<uint64_t>(1, stats.sealedRecords));
+    printf("reopen (mmap)   : %.1f ms\n", openMs);
+    printf("queries         : %d x %llu s range (avg %.1f servers, %.1f rows, %.1f sightings)\n", config.queries,
+           static_cast<unsigned long long>(config.rangeSec), static_cast<double>(serversFound) / config.queries,
+           static_cast<double>(rowsRead) / config.queries, static_cast<double>(sightingsFound) / config.queries);
+    printQuantiles("serversSeen", serversSeenLatency.snapshot());
+    printQuantiles("query", queryLatency.snapshot());
+    printQuantiles("findServer", findLatency.snapshot());
+
+    if (temporary)
+    {
+        std::error_code ec;
+        std::filesystem::remove_all(config.directory, ec);
+    }
+    else
+    {
+        printf("store kept in   : %s\n", config.directory.c_str());
+    }
+    return 0;
+}
@@ -0,0 +1,223 @@
+// Edge / 서버 트레이스(trace.h 의 Chrome trace JSON)를 한 타임라인으로 합침
+//
+// 사용법: trace_merge OUTPUT INPUT... [--no-align] [--send NAME] [--recv NAME]
+// 첫 번째 입력(보통 Edge)을 기준으로, 각 파일의 otherData.epochNs (기록 시작 시점의 벽시계) 차이만큼 ts 를 옮기고
+// 파일마다 pid 를 1, 2, ... 로 다시 붙임. 기기 간 시계가 어긋나 서버의 수신(--recv, 기본 "read")이 같은 seq 의
+// Edge 전송(--send, 기본 "socket_write") 시작보다 먼저 끝나는 것으로 보이면, 그런 프레임이 없도록 그 파일을 최소한만큼 뒤로 옮김.
+// seq 는 연결마다 0 부터 시작하므로 여러 Edge 의 트레이스를 함께 합칠 때는 --no-align 으로 벽시계만 사용.
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <string>
+#include <vector>
+
+struct TraceLine
+{
+    std::string text; // 원래 줄 (끝의 쉼표 제외)
+    std::string name;
+    double ts = 0.0; // us
+    double dur = 0.0;
+    long long seq = -1;
+    bool hasTs = false;
+};
+
+struct TraceFile
+{
+    std::string path;
+    std::string process;
+    long long epochNs = 0;
+    std::vector<TraceLine> lines;
+    double shiftUs = 0.0;
+};
+
+static void printUsage(const char *program)
+{
+    std::cerr << "Usage: " << program << " OUTPUT INPUT... [--no-align] [--send NAME] [--recv NAME]" << std::endl;
+}
+
+// "key":값 형태에서 값의 시작 위치 (없으면 npos)
+static size_t findValue(const std::string &line, const char *key)
+{
+    std::string pattern = std::string("\"") + key + "\":";
+    size_t pos = line.find(pattern);
+    return pos == std::string::npos ? pos : pos + pattern.size();
+}
+
+static std::string stringValue(const std::string &line, const char *key)
+{
+    size_t pos = findValue(line, key);
+    if (pos == std::string::npos || pos >= line.size() || line[pos] != '"')
+        return std::string();
+    size_t end = line.find('"', pos + 1);
+    return end == std::string::npos ? std::string() : line.substr(pos + 1, end - pos - 1);
+}
+
+static bool loadTrace(const std::string &path, TraceFile &trace)
+{
+    std::ifstream in(path);
+    if (!in)
+    {
+        std::cerr << "Failed to open trace " << path << std::endl;
+        return false;
+    }
+    trace.path = path;
+    std::string line;
+    while (std::getline(in, line))
+    {
+        if (line.compare(0, 13, "\"otherData\":{") == 0)
+        {
+            trace.process = stringValue(line, "process");
+            size_t pos = findValue(line, "epochNs");
+            if (pos != std::string::npos)
+                trace.epochNs = std::atoll(line.c_str() + pos);
+            continue;
+        }
+        if (line.compare(0, 9, "{\"name\":\"") != 0)
+            continue; // 머리 / 꼬리 줄
+        if (!line.empty() && line.back() == ',')
+            line.pop_back();
+
+        TraceLine event;
+        event.text = line;
+        event.name = stringValue(line, "name");
+        size_t pos = findValue(line, "ts");
+        if (pos != std::string::npos)
+        {
+            event.hasTs = true;
+            event.ts = std::atof(line.c_str() + pos);
+        }
+        if ((pos = findValue(line, "dur")) != std::string::npos)
+            event.dur = std::atof(line.c_str() + pos);
+        if ((pos = findValue(line, "seq")) != std::string::npos)
+            event.seq = std::atoll(line.c_str() + pos);
+        trace.lines.push_back(std::move(event));
+    }
+    if (trace.epochNs == 0)
+    {
+        std::cerr << "Trace " << path << " has no otherData.epochNs (not written by trace.h?)" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// 숫자 값 하나를 바꿔 씀
+static void replaceNumber(std::string &line, const char *key, const std::string &value)
+{
+    size_t pos = findValue(line, key);
+    if (pos == std::string::npos)
+        return;
+    size_t end = line.find_first_of(",}", pos);
+    line.replace(pos, end - pos, value);
+}
+
+int main(int argc, char *argv[])
+{
+    std::string outputPath;
+    std::vector<std::string> inputs;
+    bool align = true;
+    std::string sendName = "socket_write";
+    std::string recvName = "read";
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        if (arg == "--no-align")
+            align = false;
+        else if (arg == "--send" && i + 1 < argc)
+            sendName = argv[++i];
+        else if (arg == "--recv" && i + 1 < argc)
+            recvName = argv[++i];
+        else if (!arg.empty() && arg[0] != '-')
+        {
+            if (outputPath.empty())
+                outputPath = arg;
+            else
+                inputs.push_back(arg);
+        }
+        else
+        {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+    if (outputPath.empty() || inputs.empty())
+    {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    std::vector<TraceFile> traces(inputs.size());
+    for (size_t i = 0; i < inputs.size(); ++i)
+    {
+        if (!loadTrace(inputs[i], traces[i]))
+            return 1;
+    }
+
+    // 벽시계 기준 정렬: 가장 먼저 시작한 파일이 0
+    long long originNs = traces[0].epochNs;
+    for (const TraceFile &trace : traces)
+        originNs = std::min(originNs, trace.epochNs);
+    for (TraceFile &trace : traces)
+        trace.shiftUs = (trace.epochNs - originNs) / 1000.0;
+
+    // seq 로 짝지은 전송 / 수신의 인과 관계로 시계 차이 보정 (수신 끝이 전송 시작보다 앞서면 안 됨)
+    if (align && traces.size() > 1)
+    {
+        std::map<long long, double> sendStart;
+        for (const TraceLine &event : traces[0].lines)
+        {
+            if (event.hasTs && event.seq >= 0 && event.name == sendName && !sendStart.count(event.seq))
+                sendStart[event.seq] = event.ts + traces[0].shiftUs;
+        }
+        for (size_t i = 1; i < traces.size(); ++i)
+        {
+            size_t matched = 0;
+            double violation = -std::numeric_limits<double>::infinity();
+            for (const TraceLine &event : traces[i].lines)
+            {
+                auto it = event.seq >= 0 && event.name == recvName ? sendStart.find(event.seq) : sendStart.end();
+                if (!event.hasTs || it == sendStart.end())
+                    continue;
+                ++matched;
+                violation = std::max(violation, it->second - (event.ts + event.dur + traces[i].shiftUs));
+            }
+            if (matched > 0 && violation > 0)
+                traces[i].shiftUs += violation;
+            printf("%s (%s): %zu frames matched by seq, clock shift %+.3f ms\n", traces[i].path.c_str(),
+                   traces[i].process.c_str(), matched, matched > 0 && violation > 0 ? violation / 1000 : 0.0);
+        }
+    }
+
+    std::ofstream out(outputPath, std::ios::trunc);
+    if (!out)
+    {
+        std::cerr << "Failed to write " << outputPath << std::endl;
+        return 1;
+    }
+    out << "{\"traceEvents\":[\n";
+    bool first = true;
+    size_t events = 0;
+    char number[64];
+    for (size_t i = 0; i < traces.size(); ++i)
+    {
+        for (TraceLine &event : traces[i].lines)
+        {
+            replaceNumber(event.text, "pid", std::to_string(i + 1));
+            if (event.hasTs)
+            {
+                std::snprintf(number, sizeof(number), "%.3f", event.ts + traces[i].shiftUs);
+                replaceNumber(event.text, "ts", number);
+                ++events;
+            }
+            out << (first ? "" : ",\n") << event.text;
+            first = false;
+        }
+    }
+    out << "\n],\n\"displayTimeUnit\":\"ns\",\n\"otherData\":{\"epochNs\":" << originNs << "}}\n";
+    printf("Merged %zu events from %zu traces into %s\n", events, traces.size(), outputPath.c_str());
+    return 0;
+}
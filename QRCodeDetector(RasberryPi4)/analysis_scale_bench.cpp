@@ -0,0 +1,217 @@
+// 분석 해상도 벤치마크: 원본 해상도 vs 풀링한 에지에서 직선 검출 (image_ops.h) 의 속도 / 정확도
+//
+// 사용법: analysis_scale_bench [--frames N] [--warmup N] [--image PATH] [--width W] [--height H]
+//                              [--boxes N] [--rho-tol PX] [--theta-tol DEG]
+// analyzeFrameResults 를 levels 0(원본) ~ ANALYSIS_MAX_LEVELS 로 돌려 프레임 지연(p50/p99)을 재고, 원본 해상도 결과를 기준으로
+//   - 직선: 재현율(기준 직선 중 찾은 비율) / 정밀도(찾은 직선 중 기준에 있는 비율). |drho| <= rho-tol 이고 |dtheta| <= theta-tol 이면 같은 직선
+//   - 사각형: 면적 큰 순 기준 boxes 개 중 IoU 0.5 이상으로 맞는 사각형이 있는 비율, 맞은 사각형의 평균 모서리 오차(px)
+// 를 보고함. 축소 분석 결과는 이미 원본 좌표로 환산된 값이므로 그대로 비교함.
+// 이미지는 --image 가 없으면 합성 건물 장면 (사각형 + 직선 + 잡음).
+
+#include <opencv2/opencv.hpp>
+#include "image_ops.h"
+#include "metrics.h"
+
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+#include <string>
+
+static void printUsage(const char *program)
+{
+    std::cerr << "Usage: " << program << " [--frames N] [--warmup N] [--image PATH] [--width W] [--height H]"
+              << " [--boxes N] [--rho-tol PX] [--theta-tol DEG]" << std::endl;
+}
+
+static cv::Mat syntheticScene(int width, int height)
+{
+    cv::Mat image(height, width, CV_8UC3, cv::Scalar(170, 170, 170));
+    cv::RNG rng(7);
+    for (int i = 0; i < 40; ++i)
+    {
+        cv::Point tl(rng.uniform(0, width), rng.uniform(0, height));
+        cv::Point br(tl.x + rng.uniform(20, width / 4), tl.y + rng.uniform(20, height / 4));
+        cv::rectangle(image, tl, br, cv::Scalar::all(rng.uniform(40, 230)), cv::FILLED);
+    }
+    for (int i = 0; i < 20; ++i)
+    {
+        cv::line(image, cv::Point(rng.uniform(0, width), 0), cv::Point(rng.uniform(0, width), height),
+                 cv::Scalar::all(rng.uniform(0, 80)), 2);
+    }
+    cv::Mat noise(image.size(), image.type());
+    cv::randn(noise, cv::Scalar::all(0), cv::Scalar::all(8));
+    cv::add(image, noise, image);
+    return image;
+}
+
+struct Tolerance
+{
+    double rho = 4.0;                 // px (원본 기준)
+    double theta = 2.0 * CV_PI / 180; // rad
+};
+
+// (rho, theta) 와 (-rho, theta - pi) 는 같은 직선이므로 theta 가 0 / pi 근처면 뒤집어서도 비교
+static bool sameLine(const LineResult &a, const LineResult &b, const Tolerance &tolerance)
+{
+    if (std::abs(a.rho - b.rho) <= tolerance.rho && std::abs(a.theta - b.theta) <= tolerance.theta)
+        return true;
+    return std::abs(a.rho + b.rho) <= tolerance.rho && std::abs(std::abs(a.theta - b.theta) - CV_PI) <= tolerance.theta;
+}
+
+// from 의 직선 중 to 에 같은 직선이 있는 비율 (from 이 비었으면 1)
+static double lineMatchRate(const std::vector<LineResult> &from, const std::vector<LineResult> &to, const Tolerance &tolerance)
+{
+    if (from.empty())
+        return 1.0;
+    size_t matched = 0;
+    for (const LineResult &line : from)
+    {
+        for (const LineResult &other : to)
+        {
+            if (sameLine(line, other, tolerance))
+            {
+                ++matched;
+                break;
+            }
+        }
+    }
+    return static_cast<double>(matched) / from.size();
+}
+
+static cv::Rect toRect(const BoxResult &box)
+{
+    return cv::Rect(box.x, box.y, box.width, box.height);
+}
+
+struct BoxMatch
+{
+    double rate = 1.0;        // 기준 사각형 중 IoU >= 0.5 로 맞는 비율
+    double cornerError = 0.0; // 맞은 사각형의 평균 모서리 오차 (px)
+};
+
+static BoxMatch boxMatch(const std::vector<BoxResult> &reference, const std::vector<BoxResult> &candidate, size_t count)
+{
+    BoxMatch match;
+    count = std::min(count, reference.size()); // 둘 다 면적 큰 순
+    if (count == 0)
+        return match;
+    size_t matched = 0;
+    double error = 0.0;
+    for (size_t i = 0; i < count; ++i)
+    {
+        cv::Rect ref = toRect(reference[i]);
+        double bestIou = 0.0;
+        cv::Rect best;
+        for (const BoxResult &box : candidate)
+        {
+            cv::Rect rect = toRect(box);
+            double inter = (ref & rect).area();
+            double iou = inter / (ref.area() + rect.area() - inter);
+            if (iou > bestIou)
+            {
+                bestIou = iou;
+                best = rect;
+            }
+        }
+        if (bestIou >= 0.5)
+        {
+            ++matched;
+            error += (std::abs(ref.x - best.x) + std::abs(ref.y - best.y) + std::abs(ref.br().x - best.br().x) +
+                      std::abs(ref.br().y - best.br().y)) / 4.0;
+        }
+    }
+    match.rate = static_cast<double>(matched) / count;
+    match.cornerError = matched ? error / matched : 0.0;
+    return match;
+}
+
+int main(int argc, char *argv[])
+{
+    int frames = 50;
+    int warmup = 3;
+    int width = 1280;
+    int height = 720;
+    size_t boxCount = 32;
+    Tolerance tolerance;
+    std::string imagePath;
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        if (i + 1 >= argc)
+        {
+            printUsage(argv[0]);
+            return 1;
+        }
+        std::string value = argv[++i];
+
+        if (arg == "--frames")
+            frames = std::max(1, std::stoi(value));
+        else if (arg == "--warmup")
+            warmup = std::max(0, std::stoi(value));
+        else if (arg == "--image")
+            imagePath = value;
+        else if (arg == "--width")
+            width = std::max(64, std::stoi(value));
+        else if (arg == "--height")
+            height = std::max(64, std::stoi(value));
+        else if (arg == "--boxes")
+            boxCount = static_cast<size_t>(std::max(1, std::stoi(value)));
+        else if (arg == "--rho-tol")
+            tolerance.rho = std::max(0.0, std::stod(value));
+        else if (arg == "--theta-tol")
+            tolerance.theta = std::max(0.0, std::stod(value)) * CV_PI / 180;
+        else
+        {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    cv::Mat image = imagePath.empty() ? syntheticScene(width, height) : cv::imread(imagePath);
+    if (image.empty())
+    {
+        std::cerr << "Failed to load image from " << imagePath << std::endl;
+        return 1;
+    }
+
+    static const char *names[] = {"full", "half"};
+    FrameResults reference;
+    double fullP50 = 0.0;
+
+    printf("===== Analysis scale benchmark report =====\n");
+    printf("image     : %dx%d, %d frames (+%d warmup), line tol %.1f px / %.1f deg, top %zu boxes\n", image.cols,
+           image.rows, frames, warmup, tolerance.rho, tolerance.theta * 180 / CV_PI, boxCount);
+    for (int levels = 0; levels <= ANALYSIS_MAX_LEVELS; ++levels)
+    {
+        Histogram latency(std::string("analysis_scale_bench_") + names[levels] + "_ns", "", "");
+        FrameResults results;
+        for (int i = 0; i < warmup + frames; ++i)
+        {
+            uint64_t startNs = metricsNowNs();
+            analyzeFrameResults(image, results, 256, 64, levels);
+            if (i >= warmup)
+            {
+                latency.record(metricsNowNs() - startNs);
+            }
+        }
+        if (levels == 0)
+        {
+            reference = results;
+        }
+
+        Histogram::Snapshot snapshot = latency.snapshot();
+        double p50 = snapshot.quantile(0.5);
+        if (levels == 0)
+        {
+            fullP50 = p50;
+        }
+        BoxMatch boxes = boxMatch(reference.boxes, results.boxes, boxCount);
+        printf("%-10s: p50 %.2f ms, p99 %.2f ms (x%.1f), lines %zu recall %.0f%% precision %.0f%%, "
+               "boxes %zu match %.0f%% corner err %.1f px\n",
+               names[levels], p50 / 1e6, snapshot.quantile(0.99) / 1e6, p50 > 0 ? fullP50 / p50 : 0.0,
+               results.lines.size(), lineMatchRate(reference.lines, results.lines, tolerance) * 100,
+               lineMatchRate(results.lines, reference.lines, tolerance) * 100, results.boxes.size(), boxes.rate * 100,
+               boxes.cornerError);
+    }
+    return 0;
+}
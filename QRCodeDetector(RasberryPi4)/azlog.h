@@ -17,10 +17,14 @@
 #include <vector>        // 벡터 사용
 #include <unordered_set> // 중복 제거를 위한 집합 사용
 #include <sys/stat.h>    // 디렉토리 생성 및 확인용 헤더
+#include <algorithm>     // std::min 사용
 #include "scan_result.h"
 
 #define MAX_ENAME 133                                               // errno 배열의 최대 크기 정의
+// 기본 로그 디렉토리. 실행 시 AZLOG_DIR 환경 변수나 AzSinkManager::configure 로 변경 가능
+#ifndef RESOURCE_PATH
 #define RESOURCE_PATH "/home/azabell/Desktop/QRCodeDetector/output" // 리소스 경로 정의
+#endif
 
 // 로그 레벨 정의
 #define AZLOGD_LEVEL_NONE 0    // 로그 없음
@@ -339,11 +343,47 @@ static inline void ensureDirectoryExists(const std::string &dirPath)
     }
 }
 
+// 타임스탬프 (단조 시계 + 벽시계 기준점, 초 단위 문자열 캐시, 마이크로초)
+#include "azlog_time.h"
+// 로그 파일 싱크 (디렉토리 확인 1회, 파일별 핸들 유지, 교체/압축)
+#include "azlog_sink.h"
+// 스캔 결과 컨텍스트 (복사 없는 참조, 직렬화 캐시, JSON lines)
+#include "azlog_context.h"
+// 비동기 백엔드 (AzAsyncLogger::instance().start() 호출 후 활성화)
+#include "azlog_async.h"
+// 바이너리 백엔드 (AzBinaryLogger::instance().start() 호출 후 활성화, azlog_decode 로 텍스트 변환)
+#include "azlog_binary.h"
+
+// 실행 중 레벨 제어 (전역/파일별, SIGHUP 설정 다시 읽기, SIGUSR1/2 레벨 변경)
+#include "azlog_level.h"
+
+// 레벨 매크로 공통 본체
+// 꺼진 레벨은 relaxed load 한 번과 분기로 끝나고 인자는 평가하지 않음.
+// 켜진 레벨은 바이너리 모드면 호출 지점을 한 번만 등록하고 인자 원시 바이트만 기록, 아니면 AZLOG_ (비동기/동기) 경로
+#define AZLOGD_EMIT_(levelValue, level, format_str, locationLogUrl, scanResults, ...)                             \
+    do                                                                                                            \
+    {                                                                                                             \
+        static AzLevelSite azlogLevelSite_;                                                                       \
+        if (AzLogLevels::maxLevel() >= levelValue &&                                                              \
+            AzLogLevels::instance().enabled(levelValue, locationLogUrl, azlogLevelSite_))                         \
+        {                                                                                                         \
+            if (AzBinaryLogger::active())                                                                         \
+            {                                                                                                     \
+                static AzBinarySite azlogSite_(level, __func__, __LINE__, locationLogUrl, format_str);            \
+                AzBinaryLogger::instance().log(azlogSite_, scanResults, ##__VA_ARGS__);                           \
+            }                                                                                                     \
+            else                                                                                                  \
+            {                                                                                                     \
+                AZLOG_(level, __func__, __LINE__, locationLogUrl, scanResults, format_str, ##__VA_ARGS__);        \
+            }                                                                                                     \
+        }                                                                                                         \
+    } while (0)
+
 // 로그 매크로 정의
 #if AZLOGD_LEVEL >= AZLOGD_LEVEL_INFO
 #define AZLOGDI(format_str, locationLogUrl, scanResults, ...) \
-    COUT_("INFO", __func__, __LINE__, format_str, locationLogUrl, scanResults, ##__VA_ARGS__)
-// AZLOGD_LEVEL이 INFO(3) 이상일 경우, COUT_ 함수 호출. 로그 레벨은 "INFO"로 지정.
+    AZLOGD_EMIT_(AZLOGD_LEVEL_INFO, "INFO", format_str, locationLogUrl, scanResults, ##__VA_ARGS__)
+// AZLOGD_LEVEL이 INFO(3) 이상일 경우, AZLOGD_EMIT_ 호출. 로그 레벨은 "INFO"로 지정.
 // __func__는 현재 함수 이름, __LINE__은 현재 코드 줄 번호를 전달.
 // format_str: 출력할 문자열 형식
 // locationLogUrl: 로그 파일 경로
@@ -354,56 +394,50 @@ static inline void ensureDirectoryExists(const std::string &dirPath)
 
 #if AZLOGD_LEVEL >= AZLOGD_LEVEL_DEBUG
 #define AZLOGDD(format_str, locationLogUrl, scanResults, ...) \
-    COUT_("DEBUG", __func__, __LINE__, format_str, locationLogUrl, scanResults, ##__VA_ARGS__)
-// AZLOGD_LEVEL이 DEBUG(4) 이상일 경우, COUT_ 함수 호출. 로그 레벨은 "DEBUG"로 지정.
+    AZLOGD_EMIT_(AZLOGD_LEVEL_DEBUG, "DEBUG", format_str, locationLogUrl, scanResults, ##__VA_ARGS__)
+// AZLOGD_LEVEL이 DEBUG(4) 이상일 경우, AZLOGD_EMIT_ 호출. 로그 레벨은 "DEBUG"로 지정.
 #else
 #define AZLOGDD(format_str, locationLogUrl, scanResults, ...) (void)0 // 로그 비활성화
 #endif
 
 #if AZLOGD_LEVEL >= AZLOGD_LEVEL_WARNING
 #define AZLOGDW(format_str, locationLogUrl, scanResults, ...) \
-    COUT_("WARNING", __func__, __LINE__, format_str, locationLogUrl, scanResults, ##__VA_ARGS__)
-// AZLOGD_LEVEL이 WARNING(2) 이상일 경우, COUT_ 함수 호출. 로그 레벨은 "WARNING"으로 지정.
+    AZLOGD_EMIT_(AZLOGD_LEVEL_WARNING, "WARNING", format_str, locationLogUrl, scanResults, ##__VA_ARGS__)
+// AZLOGD_LEVEL이 WARNING(2) 이상일 경우, AZLOGD_EMIT_ 호출. 로그 레벨은 "WARNING"으로 지정.
 #else
 #define AZLOGDW(format_str, locationLogUrl, scanResults, ...) (void)0 // 로그 비활성화
 #endif
 
 #if AZLOGD_LEVEL >= AZLOGD_LEVEL_ERROR
 #define AZLOGDE(format_str, locationLogUrl, scanResults, ...) \
-    COUT_("ERROR", __func__, __LINE__, format_str, locationLogUrl, scanResults, ##__VA_ARGS__)
-// AZLOGD_LEVEL이 ERROR(1) 이상일 경우, COUT_ 함수 호출. 로그 레벨은 "ERROR"로 지정.
+    AZLOGD_EMIT_(AZLOGD_LEVEL_ERROR, "ERROR", format_str, locationLogUrl, scanResults, ##__VA_ARGS__)
+// AZLOGD_LEVEL이 ERROR(1) 이상일 경우, AZLOGD_EMIT_ 호출. 로그 레벨은 "ERROR"로 지정.
 #else
 #define AZLOGDE(format_str, locationLogUrl, scanResults, ...) (void)0 // 로그 비활성화
 #endif
 
-// COUT_ 함수 정의
-static inline void COUT_(std::string log_level, std::string function, int line, const char *format_str, const std::string &locationLogUrl, std::vector<ScanResult> scanResults, ...)
+// VCOUT_ 함수 정의 (동기 경로: 호출 스레드에서 포맷팅 후 콘솔과 파일에 직접 기록)
+static inline void VCOUT_(std::string log_level, std::string function, int line, const char *format_str, const std::string &locationLogUrl, const AzScanContextRef &scanResults, va_list ap)
 {
-    // 가변 인수 처리
-    va_list ap;                                                    // 가변 인수를 처리하기 위한 변수 선언
     char buf[AZLOGD_BUF_SIZE];                                     // 로그 메시지를 임시 저장할 버퍼 선언
-    va_start(ap, scanResults);                                     // 가변 인수 초기화
     size_t size = vsnprintf(buf, AZLOGD_BUF_SIZE, format_str, ap); // 버퍼에 포맷팅된 문자열 저장
-    va_end(ap);                                                    // 가변 인수 종료
+    size = std::min(size, static_cast<size_t>(AZLOGD_BUF_SIZE - 1));
 
     std::string dst(buf, buf + size); // 문자열로 변환
 
-    CURRENT_T current;
-    getCurrentTime(&current); // 현재 시간 가져오기
+    AzTimestamp now = AzClock::now(); // 현재 시간 가져오기 (마이크로초 단위)
+    char timeText[40];
+    size_t timeLength = az_formatTimestamp(timeText, now.wallNs);
 
     static std::mutex coutWriteMutex; // 쓰레드 동기화를 위한 뮤텍스 선언
 
-    std::string logDir = std::string(RESOURCE_PATH);      // 로그 디렉토리 경로 설정
-    std::string filePath = logDir + "/" + locationLogUrl; // 로그 파일 경로 설정
-
-    ensureDirectoryExists(logDir); // 로그 디렉토리 존재 확인 및 생성
-
     {
         std::lock_guard<std::mutex> lock(coutWriteMutex); // 동기화 블록 시작
 
         std::ostringstream rowBuilder; // 로그 메시지를 작성할 스트림
-        rowBuilder << "[" << current.year << "/" << current.month << "/" << current.day << " "
-                   << current.hour << ":" << current.minute << ":" << current.second << "] "
+        rowBuilder << "[";
+        rowBuilder.write(timeText, timeLength);
+        rowBuilder << "] "
                    << log_level << " (" << function << ":" << line << ") - " << dst;
 
         // errno가 설정된 경우, 오류 정보 추가
@@ -412,40 +446,58 @@ static inline void COUT_(std::string log_level, std::string function, int line,
             rowBuilder << " [errno: " << errno << " - " << ename[errno] << "]";
         }
 
-        // ScanResult 처리
-        if (!scanResults.empty())
-        {
-            rowBuilder << " [ScanResults: ";
-            for (const auto &result : scanResults)
-            {
-                rowBuilder << "HubId=" << result.hubId << ". Logs=";
-                for (const auto &entry : result.logList)
-                {
-                    // UUID 값을 형식에 맞게 변환 후 추가
-                    rowBuilder << az_plusflag(entry.uuid, '+', 6, "%+06d") << " ";
-                }
-                rowBuilder << "; ";
-            }
-            rowBuilder << "]";
-        }
+        // ScanResult 처리 (AzScanContext 로 넘어온 경우 캐시된 문자열 사용)
+        char scanText[AZLOGD_BUF_SIZE];
+        size_t scanLength = scanResults.appendText(scanText, sizeof(scanText), 0);
+        rowBuilder.write(scanText, scanLength);
         rowBuilder << "\n"; // 로그 메시지 끝에 줄바꿈 추가
 
         // 콘솔에 로그 출력
         std::cout << rowBuilder.str();
 
-        // 파일에 로그 기록
-        std::ofstream outFile(filePath, std::ios::app); // 로그 파일을 추가 모드로 엶
-        errno = 0;                                      // errno 초기화
-        if (!outFile.is_open())                         // 파일 열기에 실패한 경우
+        // 파일에 로그 기록 (열어 둔 핸들 재사용, 동기 경로이므로 줄마다 flush)
+        AzSinkManager &sinks = AzSinkManager::instance();
+        if (sinks.jsonLines())
         {
-            std::cerr << "Failed to open log file: " << filePath << " [errno: " << errno << " - " << ename[errno] << "]" << std::endl;
+            std::string row;
+            scanLength = scanResults.appendJson(scanText, sizeof(scanText), 0);
+            az_formatJsonRow(row, now.wallNs, log_level.c_str(), function.c_str(), line, dst.data(), dst.size(), errno, scanText, scanLength);
+            sinks.write(locationLogUrl, row);
         }
         else
         {
-            outFile << rowBuilder.str(); // 파일에 로그 메시지 작성
-            outFile.close();             // 파일 닫기
+            sinks.write(locationLogUrl, rowBuilder.str());
         }
+        sinks.flush(locationLogUrl);
+        errno = 0; // errno 초기화
+    }
+}
+
+// COUT_ 함수 정의 (기존 동기 경로 진입점)
+static inline void COUT_(std::string log_level, std::string function, int line, const char *format_str, const std::string &locationLogUrl, AzScanContextRef scanResults, ...)
+{
+    va_list ap;                // 가변 인수를 처리하기 위한 변수 선언
+    va_start(ap, scanResults); // 가변 인수 초기화
+    VCOUT_(log_level, function, line, format_str, locationLogUrl, scanResults, ap);
+    va_end(ap); // 가변 인수 종료
+}
+
+// AZLOG_ 함수 정의 (로그 매크로 진입점)
+// 비동기 백엔드가 실행 중이면 링 버퍼에 기록만 하고 반환, 아니면 동기 경로로 처리
+static inline void AZLOG_(const char *log_level, const char *function, int line, const std::string &locationLogUrl, const AzScanContextRef &scanResults, const char *format_str, ...)
+{
+    va_list ap;
+    va_start(ap, format_str);
+    AzAsyncLogger &asyncLogger = AzAsyncLogger::instance();
+    if (asyncLogger.running())
+    {
+        asyncLogger.enqueue(log_level, function, line, locationLogUrl, scanResults, format_str, ap);
+    }
+    else
+    {
+        VCOUT_(log_level, function, line, format_str, locationLogUrl, scanResults, ap);
     }
+    va_end(ap);
 }
 
-#endif // _AZLOGD_H_
\ No newline at end of file
+#endif // _AZLOGD_H_
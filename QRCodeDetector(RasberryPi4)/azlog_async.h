@@ -0,0 +1,355 @@
+#ifndef _AZLOGD_ASYNC_H_
+#define _AZLOGD_ASYNC_H_
+
+// azlog 비동기 백엔드
+// azlog.h 내부에서 포함됨 (ename, AzSinkManager 사용)
+//
+// 호출 스레드는 고정 크기 레코드를 lock-free MPSC 링 버퍼에 기록만 하고 즉시 반환.
+// 백그라운드 스레드가 레코드를 모아서 AzSinkManager 의 파일 핸들과 콘솔에 일괄 기록함.
+
+#include <atomic>
+#include <condition_variable>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#define AZLOGD_ASYNC_FILE_MAX 64   // 레코드에 저장하는 로그 파일 이름 최대 길이
+#define AZLOGD_ASYNC_TEXT_MAX 896  // 레코드 메시지 최대 길이 (초과분은 잘림)
+
+// 링 버퍼가 가득 찼을 때의 처리 정책
+enum class AzOverflowPolicy
+{
+    Block, // 공간이 생길 때까지 호출 스레드가 대기 (로그 유실 없음)
+    Drop,  // 새 레코드를 버리고 개수만 집계 (호출 스레드 지연 없음)
+};
+
+struct AzAsyncConfig
+{
+    size_t capacity = 4096;                                      // 레코드 수 (2의 거듭제곱으로 올림)
+    AzOverflowPolicy overflow = AzOverflowPolicy::Block;
+    std::chrono::milliseconds idleWait = std::chrono::milliseconds(20); // 기록할 레코드가 없을 때 대기 주기
+    bool console = true;                                         // 표준 출력에도 기록
+};
+
+// 링 버퍼 한 칸. sequence 로 생산자/소비자 소유권을 넘김
+struct AzLogRecord
+{
+    std::atomic<size_t> sequence{0};
+    const char *level;    // 문자열 리터럴
+    const char *function; // __func__ (정적 저장 기간)
+    int line;
+    int savedErrno;
+    uint64_t wallNs; // AzClock 기준 벽시계 시각 (마이크로초까지 표시)
+    uint16_t messageLength; // text 중 스캔 결과를 제외한 메시지 길이
+    uint16_t length;
+    bool json; // text 의 스캔 결과 부분이 JSON 배열인지
+    char file[AZLOGD_ASYNC_FILE_MAX];
+    char text[AZLOGD_ASYNC_TEXT_MAX];
+};
+
+// Vyukov 방식 bounded 큐를 MPSC 로 사용
+// 생산자는 head 에 대한 CAS 한 번으로 칸을 확보하고, 소비자는 단일 스레드이므로 tail 을 원자 연산 없이 관리
+class AzLogRing
+{
+public:
+    explicit AzLogRing(size_t capacity)
+    {
+        size_t size = 1;
+        while (size < capacity)
+        {
+            size <<= 1;
+        }
+        mask_ = size - 1;
+        slots_.reset(new AzLogRecord[size]);
+        for (size_t i = 0; i < size; ++i)
+        {
+            slots_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    // 기록할 칸 확보. 가득 찼으면 nullptr
+    AzLogRecord *tryClaim(size_t &position)
+    {
+        position = head_.load(std::memory_order_relaxed);
+        while (true)
+        {
+            AzLogRecord *slot = &slots_[position & mask_];
+            size_t sequence = slot->sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+            if (diff == 0)
+            {
+                if (head_.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                {
+                    return slot;
+                }
+            }
+            else if (diff < 0)
+            {
+                return nullptr;
+            }
+            else
+            {
+                position = head_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    void publish(AzLogRecord *slot, size_t position)
+    {
+        slot->sequence.store(position + 1, std::memory_order_release);
+    }
+
+    // 소비자 전용: 다음 레코드가 기록 완료되었으면 반환
+    AzLogRecord *front()
+    {
+        AzLogRecord *slot = &slots_[tail_ & mask_];
+        return slot->sequence.load(std::memory_order_acquire) == tail_ + 1 ? slot : nullptr;
+    }
+
+    void pop(AzLogRecord *slot)
+    {
+        slot->sequence.store(tail_ + mask_ + 1, std::memory_order_release);
+        ++tail_;
+    }
+
+    size_t claimed() const { return head_.load(std::memory_order_acquire); }
+    size_t consumed() const { return tail_; }
+
+private:
+    std::unique_ptr<AzLogRecord[]> slots_;
+    size_t mask_ = 0;
+    alignas(64) std::atomic<size_t> head_{0};
+    alignas(64) size_t tail_ = 0;
+};
+
+class AzAsyncLogger
+{
+public:
+    static AzAsyncLogger &instance()
+    {
+        static AzAsyncLogger logger;
+        return logger;
+    }
+
+    // 백그라운드 기록 스레드 시작. 로그 디렉토리는 여기서 한 번만 확인
+    void start(const AzAsyncConfig &config = AzAsyncConfig())
+    {
+        std::lock_guard<std::mutex> lock(controlMutex_);
+        if (running_.load(std::memory_order_relaxed))
+        {
+            return;
+        }
+
+        config_ = config;
+        ring_.reset(new AzLogRing(config.capacity));
+        AzSinkManager::instance().directory(); // 로그 디렉토리 확인은 기록 시작 전에 한 번만
+        stopping_ = false;
+        running_.store(true, std::memory_order_release);
+        worker_ = std::thread(&AzAsyncLogger::run, this);
+
+        // 정상 종료(exit / main 반환) 시 남은 레코드를 모두 기록
+        static bool atexitRegistered = false;
+        if (!atexitRegistered)
+        {
+            std::atexit([]
+                        { AzAsyncLogger::instance().stop(); });
+            atexitRegistered = true;
+        }
+    }
+
+    // 남은 레코드를 모두 기록하고 스레드 종료
+    void stop()
+    {
+        std::lock_guard<std::mutex> lock(controlMutex_);
+        if (!running_.load(std::memory_order_relaxed))
+        {
+            return;
+        }
+
+        // 이후 호출은 동기 경로로 처리됨
+        running_.store(false, std::memory_order_release);
+        {
+            std::lock_guard<std::mutex> wakeLock(wakeMutex_);
+            stopping_ = true;
+        }
+        wakeCv_.notify_one();
+        worker_.join();
+        flushFiles();
+    }
+
+    bool running() const { return running_.load(std::memory_order_acquire); }
+
+    // 호출 시점까지 기록된 레코드가 모두 파일에 반영될 때까지 대기
+    void flush()
+    {
+        if (!running())
+        {
+            return;
+        }
+        size_t target = ring_->claimed();
+        wakeCv_.notify_one();
+        std::unique_lock<std::mutex> lock(wakeMutex_);
+        flushedCv_.wait(lock, [this, target]
+                        { return flushed_ >= target || !running(); });
+    }
+
+    uint64_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+
+    // 레코드 하나를 링 버퍼에 기록. 정책이 Drop 이고 버퍼가 가득 찼으면 false
+    bool enqueue(const char *level, const char *function, int line, const std::string &locationLogUrl,
+                 const AzScanContextRef &scanResults, const char *format_str, va_list ap)
+    {
+        int savedErrno = errno;
+        size_t position;
+        AzLogRecord *slot = ring_->tryClaim(position);
+        while (!slot)
+        {
+            if (config_.overflow == AzOverflowPolicy::Drop)
+            {
+                wakeCv_.notify_one(); // 대기 중인 기록 스레드를 깨워 공간 확보
+                dropped_.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+            wakeCv_.notify_one();
+            std::this_thread::yield();
+            slot = ring_->tryClaim(position);
+        }
+
+        slot->level = level;
+        slot->function = function;
+        slot->line = line;
+        slot->savedErrno = savedErrno;
+        slot->wallNs = AzClock::now().wallNs;
+        snprintf(slot->file, sizeof(slot->file), "%s", locationLogUrl.c_str());
+
+        int written = vsnprintf(slot->text, sizeof(slot->text), format_str, ap);
+        size_t length = written < 0 ? 0 : std::min(sizeof(slot->text) - 1, static_cast<size_t>(written));
+        slot->messageLength = static_cast<uint16_t>(length);
+        // JSON lines 형식이면 스캔 결과를 JSON 배열로 저장 (형식은 기록 시점에 결정)
+        slot->json = AzSinkManager::instance().jsonLines();
+        length = slot->json ? scanResults.appendJson(slot->text, sizeof(slot->text), length)
+                            : scanResults.appendText(slot->text, sizeof(slot->text), length);
+        slot->length = static_cast<uint16_t>(length);
+
+        ring_->publish(slot, position);
+        return true;
+    }
+
+private:
+    AzAsyncLogger() = default;
+    ~AzAsyncLogger() { stop(); }
+
+    void run()
+    {
+        std::string row;
+        row.reserve(AZLOGD_ASYNC_TEXT_MAX + 256);
+        uint64_t reportedDrops = 0;
+
+        while (true)
+        {
+            bool wrote = false;
+            while (AzLogRecord *record = ring_->front())
+            {
+                formatRow(*record, row);
+                writeRow(record->file, row);
+                ring_->pop(record);
+                wrote = true;
+            }
+
+            uint64_t drops = dropped();
+            if (drops != reportedDrops)
+            {
+                row = "[azlog] " + std::to_string(drops - reportedDrops) + " log records dropped (ring buffer full)\n";
+                writeRow("error_log.txt", row);
+                reportedDrops = drops;
+                wrote = true;
+            }
+
+            // 한 묶음을 기록한 뒤에만 flush 하여 write 시스템 콜 횟수를 줄임
+            if (wrote)
+            {
+                flushFiles();
+            }
+
+            std::unique_lock<std::mutex> lock(wakeMutex_);
+            flushed_ = ring_->consumed();
+            flushedCv_.notify_all();
+            if (stopping_ && !ring_->front())
+            {
+                break;
+            }
+            if (!ring_->front())
+            {
+                wakeCv_.wait_for(lock, config_.idleWait);
+            }
+        }
+    }
+
+    static void formatRow(const AzLogRecord &record, std::string &row)
+    {
+        size_t messageLength = record.messageLength;
+        if (record.json)
+        {
+            az_formatJsonRow(row, record.wallNs, record.level, record.function, record.line, record.text, messageLength,
+                             record.savedErrno, record.text + messageLength, record.length - messageLength);
+            return;
+        }
+
+        // 날짜/시각 부분은 초 단위로 캐시된 문자열 재사용 (localtime_r 은 초가 바뀔 때만)
+        char prefix[256];
+        prefix[0] = '[';
+        size_t length = 1 + az_formatTimestamp(prefix + 1, record.wallNs);
+        int n = snprintf(prefix + length, sizeof(prefix) - length, "] %s (%s:%d) - ", record.level, record.function, record.line);
+        n = n > 0 ? static_cast<int>(length) + n : 0;
+        row.assign(prefix, n > 0 ? std::min(static_cast<size_t>(n), sizeof(prefix) - 1) : 0);
+
+        // 스캔 결과 앞에 errno 정보를 넣어 COUT_ 와 같은 순서 유지
+        row.append(record.text, messageLength);
+        if (record.savedErrno > 0 && record.savedErrno < MAX_ENAME)
+        {
+            row += " [errno: " + std::to_string(record.savedErrno) + " - " + ename[record.savedErrno] + "]";
+        }
+        row.append(record.text + messageLength, record.length - messageLength);
+        row += '\n';
+    }
+
+    void writeRow(const char *file, const std::string &row)
+    {
+        if (config_.console)
+        {
+            fwrite(row.data(), 1, row.size(), stdout);
+        }
+
+        AzSinkManager::instance().write(file, row);
+    }
+
+    void flushFiles()
+    {
+        if (config_.console)
+        {
+            fflush(stdout);
+        }
+        AzSinkManager::instance().flushAll();
+    }
+
+    AzAsyncConfig config_;
+    std::unique_ptr<AzLogRing> ring_;
+    std::atomic<bool> running_{false};
+    std::atomic<uint64_t> dropped_{0};
+
+    std::mutex controlMutex_; // start/stop 직렬화
+    std::mutex wakeMutex_;
+    std::condition_variable wakeCv_;
+    std::condition_variable flushedCv_;
+    bool stopping_ = false;
+    size_t flushed_ = 0;
+
+    std::thread worker_;
+};
+
+#endif // _AZLOGD_ASYNC_H_
@@ -0,0 +1,254 @@
+// azlog 멀티스레드 처리량 / 지연 벤치마크
+//
+// 1 ~ N 개 스레드에서 실제 edge_ble 와 비슷한 메시지를 AZLOGDI 로 기록하고 백엔드별로 비교함
+//   - sync    : 기존 동기 COUT_ 경로 (백엔드 시작 안 함)
+//   - async   : AzAsyncLogger (Block / Drop)
+//   - binary  : AzBinaryLogger (azlog.bin)
+// 각 백엔드를 스캔 결과 없이 / AzScanContext 를 붙여서 두 번씩 실행하고
+// 호출당 지연 분위수, 전체 처리량(기록 스레드가 파일에 다 쓸 때까지 포함), 버려진 레코드 수를 보고함.
+// 로그 파일은 --dir (기본 /tmp/azlog_bench) 에 기록되며, 콘솔 출력은 --console 을 주지 않으면 /dev/null 로 보냄.
+
+#include "azlog.h"
+#include "metrics.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+struct BenchConfig
+{
+    int maxThreads = 4;                // 1, 2, 4, ... maxThreads 로 실행
+    int recordsPerThread = 100000;
+    std::string directory = "/tmp/azlog_bench";
+    bool console = false;              // 동기 경로의 표준 출력을 그대로 둘지
+    std::vector<std::string> backends = {"sync", "async-block", "async-drop", "binary"};
+};
+
+struct BenchResult
+{
+    std::string backend;
+    int threads;
+    bool withContext;
+    uint64_t records;
+    double elapsedSec;
+    uint64_t dropped;
+    Histogram::Snapshot latency;
+};
+
+static std::vector<ScanResult> sampleScanResults()
+{
+    return {{"Hub_1234", {{"Server_1", 12345}, {"Server_2", 23456}, {"Server_3", 34567}}},
+            {"Hub_5678", {{"Server_1", 45678}}}};
+}
+
+static uint64_t droppedTotal()
+{
+    return AzAsyncLogger::instance().dropped() + AzBinaryLogger::instance().dropped();
+}
+
+static bool startBackend(const std::string &backend)
+{
+    if (backend == "async-block" || backend == "async-drop")
+    {
+        AzAsyncConfig config;
+        config.overflow = backend == "async-drop" ? AzOverflowPolicy::Drop : AzOverflowPolicy::Block;
+        config.console = false;
+        AzAsyncLogger::instance().start(config);
+    }
+    else if (backend == "binary")
+    {
+        return AzBinaryLogger::instance().start();
+    }
+    return backend == "sync" || backend == "async-block" || backend == "async-drop";
+}
+
+// 백엔드 정지 (남은 레코드를 모두 파일에 쓰고 반환)
+static void stopBackend(const std::string &backend)
+{
+    if (backend == "binary")
+    {
+        AzBinaryLogger::instance().stop();
+    }
+    else if (backend != "sync")
+    {
+        AzAsyncLogger::instance().stop();
+    }
+    AzSinkManager::instance().flushAll();
+}
+
+// 스레드 하나의 작업: edge_ble 의 전송/스캔 로그와 같은 형태의 메시지를 번갈아 기록
+static void logWorker(int index, int records, AzScanContext *context, Histogram &latency, std::atomic<int> &ready, const std::atomic<bool> &go)
+{
+    const std::vector<ScanResult> none;
+    std::string hubId = "Hub_" + std::to_string(1000 + index);
+    ready.fetch_add(1);
+    while (!go.load(std::memory_order_acquire))
+    {
+        std::this_thread::yield();
+    }
+
+    for (int i = 0; i < records; ++i)
+    {
+        uint64_t start = metricsNowNs();
+        if (context)
+        {
+            if (i % 2 == 0)
+                AZLOGDI("Sending image size: %d bytes (seq %d)", "info_log.txt", *context, 153600 + i % 4096, i);
+            else
+                AZLOGDI("HubId: %s, Logs Count: %d", "info_log.txt", *context, hubId.c_str(), i % 16);
+        }
+        else
+        {
+            if (i % 2 == 0)
+                AZLOGDI("Sending image size: %d bytes (seq %d)", "info_log.txt", none, 153600 + i % 4096, i);
+            else
+                AZLOGDI("HubId: %s, Logs Count: %d", "info_log.txt", none, hubId.c_str(), i % 16);
+        }
+        latency.record(metricsNowNs() - start);
+    }
+}
+
+static bool runOnce(const BenchConfig &config, const std::string &backend, int threads, bool withContext, BenchResult &result)
+{
+    if (!startBackend(backend))
+    {
+        return false;
+    }
+
+    AzScanContext context(sampleScanResults());
+    Histogram latency("azlog_bench_call_latency_ns", "backend=\"" + backend + "\"", "per-call latency");
+    std::atomic<int> ready{0};
+    std::atomic<bool> go{false};
+    uint64_t droppedBefore = droppedTotal();
+
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t)
+    {
+        workers.emplace_back(logWorker, t, config.recordsPerThread, withContext ? &context : nullptr,
+                             std::ref(latency), std::ref(ready), std::cref(go));
+    }
+    while (ready.load() < threads)
+    {
+        std::this_thread::yield();
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    go.store(true, std::memory_order_release);
+    for (auto &worker : workers)
+    {
+        worker.join();
+    }
+    stopBackend(backend);
+    auto end = std::chrono::steady_clock::now();
+
+    result.backend = backend;
+    result.threads = threads;
+    result.withContext = withContext;
+    result.records = static_cast<uint64_t>(threads) * config.recordsPerThread;
+    result.elapsedSec = std::chrono::duration<double>(end - start).count();
+    result.dropped = droppedTotal() - droppedBefore;
+    result.latency = latency.snapshot();
+    return true;
+}
+
+static void printReport(const BenchConfig &config, const std::vector<BenchResult> &results)
+{
+    auto us = [](uint64_t ns)
+    { return ns / 1000.0; };
+
+    std::cerr << "===== azlog benchmark report =====" << std::endl;
+    std::cerr << "records per thread: " << config.recordsPerThread << ", log dir " << config.directory << std::endl;
+    fprintf(stderr, "%-12s %7s %7s %12s %9s %9s %9s %9s %9s %9s\n",
+            "backend", "threads", "context", "records/s", "p50 us", "p90 us", "p99 us", "p999 us", "max us", "dropped");
+    for (const auto &r : results)
+    {
+        fprintf(stderr, "%-12s %7d %7s %12.0f %9.2f %9.2f %9.2f %9.2f %9.2f %9llu\n",
+                r.backend.c_str(), r.threads, r.withContext ? "yes" : "no", r.records / r.elapsedSec,
+                us(r.latency.quantile(0.5)), us(r.latency.quantile(0.9)), us(r.latency.quantile(0.99)),
+                us(r.latency.quantile(0.999)), us(r.latency.max), static_cast<unsigned long long>(r.dropped));
+    }
+}
+
+static void printUsage(const char *program)
+{
+    std::cerr << "Usage: " << program << " [--threads N] [--records N] [--dir DIR]"
+              << " [--backend sync|async-block|async-drop|binary|all] [--console 0|1]" << std::endl;
+}
+
+int main(int argc, char *argv[])
+{
+    BenchConfig config;
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        if (i + 1 >= argc)
+        {
+            printUsage(argv[0]);
+            return 1;
+        }
+        std::string value = argv[++i];
+
+        if (arg == "--threads")
+            config.maxThreads = std::max(1, std::stoi(value));
+        else if (arg == "--records")
+            config.recordsPerThread = std::max(1, std::stoi(value));
+        else if (arg == "--dir")
+            config.directory = value;
+        else if (arg == "--backend" && value != "all")
+            config.backends = {value};
+        else if (arg == "--backend")
+            continue;
+        else if (arg == "--console")
+            config.console = value == "1";
+        else
+        {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    ensureDirectoryExists(config.directory);
+    AzSinkConfig sink;
+    sink.directory = config.directory;
+    sink.compress = false;
+    AzSinkManager::instance().configure(sink);
+    AzLogLevels::instance().setGlobalLevel(AZLOGD_LEVEL_INFO);
+
+    // 동기 경로의 콘솔 출력이 터미널 속도를 재지 않도록 표준 출력은 버림 (보고서는 stderr)
+    if (!config.console && !freopen("/dev/null", "w", stdout))
+    {
+        std::cerr << "Failed to redirect stdout" << std::endl;
+    }
+
+    std::vector<BenchResult> results;
+    for (const auto &backend : config.backends)
+    {
+        for (int threads = 1;; threads = std::min(threads * 2, config.maxThreads))
+        {
+            for (bool withContext : {false, true})
+            {
+                BenchResult result;
+                if (!runOnce(config, backend, threads, withContext, result))
+                {
+                    std::cerr << "Unknown or failed backend: " << backend << std::endl;
+                    return 1;
+                }
+                results.push_back(result);
+                std::cerr << "." << std::flush;
+            }
+            if (threads == config.maxThreads)
+            {
+                break;
+            }
+        }
+    }
+    std::cerr << std::endl;
+
+    printReport(config, results);
+    return 0;
+}
@@ -0,0 +1,554 @@
+#ifndef _AZLOGD_BINARY_H_
+#define _AZLOGD_BINARY_H_
+
+// azlog 바이너리 로그 모드 (NanoLog 방식 지연 포맷팅)
+// azlog.h 내부에서 포함됨
+//
+// - 호출 지점(call site)의 포맷 문자열/함수/줄/파일은 최초 호출 시 한 번만 등록되어 정적 ID 를 받음
+// - 이후 호출은 ID + 타임스탬프 + 인자의 원시 바이트만 스레드별 버퍼에 복사 (포맷팅/락/시스템 콜 없음)
+// - 백그라운드 스레드가 스레드별 버퍼를 모아 바이너리 파일에 기록
+// - 텍스트 변환은 별도 도구(azlog_decode)가 나중에 수행
+//
+// 파일 구조 (호스트 바이트 오더, 리틀 엔디언 가정)
+//   파일 헤더 : "AZBL" | u32 버전 | u64 벽시계 기준(ns, CLOCK_REALTIME) | u64 단조 시계 기준(ns, steady_clock)
+//   엔트리    : u32 크기(헤더 포함) | u32 종류
+//               종류의 최상위 비트가 1 이면 호출 지점 사전 엔트리 (하위 비트 = ID)
+//                 level | function | u32 line | file | format | signature  (문자열은 u16 길이 + 바이트)
+//               종류가 0 이면 기준점 엔트리 (AzClock 이 기준점을 다시 잡았을 때, 이후 단조 시각에 적용)
+//                 u64 벽시계 기준(ns) | u64 단조 시계 기준(ns)
+//               아니면 로그 엔트리 (종류 = 호출 지점 ID)
+//                 u64 단조 시계(ns) | i32 errno | 인자 바이트... | 스캔 결과
+//   스캔 결과 : u16 개수 | (hubId 문자열 | u16 항목 수 | (serverId 문자열 | i32 uuid)...)...
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#define AZLOGD_BINARY_MAGIC "AZBL"
+#define AZLOGD_BINARY_VERSION 3
+#define AZLOGD_BINARY_SITE_FLAG 0x80000000u
+#define AZLOGD_BINARY_ANCHOR_KIND 0u // 호출 지점 ID 는 1 부터
+#define AZLOGD_BINARY_ENTRY_HEADER 20 // 크기 + 종류 + 타임스탬프 + errno
+
+// 인자 타입 시그니처 문자
+//   b/h/i/l : 1/2/4/8 바이트 부호 있는 정수, B/H/I/L : 부호 없는 정수
+//   d : double, s : 문자열 (u16 길이 + 바이트), p : 포인터 (8 바이트)
+template <class T, class Enable = void>
+struct AzArgCodec;
+
+template <class T>
+struct AzArgCodec<T, typename std::enable_if<std::is_integral<T>::value || std::is_enum<T>::value>::type>
+{
+    static char tag()
+    {
+        static const char tags[2][9] = {{0, 'B', 'H', 0, 'I', 0, 0, 0, 'L'}, {0, 'b', 'h', 0, 'i', 0, 0, 0, 'l'}};
+        return tags[std::is_signed<T>::value ? 1 : 0][sizeof(T)];
+    }
+    static size_t size(const T &) { return sizeof(T); }
+    static void write(char *&out, const T &value)
+    {
+        std::memcpy(out, &value, sizeof(T));
+        out += sizeof(T);
+    }
+};
+
+template <class T>
+struct AzArgCodec<T, typename std::enable_if<std::is_floating_point<T>::value>::type>
+{
+    static char tag() { return 'd'; }
+    static size_t size(const T &) { return sizeof(double); }
+    static void write(char *&out, const T &value)
+    {
+        double promoted = static_cast<double>(value); // 가변 인자와 같은 승격 규칙
+        std::memcpy(out, &promoted, sizeof(double));
+        out += sizeof(double);
+    }
+};
+
+static inline size_t az_binaryStringSize(size_t length)
+{
+    return 2 + std::min<size_t>(length, UINT16_MAX);
+}
+
+static inline void az_binaryWriteString(char *&out, const char *value, size_t length)
+{
+    uint16_t n = static_cast<uint16_t>(std::min<size_t>(length, UINT16_MAX));
+    std::memcpy(out, &n, 2);
+    std::memcpy(out + 2, value, n);
+    out += 2 + n;
+}
+
+template <class T>
+struct AzArgCodec<T, typename std::enable_if<std::is_same<typename std::decay<T>::type, char *>::value ||
+                                             std::is_same<typename std::decay<T>::type, const char *>::value>::type>
+{
+    static char tag() { return 's'; }
+    static size_t size(const char *value) { return az_binaryStringSize(value ? strlen(value) : 0); }
+    static void write(char *&out, const char *value) { az_binaryWriteString(out, value ? value : "", value ? strlen(value) : 0); }
+};
+
+template <>
+struct AzArgCodec<std::string>
+{
+    static char tag() { return 's'; }
+    static size_t size(const std::string &value) { return az_binaryStringSize(value.size()); }
+    static void write(char *&out, const std::string &value) { az_binaryWriteString(out, value.data(), value.size()); }
+};
+
+template <class T>
+struct AzArgCodec<T *, typename std::enable_if<!std::is_same<typename std::remove_cv<T>::type, char>::value>::type>
+{
+    static char tag() { return 'p'; }
+    static size_t size(T *const &) { return 8; }
+    static void write(char *&out, T *const &value)
+    {
+        uint64_t address = reinterpret_cast<uintptr_t>(value);
+        std::memcpy(out, &address, 8);
+        out += 8;
+    }
+};
+
+template <class T>
+using AzCodecOf = AzArgCodec<typename std::decay<T>::type>;
+
+// 호출 지점 정보. 매크로에서 함수 내 정적 객체로 만들어지며, ID 는 최초 기록 시 등록
+struct AzBinarySite
+{
+    AzBinarySite(const char *level, const char *function, int line, std::string file, const char *format)
+        : level(level), function(function), line(line), file(std::move(file)), format(format) {}
+
+    const char *level;
+    const char *function;
+    int line;
+    std::string file;
+    const char *format;
+    std::string signature;
+    std::atomic<uint32_t> id{0};
+};
+
+// 스레드 하나가 소유하는 SPSC 바이트 링 버퍼
+// 생산자(로그 호출 스레드)만 writePos 를, 소비자(기록 스레드)만 readPos 를 갱신
+struct AzStagingBuffer
+{
+    explicit AzStagingBuffer(size_t capacity) : data(new char[capacity]), capacity(capacity) {}
+
+    // n 바이트(8 의 배수)를 연속으로 쓸 공간 확보. 끝에 공간이 모자라면 크기 0 표시를 남기고 처음으로 감음
+    char *reserve(size_t n)
+    {
+        size_t write = writePos.load(std::memory_order_relaxed);
+        size_t offset = write % capacity;
+        size_t contiguous = capacity - offset;
+        size_t needed = contiguous < n ? contiguous + n : n;
+        if (write + needed - readPos.load(std::memory_order_acquire) > capacity)
+        {
+            return nullptr;
+        }
+        if (contiguous < n)
+        {
+            uint32_t wrap = 0;
+            std::memcpy(data.get() + offset, &wrap, 4);
+            write += contiguous;
+            writePos.store(write, std::memory_order_release);
+        }
+        return data.get() + write % capacity;
+    }
+
+    void commit(size_t n)
+    {
+        writePos.store(writePos.load(std::memory_order_relaxed) + n, std::memory_order_release);
+    }
+
+    std::unique_ptr<char[]> data;
+    const size_t capacity;
+    alignas(64) std::atomic<size_t> writePos{0};
+    alignas(64) std::atomic<size_t> readPos{0};
+    std::atomic<bool> retired{false}; // 소유 스레드 종료. 남은 데이터를 기록한 뒤 해제
+};
+
+struct AzBinaryConfig
+{
+    std::string path;                                                       // 비어 있으면 <로그 디렉토리>/azlog.bin
+    size_t threadBufferSize = 1 << 20;                                      // 스레드별 버퍼 크기 (8 의 배수)
+    AzOverflowPolicy overflow = AzOverflowPolicy::Drop;
+    std::chrono::milliseconds drainInterval = std::chrono::milliseconds(10); // 기록 스레드 수집 주기
+};
+
+class AzBinaryLogger
+{
+public:
+    static AzBinaryLogger &instance()
+    {
+        static AzBinaryLogger logger;
+        return logger;
+    }
+
+    // 매크로에서 호출하는 모드 확인 (relaxed load 한 번)
+    static bool active()
+    {
+        return activeFlag().load(std::memory_order_relaxed);
+    }
+
+    bool start(const AzBinaryConfig &config = AzBinaryConfig())
+    {
+        std::lock_guard<std::mutex> lock(controlMutex_);
+        if (active())
+        {
+            return true;
+        }
+
+        config_ = config;
+        config_.threadBufferSize = (std::max<size_t>(config.threadBufferSize, 4096) + 7) & ~size_t(7);
+        if (config_.path.empty())
+        {
+            config_.path = AzSinkManager::instance().path("azlog.bin");
+        }
+        file_ = fopen(config_.path.c_str(), "wb");
+        if (!file_)
+        {
+            std::cerr << "Failed to open binary log: " << config_.path << " [errno: " << errno << " - " << ename[errno] << "]" << std::endl;
+            return false;
+        }
+        setvbuf(file_, nullptr, _IOFBF, 1 << 16);
+        writeFileHeader();
+
+        writtenSites_ = 0;
+        stopping_ = false;
+        worker_ = std::thread(&AzBinaryLogger::run, this);
+        activeFlag().store(true, std::memory_order_release);
+
+        static bool atexitRegistered = false;
+        if (!atexitRegistered)
+        {
+            std::atexit([]
+                        { AzBinaryLogger::instance().stop(); });
+            atexitRegistered = true;
+        }
+        return true;
+    }
+
+    void stop()
+    {
+        std::lock_guard<std::mutex> lock(controlMutex_);
+        if (!active())
+        {
+            return;
+        }
+        activeFlag().store(false, std::memory_order_release);
+        {
+            std::lock_guard<std::mutex> wakeLock(wakeMutex_);
+            stopping_ = true;
+        }
+        wakeCv_.notify_one();
+        worker_.join();
+        fclose(file_);
+        file_ = nullptr;
+    }
+
+    uint64_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+
+    template <class... Args>
+    void log(AzBinarySite &site, const AzScanContextRef &scanContext, const Args &...args)
+    {
+        const std::vector<ScanResult> &scanResults = scanContext.results();
+        int savedErrno = errno;
+        uint32_t id = site.id.load(std::memory_order_acquire);
+        if (id == 0)
+        {
+            id = registerSite(site, std::string{AzCodecOf<Args>::tag()...});
+        }
+
+        size_t payload = argsSize(args...) + scanResultsSize(scanResults);
+        size_t total = (AZLOGD_BINARY_ENTRY_HEADER + payload + 7) & ~size_t(7);
+
+        AzStagingBuffer &buffer = localBuffer();
+        char *out = buffer.reserve(total);
+        while (!out)
+        {
+            if (config_.overflow == AzOverflowPolicy::Drop || total > buffer.capacity)
+            {
+                dropped_.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+            wakeCv_.notify_one();
+            std::this_thread::yield();
+            out = buffer.reserve(total);
+        }
+
+        uint32_t size32 = static_cast<uint32_t>(total);
+        uint64_t timestamp = AzClock::steadyNs();
+        int32_t err = savedErrno;
+        std::memcpy(out, &size32, 4);
+        std::memcpy(out + 4, &id, 4);
+        std::memcpy(out + 8, &timestamp, 8);
+        std::memcpy(out + 16, &err, 4);
+        char *cursor = out + AZLOGD_BINARY_ENTRY_HEADER;
+        writeArgs(cursor, args...);
+        writeScanResults(cursor, scanResults);
+
+        buffer.commit(total);
+    }
+
+private:
+    AzBinaryLogger() = default;
+    ~AzBinaryLogger() { stop(); }
+
+    static std::atomic<bool> &activeFlag()
+    {
+        static std::atomic<bool> flag{false};
+        return flag;
+    }
+
+    uint32_t registerSite(AzBinarySite &site, const std::string &signature)
+    {
+        std::lock_guard<std::mutex> lock(sitesMutex_);
+        uint32_t id = site.id.load(std::memory_order_relaxed);
+        if (id != 0)
+        {
+            return id;
+        }
+        site.signature = signature;
+        sites_.push_back(&site);
+        id = static_cast<uint32_t>(sites_.size()); // 0 은 미등록 표시로 사용
+        site.id.store(id, std::memory_order_release);
+        return id;
+    }
+
+    // 스레드별 버퍼. 스레드 종료 시 retired 표시만 하고 해제는 기록 스레드가 담당
+    AzStagingBuffer &localBuffer()
+    {
+        struct Handle
+        {
+            std::shared_ptr<AzStagingBuffer> buffer;
+            ~Handle()
+            {
+                if (buffer)
+                {
+                    buffer->retired.store(true, std::memory_order_release);
+                }
+            }
+        };
+        thread_local Handle handle;
+        if (!handle.buffer)
+        {
+            handle.buffer = std::make_shared<AzStagingBuffer>(config_.threadBufferSize);
+            std::lock_guard<std::mutex> lock(buffersMutex_);
+            buffers_.push_back(handle.buffer);
+        }
+        return *handle.buffer;
+    }
+
+    static size_t argsSize() { return 0; }
+    template <class T, class... Rest>
+    static size_t argsSize(const T &value, const Rest &...rest)
+    {
+        return AzCodecOf<T>::size(value) + argsSize(rest...);
+    }
+
+    static void writeArgs(char *&) {}
+    template <class T, class... Rest>
+    static void writeArgs(char *&out, const T &value, const Rest &...rest)
+    {
+        AzCodecOf<T>::write(out, value);
+        writeArgs(out, rest...);
+    }
+
+    static size_t scanResultsSize(const std::vector<ScanResult> &scanResults)
+    {
+        size_t size = 2;
+        for (const auto &result : scanResults)
+        {
+            size += az_binaryStringSize(result.hubId.size()) + 2;
+            size_t entries = std::min<size_t>(result.logList.size(), UINT16_MAX);
+            for (size_t j = 0; j < entries; ++j)
+            {
+                size += az_binaryStringSize(result.logList[j].serverId.size()) + 4;
+            }
+        }
+        return size;
+    }
+
+    static void writeScanResults(char *&out, const std::vector<ScanResult> &scanResults)
+    {
+        uint16_t count = static_cast<uint16_t>(std::min<size_t>(scanResults.size(), UINT16_MAX));
+        std::memcpy(out, &count, 2);
+        out += 2;
+        for (uint16_t i = 0; i < count; ++i)
+        {
+            const ScanResult &result = scanResults[i];
+            az_binaryWriteString(out, result.hubId.data(), result.hubId.size());
+            uint16_t entries = static_cast<uint16_t>(std::min<size_t>(result.logList.size(), UINT16_MAX));
+            std::memcpy(out, &entries, 2);
+            out += 2;
+            for (uint16_t j = 0; j < entries; ++j)
+            {
+                const Entry &entry = result.logList[j];
+                az_binaryWriteString(out, entry.serverId.data(), entry.serverId.size());
+                int32_t uuid = entry.uuid;
+                std::memcpy(out, &uuid, 4);
+                out += 4;
+            }
+        }
+    }
+
+    void writeFileHeader()
+    {
+        uint32_t version = AZLOGD_BINARY_VERSION;
+        // 텍스트 경로와 같은 기준점을 기록하여 디코딩한 시각이 일치하도록 함
+        AzTimestamp anchor = AzClock::currentAnchor();
+        fwrite(AZLOGD_BINARY_MAGIC, 1, 4, file_);
+        fwrite(&version, 4, 1, file_);
+        fwrite(&anchor.wallNs, 8, 1, file_);
+        fwrite(&anchor.steadyNs, 8, 1, file_);
+        writtenAnchorSteadyNs_ = anchor.steadyNs;
+    }
+
+    // 기준점이 다시 잡혔으면 기준점 엔트리 기록
+    void writeAnchorIfChanged()
+    {
+        AzClock::now(); // 텍스트 로그가 없어도 기록 주기마다 기준점 확인
+        AzTimestamp anchor = AzClock::currentAnchor();
+        if (anchor.steadyNs == writtenAnchorSteadyNs_)
+        {
+            return;
+        }
+        uint32_t entry[6] = {24, AZLOGD_BINARY_ANCHOR_KIND};
+        std::memcpy(&entry[2], &anchor.wallNs, 8);
+        std::memcpy(&entry[4], &anchor.steadyNs, 8);
+        fwrite(entry, 1, sizeof(entry), file_);
+        writtenAnchorSteadyNs_ = anchor.steadyNs;
+    }
+
+    static void appendString(std::string &out, const char *value, size_t length)
+    {
+        uint16_t n = static_cast<uint16_t>(std::min<size_t>(length, UINT16_MAX));
+        out.append(reinterpret_cast<const char *>(&n), 2);
+        out.append(value, n);
+    }
+
+    // 아직 파일에 쓰지 않은 호출 지점 사전 엔트리 기록
+    void writeNewSites()
+    {
+        std::lock_guard<std::mutex> lock(sitesMutex_);
+        std::string entry;
+        for (; writtenSites_ < sites_.size(); ++writtenSites_)
+        {
+            const AzBinarySite &site = *sites_[writtenSites_];
+            entry.assign(8, '\0');
+            appendString(entry, site.level, strlen(site.level));
+            appendString(entry, site.function, strlen(site.function));
+            uint32_t line = static_cast<uint32_t>(site.line);
+            entry.append(reinterpret_cast<const char *>(&line), 4);
+            appendString(entry, site.file.data(), site.file.size());
+            appendString(entry, site.format, strlen(site.format));
+            appendString(entry, site.signature.data(), site.signature.size());
+
+            uint32_t size = static_cast<uint32_t>(entry.size());
+            uint32_t kind = AZLOGD_BINARY_SITE_FLAG | static_cast<uint32_t>(writtenSites_ + 1);
+            std::memcpy(&entry[0], &size, 4);
+            std::memcpy(&entry[4], &kind, 4);
+            fwrite(entry.data(), 1, entry.size(), file_);
+        }
+    }
+
+    // 버퍼 하나의 데이터를 파일로 복사. 반환값: 기록한 바이트 수
+    size_t drainBuffer(AzStagingBuffer &buffer)
+    {
+        size_t read = buffer.readPos.load(std::memory_order_relaxed);
+        size_t write = buffer.writePos.load(std::memory_order_acquire);
+        size_t start = read;
+        while (read < write)
+        {
+            size_t offset = read % buffer.capacity;
+            uint32_t size;
+            std::memcpy(&size, buffer.data.get() + offset, 4);
+            if (size == 0)
+            {
+                read += buffer.capacity - offset; // 감기 표시
+                continue;
+            }
+            fwrite(buffer.data.get() + offset, 1, size, file_);
+            read += size;
+        }
+        buffer.readPos.store(read, std::memory_order_release);
+        return read - start;
+    }
+
+    void drainAll()
+    {
+        std::vector<std::shared_ptr<AzStagingBuffer>> buffers;
+        {
+            std::lock_guard<std::mutex> lock(buffersMutex_);
+            buffers = buffers_;
+        }
+
+        // 로그 엔트리보다 사전 엔트리가 먼저 오도록, 버퍼 목록을 얻은 뒤 등록된 호출 지점을 먼저 기록
+        writeNewSites();
+        writeAnchorIfChanged();
+        for (auto &buffer : buffers)
+        {
+            drainBuffer(*buffer);
+        }
+
+        // 종료된 스레드의 버퍼는 비운 뒤 해제
+        std::lock_guard<std::mutex> lock(buffersMutex_);
+        buffers_.erase(std::remove_if(buffers_.begin(), buffers_.end(), [](const std::shared_ptr<AzStagingBuffer> &buffer)
+                                      { return buffer->retired.load(std::memory_order_acquire) &&
+                                               buffer->readPos.load(std::memory_order_relaxed) == buffer->writePos.load(std::memory_order_acquire); }),
+                       buffers_.end());
+    }
+
+    void run()
+    {
+        uint64_t reportedDrops = 0;
+        while (true)
+        {
+            drainAll();
+            uint64_t drops = dropped();
+            if (drops != reportedDrops)
+            {
+                std::cerr << "[azlog] " << drops - reportedDrops << " binary log records dropped (thread buffer full)" << std::endl;
+                reportedDrops = drops;
+            }
+            fflush(file_);
+
+            std::unique_lock<std::mutex> lock(wakeMutex_);
+            if (stopping_)
+            {
+                lock.unlock();
+                drainAll(); // stop 직전에 기록된 레코드까지 반영
+                fflush(file_);
+                break;
+            }
+            wakeCv_.wait_for(lock, config_.drainInterval);
+        }
+    }
+
+    AzBinaryConfig config_;
+    FILE *file_ = nullptr;
+    std::atomic<uint64_t> dropped_{0};
+
+    std::mutex sitesMutex_;
+    std::vector<AzBinarySite *> sites_;
+    size_t writtenSites_ = 0;
+    uint64_t writtenAnchorSteadyNs_ = 0;
+
+    std::mutex buffersMutex_;
+    std::vector<std::shared_ptr<AzStagingBuffer>> buffers_;
+
+    std::mutex controlMutex_;
+    std::mutex wakeMutex_;
+    std::condition_variable wakeCv_;
+    bool stopping_ = false;
+    std::thread worker_;
+};
+
+#endif // _AZLOGD_BINARY_H_
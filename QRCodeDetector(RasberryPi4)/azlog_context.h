@@ -0,0 +1,255 @@
+#ifndef _AZLOGD_CONTEXT_H_
+#define _AZLOGD_CONTEXT_H_
+
+// azlog 구조화 컨텍스트 (스캔 결과)
+// azlog.h 내부에서 포함됨
+//
+// - AzScanContext : 현재 스캔 결과와 그 직렬화 결과(텍스트/JSON)를 함께 보관. update 때만 다시 직렬화
+// - AzScanContextRef : 로그 호출에 넘기는 가벼운 참조. std::vector<ScanResult>, AzScanContext, {} 모두에서 암시적으로 만들어짐
+//   (벡터를 복사하지 않으며, AzScanContext 를 넘기면 캐시된 문자열을 그대로 복사만 함)
+// - JSON lines 한 줄 생성 함수 (AzSinkConfig::format == AzLogFormat::JsonLines 일 때 사용)
+
+#include <atomic>
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// ScanResult 목록을 COUT_ 와 같은 형식으로 고정 버퍼에 덧붙임 (할당 없음)
+static inline size_t az_appendScanResults(char *buf, size_t cap, size_t len, const std::vector<ScanResult> &scanResults)
+{
+    if (scanResults.empty() || len >= cap)
+    {
+        return len;
+    }
+
+    auto append = [&](const char *format, ...)
+    {
+        if (len >= cap)
+            return;
+        va_list ap;
+        va_start(ap, format);
+        int written = vsnprintf(buf + len, cap - len, format, ap);
+        va_end(ap);
+        len = written < 0 ? len : std::min(cap - 1, len + static_cast<size_t>(written));
+    };
+
+    append(" [ScanResults: ");
+    for (const auto &result : scanResults)
+    {
+        append("HubId=%s. Logs=", result.hubId.c_str());
+        for (const auto &entry : result.logList)
+        {
+            // az_plusflag(uuid, '+', 6, "%+06d") 와 같은 결과
+            append("%06d ", entry.uuid);
+        }
+        append("; ");
+    }
+    append("]");
+    return len;
+}
+
+// JSON 문자열 내용으로 이스케이프하여 덧붙임 (따옴표 제외)
+static inline void az_appendJsonEscaped(std::string &out, const char *value, size_t length)
+{
+    for (size_t i = 0; i < length; ++i)
+    {
+        unsigned char c = static_cast<unsigned char>(value[i]);
+        switch (c)
+        {
+        case '"': out += "\\\""; break;
+        case '\\': out += "\\\\"; break;
+        case '\n': out += "\\n"; break;
+        case '\r': out += "\\r"; break;
+        case '\t': out += "\\t"; break;
+        default:
+            if (c < 0x20)
+            {
+                char escaped[8];
+                snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+                out += escaped;
+            }
+            else
+            {
+                out += static_cast<char>(c);
+            }
+        }
+    }
+}
+
+// ScanResult 목록을 JSON 배열로 덧붙임
+// [{"hubId":"Hub_1234","logs":[{"serverId":"Server_1","uuid":12345}]}]
+static inline void az_appendScanResultsJson(std::string &out, const std::vector<ScanResult> &scanResults)
+{
+    out += '[';
+    for (size_t i = 0; i < scanResults.size(); ++i)
+    {
+        const ScanResult &result = scanResults[i];
+        out += i ? ",{\"hubId\":\"" : "{\"hubId\":\"";
+        az_appendJsonEscaped(out, result.hubId.data(), result.hubId.size());
+        out += "\",\"logs\":[";
+        for (size_t j = 0; j < result.logList.size(); ++j)
+        {
+            const Entry &entry = result.logList[j];
+            out += j ? ",{\"serverId\":\"" : "{\"serverId\":\"";
+            az_appendJsonEscaped(out, entry.serverId.data(), entry.serverId.size());
+            out += "\",\"uuid\":" + std::to_string(entry.uuid) + "}";
+        }
+        out += "]}";
+    }
+    out += ']';
+}
+
+// 고정 버퍼 버전 (잘리면 JSON 이 깨지므로 들어가지 않으면 빈 배열)
+static inline size_t az_appendScanResultsJson(char *buf, size_t cap, size_t len, const char *json, size_t jsonLength)
+{
+    if (jsonLength + len >= cap)
+    {
+        json = "[]";
+        jsonLength = 2;
+    }
+    size_t n = std::min(jsonLength, cap > len + 1 ? cap - len - 1 : 0);
+    std::memcpy(buf + len, json, n);
+    buf[len + n] = '\0';
+    return len + n;
+}
+
+// 로그 한 줄을 JSON lines 형식으로 생성
+// {"time":"2026-10-19T04:47:04.123456","level":"INFO","function":"main","line":7,"message":"...","errno":2,"errnoName":"ENOENT","scanResults":[...]}
+static inline void az_formatJsonRow(std::string &row, uint64_t wallNs, const char *level, const char *function, int line,
+                                    const char *message, size_t messageLength, int savedErrno, const char *scanJson, size_t scanJsonLength)
+{
+    char time[40];
+    size_t timeLength = az_formatTimestampIso(time, wallNs);
+
+    row = "{\"time\":\"";
+    row.append(time, timeLength);
+    row += "\",\"level\":\"";
+    az_appendJsonEscaped(row, level, strlen(level));
+    row += "\",\"function\":\"";
+    az_appendJsonEscaped(row, function, strlen(function));
+    row += "\",\"line\":" + std::to_string(line) + ",\"message\":\"";
+    az_appendJsonEscaped(row, message, messageLength);
+    row += '"';
+    if (savedErrno > 0 && savedErrno < MAX_ENAME)
+    {
+        row += ",\"errno\":" + std::to_string(savedErrno) + ",\"errnoName\":\"" + ename[savedErrno] + "\"";
+    }
+    if (scanJsonLength > 2) // 빈 배열은 생략
+    {
+        row += ",\"scanResults\":";
+        row.append(scanJson, scanJsonLength);
+    }
+    row += "}\n";
+}
+
+// 스캔 결과 컨텍스트. 직렬화 결과를 캐시해 두고 update 때만 다시 만듦
+// 스냅샷은 불변이며, 로그 호출은 스냅샷을 shared_ptr 로 잡아 두므로 다른 스레드의 update 와 경쟁하지 않음
+class AzScanContext
+{
+public:
+    struct Snapshot
+    {
+        std::vector<ScanResult> results;
+        std::string text; // " [ScanResults: ...]" (COUT_ 형식, 비어 있으면 빈 문자열)
+        std::string json; // [{"hubId":...}]
+        uint64_t version = 0;
+    };
+
+    AzScanContext()
+    {
+        auto empty = std::make_shared<Snapshot>();
+        empty->json = "[]";
+        snapshot_ = std::move(empty);
+    }
+
+    explicit AzScanContext(std::vector<ScanResult> results) : AzScanContext()
+    {
+        update(std::move(results));
+    }
+
+    AzScanContext(const AzScanContext &) = delete;
+    AzScanContext &operator=(const AzScanContext &) = delete;
+
+    void update(std::vector<ScanResult> results)
+    {
+        auto snapshot = std::make_shared<Snapshot>();
+        snapshot->results = std::move(results);
+
+        char text[AZLOGD_BUF_SIZE];
+        size_t length = az_appendScanResults(text, sizeof(text), 0, snapshot->results);
+        snapshot->text.assign(text, length);
+        az_appendScanResultsJson(snapshot->json, snapshot->results);
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        snapshot->version = snapshot_->version + 1;
+        std::atomic_store(&snapshot_, std::shared_ptr<const Snapshot>(std::move(snapshot)));
+    }
+
+    std::shared_ptr<const Snapshot> snapshot() const
+    {
+        return std::atomic_load(&snapshot_);
+    }
+
+private:
+    std::mutex mutex_; // update 직렬화 (버전 증가)
+    std::shared_ptr<const Snapshot> snapshot_;
+};
+
+// 로그 호출에 넘기는 스캔 결과 참조
+class AzScanContextRef
+{
+public:
+    AzScanContextRef() = default;
+    AzScanContextRef(const std::vector<ScanResult> &results) : results_(&results) {}
+    AzScanContextRef(const AzScanContext &context) : snapshot_(context.snapshot()), results_(&snapshot_->results) {}
+
+    bool empty() const { return !results_ || results_->empty(); }
+
+    const std::vector<ScanResult> &results() const
+    {
+        static const std::vector<ScanResult> none;
+        return results_ ? *results_ : none;
+    }
+
+    // COUT_ 형식 텍스트를 고정 버퍼에 덧붙임
+    size_t appendText(char *buf, size_t cap, size_t len) const
+    {
+        if (empty())
+        {
+            return len;
+        }
+        if (snapshot_ && snapshot_->text.size() + len < cap)
+        {
+            std::memcpy(buf + len, snapshot_->text.data(), snapshot_->text.size() + 1);
+            return len + snapshot_->text.size();
+        }
+        return az_appendScanResults(buf, cap, len, *results_);
+    }
+
+    // JSON 배열을 고정 버퍼에 덧붙임
+    size_t appendJson(char *buf, size_t cap, size_t len) const
+    {
+        if (empty())
+        {
+            return az_appendScanResultsJson(buf, cap, len, "[]", 2);
+        }
+        if (snapshot_)
+        {
+            return az_appendScanResultsJson(buf, cap, len, snapshot_->json.data(), snapshot_->json.size());
+        }
+        std::string json;
+        az_appendScanResultsJson(json, *results_);
+        return az_appendScanResultsJson(buf, cap, len, json.data(), json.size());
+    }
+
+private:
+    std::shared_ptr<const AzScanContext::Snapshot> snapshot_;
+    const std::vector<ScanResult> *results_ = nullptr;
+};
+
+#endif // _AZLOGD_CONTEXT_H_
@@ -0,0 +1,424 @@
+// azlog 바이너리 로그(azlog.bin)를 COUT_ 와 같은 텍스트 형식으로 변환하는 도구
+//
+// 사용법: azlog_decode <azlog.bin> [--out DIR] [--json]
+//   --out 을 주면 호출 지점에 지정된 로그 파일(debug_log.txt 등)별로 DIR 아래에 나누어 기록, 없으면 표준 출력
+//   --json 을 주면 JSON lines 형식으로 출력
+//
+// 스레드별 버퍼를 모아서 기록하므로 파일 안의 순서는 스레드 단위로만 정렬되어 있음.
+// 전체 엔트리를 읽은 뒤 타임스탬프 기준으로 정렬하여 출력.
+
+#include "azlog.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+struct DecodedSite
+{
+    std::string level;
+    std::string function;
+    uint32_t line = 0;
+    std::string file;
+    std::string format;
+    std::string signature;
+};
+
+struct DecodedEntry
+{
+    uint32_t siteId;
+    uint64_t timestampNs;
+    int32_t savedErrno;
+    std::string payload; // 인자 바이트 + 스캔 결과
+};
+
+// 경계 검사를 하며 앞에서부터 읽는 커서
+class Reader
+{
+public:
+    Reader(const char *data, size_t size) : data_(data), size_(size) {}
+
+    bool ok() const { return ok_; }
+    size_t remaining() const { return ok_ ? size_ - offset_ : 0; }
+
+    template <class T>
+    T read()
+    {
+        T value{};
+        if (!ok_ || size_ - offset_ < sizeof(T))
+        {
+            ok_ = false;
+            return value;
+        }
+        std::memcpy(&value, data_ + offset_, sizeof(T));
+        offset_ += sizeof(T);
+        return value;
+    }
+
+    std::string readString()
+    {
+        uint16_t length = read<uint16_t>();
+        if (!ok_ || size_ - offset_ < length)
+        {
+            ok_ = false;
+            return std::string();
+        }
+        std::string value(data_ + offset_, length);
+        offset_ += length;
+        return value;
+    }
+
+private:
+    const char *data_;
+    size_t size_;
+    size_t offset_ = 0;
+    bool ok_ = true;
+};
+
+// 시그니처 문자 하나에 해당하는 인자 값
+struct DecodedArg
+{
+    char tag = 0;
+    int64_t i = 0;
+    uint64_t u = 0;
+    double d = 0;
+    std::string s;
+};
+
+static bool readArg(Reader &reader, char tag, DecodedArg &arg)
+{
+    arg.tag = tag;
+    switch (tag)
+    {
+    case 'b': arg.i = reader.read<int8_t>(); break;
+    case 'h': arg.i = reader.read<int16_t>(); break;
+    case 'i': arg.i = reader.read<int32_t>(); break;
+    case 'l': arg.i = reader.read<int64_t>(); break;
+    case 'B': arg.u = reader.read<uint8_t>(); break;
+    case 'H': arg.u = reader.read<uint16_t>(); break;
+    case 'I': arg.u = reader.read<uint32_t>(); break;
+    case 'L': arg.u = reader.read<uint64_t>(); break;
+    case 'p': arg.u = reader.read<uint64_t>(); break;
+    case 'd': arg.d = reader.read<double>(); break;
+    case 's': arg.s = reader.readString(); break;
+    default: return false;
+    }
+    if (tag == 'b' || tag == 'h' || tag == 'i' || tag == 'l')
+    {
+        arg.u = static_cast<uint64_t>(arg.i);
+    }
+    else if (tag != 'd' && tag != 's')
+    {
+        arg.i = static_cast<int64_t>(arg.u);
+    }
+    return reader.ok();
+}
+
+// 변환 지정자 하나를 인자로 포맷팅
+// 길이 수식어는 버리고 기록된 값의 크기를 기준으로 다시 붙이되,
+// 수식어가 없는 정수 지정자는 printf 와 같게 하위 32 비트만 사용 (예: %d 에 size_t 를 넘긴 기존 호출)
+static std::string formatArg(std::string spec, const DecodedArg &arg)
+{
+    char conversion = spec.back();
+    std::string length;
+    spec.pop_back();
+    while (!spec.empty() && strchr("hlLqjzt", spec.back()))
+    {
+        length.insert(length.begin(), spec.back());
+        spec.pop_back();
+    }
+
+    char buf[AZLOGD_BUF_SIZE];
+    int n = -1;
+    if (strchr("di", conversion))
+    {
+        if (length.empty())
+            n = snprintf(buf, sizeof(buf), (spec + conversion).c_str(), static_cast<int>(arg.i));
+        else if (length == "h" || length == "hh")
+            n = snprintf(buf, sizeof(buf), (spec + length + conversion).c_str(), static_cast<int>(arg.i));
+        else
+            n = snprintf(buf, sizeof(buf), (spec + "ll" + conversion).c_str(), static_cast<long long>(arg.i));
+    }
+    else if (strchr("ouxX", conversion))
+    {
+        if (length.empty())
+            n = snprintf(buf, sizeof(buf), (spec + conversion).c_str(), static_cast<unsigned>(arg.u));
+        else if (length == "h" || length == "hh")
+            n = snprintf(buf, sizeof(buf), (spec + length + conversion).c_str(), static_cast<unsigned>(arg.u));
+        else
+            n = snprintf(buf, sizeof(buf), (spec + "ll" + conversion).c_str(), static_cast<unsigned long long>(arg.u));
+    }
+    else if (conversion == 'c')
+    {
+        n = snprintf(buf, sizeof(buf), (spec + conversion).c_str(), static_cast<int>(arg.i));
+    }
+    else if (strchr("fFeEgGaA", conversion))
+    {
+        double value = arg.tag == 'd' ? arg.d : static_cast<double>(arg.i);
+        n = snprintf(buf, sizeof(buf), (spec + conversion).c_str(), value);
+    }
+    else if (conversion == 's')
+    {
+        if (arg.tag != 's')
+        {
+            return "<?>";
+        }
+        n = snprintf(buf, sizeof(buf), (spec + conversion).c_str(), arg.s.c_str());
+    }
+    else if (conversion == 'p')
+    {
+        n = snprintf(buf, sizeof(buf), (spec + conversion).c_str(), reinterpret_cast<void *>(static_cast<uintptr_t>(arg.u)));
+    }
+    if (n < 0)
+    {
+        return "<?>";
+    }
+    return std::string(buf, std::min(static_cast<size_t>(n), sizeof(buf) - 1));
+}
+
+// 포맷 문자열을 따라가며 기록된 인자를 대입. '*' 폭/정밀도는 azlog 호출에서 쓰지 않으므로 지원하지 않음
+static std::string formatMessage(const DecodedSite &site, Reader &reader)
+{
+    std::vector<DecodedArg> args(site.signature.size());
+    for (size_t i = 0; i < site.signature.size(); ++i)
+    {
+        if (!readArg(reader, site.signature[i], args[i]))
+        {
+            return site.format + " <corrupt arguments>";
+        }
+    }
+
+    std::string message;
+    size_t next = 0;
+    const std::string &format = site.format;
+    for (size_t i = 0; i < format.size(); ++i)
+    {
+        if (format[i] != '%')
+        {
+            message += format[i];
+            continue;
+        }
+        if (i + 1 < format.size() && format[i + 1] == '%')
+        {
+            message += '%';
+            ++i;
+            continue;
+        }
+
+        size_t end = i + 1;
+        while (end < format.size() && !strchr("diouxXcfFeEgGaAspn", format[end]))
+        {
+            ++end;
+        }
+        if (end == format.size())
+        {
+            message.append(format, i, std::string::npos);
+            break;
+        }
+        std::string spec = format.substr(i, end - i + 1);
+        if (format[end] != 'n')
+        {
+            message += next < args.size() ? formatArg(spec, args[next++]) : "<missing>";
+        }
+        i = end;
+    }
+    return message;
+}
+
+static std::vector<ScanResult> readScanResults(Reader &reader)
+{
+    std::vector<ScanResult> scanResults(reader.read<uint16_t>());
+    for (auto &result : scanResults)
+    {
+        result.hubId = reader.readString();
+        result.logList.resize(reader.read<uint16_t>());
+        for (auto &entry : result.logList)
+        {
+            entry.serverId = reader.readString();
+            entry.uuid = reader.read<int32_t>();
+        }
+    }
+    if (!reader.ok())
+    {
+        scanResults.clear();
+    }
+    return scanResults;
+}
+
+static std::string formatRow(const DecodedSite &site, const DecodedEntry &entry, uint64_t wallAnchorNs, uint64_t steadyAnchorNs, bool json)
+{
+    Reader reader(entry.payload.data(), entry.payload.size());
+    std::string message = formatMessage(site, reader);
+    std::vector<ScanResult> scanResults = readScanResults(reader);
+
+    uint64_t wallNs = wallAnchorNs + (entry.timestampNs - steadyAnchorNs);
+    if (json)
+    {
+        std::string scanJson, row;
+        az_appendScanResultsJson(scanJson, scanResults);
+        az_formatJsonRow(row, wallNs, site.level.c_str(), site.function.c_str(), static_cast<int>(site.line),
+                         message.data(), message.size(), entry.savedErrno, scanJson.data(), scanJson.size());
+        return row;
+    }
+
+    char buf[AZLOGD_BUF_SIZE];
+    buf[0] = '[';
+    size_t timeLength = 1 + az_formatTimestamp(buf + 1, wallNs);
+    int n = snprintf(buf + timeLength, sizeof(buf) - timeLength, "] %s (%s:%u) - ", site.level.c_str(), site.function.c_str(), site.line);
+    std::string row(buf, n > 0 ? std::min(timeLength + n, sizeof(buf) - 1) : timeLength);
+    row += message;
+    if (entry.savedErrno > 0 && entry.savedErrno < MAX_ENAME)
+    {
+        row += " [errno: " + std::to_string(entry.savedErrno) + " - " + ename[entry.savedErrno] + "]";
+    }
+    size_t length = az_appendScanResults(buf, sizeof(buf), 0, scanResults);
+    row.append(buf, length);
+    row += '\n';
+    return row;
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc < 2)
+    {
+        std::cerr << "Usage: " << argv[0] << " <azlog.bin> [--out DIR] [--json]" << std::endl;
+        return 1;
+    }
+    std::string outDir;
+    bool json = false;
+    for (int i = 2; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        if (arg == "--out" && i + 1 < argc)
+        {
+            outDir = argv[++i];
+        }
+        else if (arg == "--json")
+        {
+            json = true;
+        }
+    }
+
+    std::ifstream in(argv[1], std::ios::binary);
+    if (!in)
+    {
+        std::cerr << "Failed to open " << argv[1] << std::endl;
+        return 1;
+    }
+    std::string data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+
+    Reader header(data.data(), data.size());
+    char magic[4];
+    for (char &c : magic)
+    {
+        c = header.read<char>();
+    }
+    uint32_t version = header.read<uint32_t>();
+    uint64_t wallAnchorNs = header.read<uint64_t>();
+    uint64_t steadyAnchorNs = header.read<uint64_t>();
+    // 버전 2 는 기준점 엔트리가 없는 것만 다름
+    if (!header.ok() || std::memcmp(magic, AZLOGD_BINARY_MAGIC, 4) != 0 || version < 2 || version > AZLOGD_BINARY_VERSION)
+    {
+        std::cerr << argv[1] << " is not an azlog binary log (version " << AZLOGD_BINARY_VERSION << ")" << std::endl;
+        return 1;
+    }
+
+    std::unordered_map<uint32_t, DecodedSite> sites;
+    std::vector<DecodedEntry> entries;
+    std::vector<std::pair<uint64_t, uint64_t>> anchors{{steadyAnchorNs, wallAnchorNs}}; // (단조, 벽시계)
+    size_t offset = data.size() - header.remaining();
+    while (data.size() - offset >= 8)
+    {
+        uint32_t size, kind;
+        std::memcpy(&size, &data[offset], 4);
+        std::memcpy(&kind, &data[offset + 4], 4);
+        if (size < 8 || size > data.size() - offset)
+        {
+            std::cerr << "Truncated entry at offset " << offset << ", stopping" << std::endl;
+            break;
+        }
+
+        Reader body(&data[offset + 8], size - 8);
+        if (kind & AZLOGD_BINARY_SITE_FLAG)
+        {
+            DecodedSite site;
+            site.level = body.readString();
+            site.function = body.readString();
+            site.line = body.read<uint32_t>();
+            site.file = body.readString();
+            site.format = body.readString();
+            site.signature = body.readString();
+            if (body.ok())
+            {
+                sites[kind & ~AZLOGD_BINARY_SITE_FLAG] = std::move(site);
+            }
+        }
+        else if (kind == AZLOGD_BINARY_ANCHOR_KIND)
+        {
+            uint64_t wallNs = body.read<uint64_t>();
+            uint64_t steadyNs = body.read<uint64_t>();
+            if (body.ok())
+            {
+                anchors.emplace_back(steadyNs, wallNs);
+            }
+        }
+        else if (size >= AZLOGD_BINARY_ENTRY_HEADER)
+        {
+            DecodedEntry entry;
+            entry.siteId = kind;
+            entry.timestampNs = body.read<uint64_t>();
+            entry.savedErrno = body.read<int32_t>();
+            entry.payload.assign(&data[offset + AZLOGD_BINARY_ENTRY_HEADER], size - AZLOGD_BINARY_ENTRY_HEADER);
+            entries.push_back(std::move(entry));
+        }
+        offset += size;
+    }
+
+    std::stable_sort(entries.begin(), entries.end(), [](const DecodedEntry &a, const DecodedEntry &b)
+                     { return a.timestampNs < b.timestampNs; });
+    std::sort(anchors.begin(), anchors.end());
+
+    std::map<std::string, std::ofstream> outputs;
+    size_t unknown = 0;
+    size_t anchor = 0; // 엔트리 시각 이전의 가장 최근 기준점 (엔트리가 시간순이므로 앞으로만 이동)
+    for (const auto &entry : entries)
+    {
+        while (anchor + 1 < anchors.size() && anchors[anchor + 1].first <= entry.timestampNs)
+        {
+            ++anchor;
+        }
+        auto site = sites.find(entry.siteId);
+        if (site == sites.end())
+        {
+            ++unknown;
+            continue;
+        }
+
+        std::string row = formatRow(site->second, entry, anchors[anchor].second, anchors[anchor].first, json);
+        if (outDir.empty())
+        {
+            std::cout << row;
+            continue;
+        }
+
+        auto &out = outputs[site->second.file];
+        if (!out.is_open())
+        {
+            out.open(outDir + "/" + site->second.file, std::ios::app);
+        }
+        out << row;
+    }
+
+    std::cerr << entries.size() << " records, " << sites.size() << " call sites";
+    if (unknown)
+    {
+        std::cerr << ", " << unknown << " records with unknown call site";
+    }
+    std::cerr << std::endl;
+    return 0;
+}
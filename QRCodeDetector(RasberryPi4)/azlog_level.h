@@ -0,0 +1,303 @@
+#ifndef _AZLOGD_LEVEL_H_
+#define _AZLOGD_LEVEL_H_
+
+// azlog 실행 중 로그 레벨 제어
+// azlog.h 내부에서 포함됨
+//
+// - 전역 레벨 + 로그 파일(싱크)별 레벨. 컴파일 시 AZLOGD_LEVEL 은 상한으로만 동작
+// - 매크로는 먼저 maxLevel() (relaxed load 한 번) 과 비교하므로, 꺼진 레벨은 인자 평가/포맷팅 없이 분기 하나로 끝남
+// - 파일별 레벨은 호출 지점마다 (설정 세대, 실효 레벨) 을 atomic 하나에 캐시. 설정이 바뀌면 세대를 올려
+//   다음 호출에서 한 번만 다시 조회하므로, 평소에는 파일별 설정이 있어도 락 / map 조회 없이 relaxed load 두 번
+// - 설정 파일 다시 읽기(SIGHUP), 전역 레벨 한 단계 올리기/내리기(SIGUSR1/SIGUSR2) 지원
+//
+// 설정 파일 형식 (# 이후는 주석)
+//   level = INFO
+//   debug_log.txt = DEBUG
+//   info_log.txt = NONE
+
+#include <atomic>
+#include <cctype>
+#include <csignal>
+#include <cstdint>
+#include <functional>
+#include <cstdio>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unistd.h>
+
+static inline const char *az_levelName(int level)
+{
+    static const char *names[] = {"NONE", "ERROR", "WARNING", "INFO", "DEBUG"};
+    return level >= AZLOGD_LEVEL_NONE && level <= AZLOGD_LEVEL_DEBUG ? names[level] : "?";
+}
+
+// "DEBUG", "info", "3" 등을 레벨 값으로 변환. 알 수 없으면 false
+static inline bool az_parseLevel(std::string name, int &level)
+{
+    for (auto &c : name)
+    {
+        c = static_cast<char>(toupper(static_cast<unsigned char>(c)));
+    }
+    if (name.size() == 1 && name[0] >= '0' + AZLOGD_LEVEL_NONE && name[0] <= '0' + AZLOGD_LEVEL_DEBUG)
+    {
+        level = name[0] - '0';
+        return true;
+    }
+    for (int i = AZLOGD_LEVEL_NONE; i <= AZLOGD_LEVEL_DEBUG; ++i)
+    {
+        if (name == az_levelName(i) || (i == AZLOGD_LEVEL_WARNING && name == "WARN"))
+        {
+            level = i;
+            return true;
+        }
+    }
+    return false;
+}
+
+// 호출 지점(매크로 안의 static)별 파일 레벨 캐시: 상위 비트는 설정 세대, 하위 8비트는 실효 레벨.
+// 0 은 세대 0 (세대는 1 부터) 이라 처음 호출 때 조회됨. constexpr 생성이라 정적 초기화 (guard 없음)
+struct AzLevelSite
+{
+    std::atomic<uint64_t> cached{0};
+};
+
+class AzLogLevels
+{
+public:
+    static AzLogLevels &instance()
+    {
+        static AzLogLevels levels;
+        return levels;
+    }
+
+    // 전역/파일별 레벨 중 가장 높은 값. 매크로의 첫 번째 검사
+    static int maxLevel()
+    {
+        return maxLevel_.load(std::memory_order_relaxed);
+    }
+
+    // maxLevel() 을 통과한 호출만 확인: 해당 파일에 지정된 레벨이 있으면 그것을, 없으면 전역 레벨 사용
+    // (file 은 문자열 리터럴이나 std::string. 파일별 설정이 없으면 조회하지 않음)
+    template <class File>
+    bool enabled(int level, const File &file) const
+    {
+        if (!hasOverrides_.load(std::memory_order_acquire))
+        {
+            return level <= globalLevel_.load(std::memory_order_relaxed);
+        }
+        std::lock_guard<std::mutex> lock(mutex_);
+        return level <= fileLevelLocked(file);
+    }
+
+    // 매크로용: 같은 호출 지점은 항상 같은 파일이므로 실효 레벨을 site 에 캐시하고 설정 세대가 바뀔 때만 다시 조회
+    template <class File>
+    bool enabled(int level, const File &file, AzLevelSite &site) const
+    {
+        uint64_t generation = generation_.load(std::memory_order_relaxed);
+        uint64_t cached = site.cached.load(std::memory_order_relaxed);
+        if ((cached >> 8) != generation)
+        {
+            // 조회 중에 설정이 바뀌어도 저장한 세대가 옛 값이므로 다음 호출에서 다시 조회됨
+            int effective;
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                effective = fileLevelLocked(file);
+            }
+            cached = (generation << 8) | static_cast<uint64_t>(effective);
+            site.cached.store(cached, std::memory_order_relaxed);
+        }
+        return level <= static_cast<int>(cached & 0xff);
+    }
+
+    int globalLevel() const { return globalLevel_.load(std::memory_order_relaxed); }
+
+    void setGlobalLevel(int level)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        globalLevel_.store(clamp(level), std::memory_order_relaxed);
+        updateMaxLocked();
+    }
+
+    // 파일별 레벨 지정 (level < 0 이면 지정 해제)
+    void setFileLevel(const std::string &file, int level)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (level < 0)
+        {
+            fileLevels_.erase(file);
+        }
+        else
+        {
+            fileLevels_[file] = clamp(level);
+        }
+        updateMaxLocked();
+    }
+
+    // 설정 파일을 읽어 전역/파일별 레벨을 통째로 교체. 파일이 없으면 false (현재 설정 유지)
+    bool loadConfig(const std::string &path)
+    {
+        std::ifstream in(path);
+        if (!in)
+        {
+            return false;
+        }
+
+        int global = AZLOGD_LEVEL;
+        std::map<std::string, int, std::less<>> files;
+        std::string line;
+        int lineNumber = 0;
+        while (std::getline(in, line))
+        {
+            ++lineNumber;
+            line = line.substr(0, line.find('#'));
+            size_t eq = line.find('=');
+            if (eq == std::string::npos)
+            {
+                continue;
+            }
+            std::string key = trim(line.substr(0, eq));
+            int level;
+            if (key.empty() || !az_parseLevel(trim(line.substr(eq + 1)), level))
+            {
+                std::cerr << "[azlog] " << path << ":" << lineNumber << ": invalid level setting ignored" << std::endl;
+                continue;
+            }
+            if (key == "level")
+            {
+                global = level;
+            }
+            else
+            {
+                files[key] = clamp(level);
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        configPath_ = path;
+        globalLevel_.store(clamp(global), std::memory_order_relaxed);
+        fileLevels_.swap(files);
+        updateMaxLocked();
+        return true;
+    }
+
+    // SIGHUP: 설정 파일 다시 읽기, SIGUSR1/SIGUSR2: 전역 레벨 한 단계 올리기/내리기
+    // 시그널 핸들러는 self-pipe 에 시그널 번호만 쓰고, 실제 변경은 감시 스레드에서 수행
+    void installSignalHandlers(const std::string &configPath)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        configPath_ = configPath;
+        if (signalPipe_[0] >= 0)
+        {
+            return;
+        }
+        if (pipe(signalPipe_) != 0)
+        {
+            std::cerr << "[azlog] failed to create signal pipe [errno: " << errno << " - " << ename[errno] << "]" << std::endl;
+            return;
+        }
+        signalWriteFd_ = signalPipe_[1];
+
+        struct sigaction action = {};
+        action.sa_handler = &AzLogLevels::onSignal;
+        sigemptyset(&action.sa_mask);
+        action.sa_flags = SA_RESTART;
+        sigaction(SIGHUP, &action, nullptr);
+        sigaction(SIGUSR1, &action, nullptr);
+        sigaction(SIGUSR2, &action, nullptr);
+
+        std::thread(&AzLogLevels::watchSignals, this).detach();
+    }
+
+private:
+    AzLogLevels() = default;
+
+    static int clamp(int level)
+    {
+        return std::max(AZLOGD_LEVEL_NONE, std::min(AZLOGD_LEVEL_DEBUG, level));
+    }
+
+    static std::string trim(const std::string &value)
+    {
+        size_t begin = value.find_first_not_of(" \t\r");
+        size_t end = value.find_last_not_of(" \t\r");
+        return begin == std::string::npos ? std::string() : value.substr(begin, end - begin + 1);
+    }
+
+    template <class File>
+    int fileLevelLocked(const File &file) const
+    {
+        auto it = fileLevels_.find(file);
+        return it != fileLevels_.end() ? it->second : globalLevel_.load(std::memory_order_relaxed);
+    }
+
+    // 설정이 바뀔 때마다 호출 (mutex_ 안). 세대를 올려 호출 지점 캐시를 무효화
+    void updateMaxLocked()
+    {
+        int max = globalLevel_.load(std::memory_order_relaxed);
+        for (const auto &file : fileLevels_)
+        {
+            max = std::max(max, file.second);
+        }
+        hasOverrides_.store(!fileLevels_.empty(), std::memory_order_release);
+        maxLevel_.store(max, std::memory_order_relaxed);
+        generation_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    static void onSignal(int signo)
+    {
+        int savedErrno = errno;
+        char byte = static_cast<char>(signo);
+        ssize_t ignored = write(signalWriteFd_, &byte, 1);
+        (void)ignored;
+        errno = savedErrno;
+    }
+
+    void watchSignals()
+    {
+        for (;;)
+        {
+            char signo = 0;
+            ssize_t n = read(signalPipe_[0], &signo, 1);
+            if (n < 0 && errno == EINTR)
+            {
+                continue; // 읽은 것이 없으므로 다시 읽음 (이전 signo 를 다시 적용하지 않음)
+            }
+            if (n != 1)
+            {
+                break; // 파이프 닫힘 또는 오류
+            }
+            std::string path;
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                path = configPath_;
+            }
+            if (signo == SIGHUP)
+            {
+                bool loaded = loadConfig(path);
+                std::cerr << "[azlog] " << (loaded ? "reloaded " : "failed to reload ") << path
+                          << " (level " << az_levelName(globalLevel()) << ")" << std::endl;
+            }
+            else if (signo == SIGUSR1 || signo == SIGUSR2)
+            {
+                setGlobalLevel(globalLevel() + (signo == SIGUSR1 ? 1 : -1));
+                std::cerr << "[azlog] level " << az_levelName(globalLevel()) << std::endl;
+            }
+        }
+    }
+
+    inline static std::atomic<int> maxLevel_{AZLOGD_LEVEL}; // 정적 초기화되어 매크로에서 guard 검사 없이 읽힘
+    inline static int signalWriteFd_ = -1;
+    std::atomic<int> globalLevel_{AZLOGD_LEVEL};
+    std::atomic<bool> hasOverrides_{false};
+    std::atomic<uint64_t> generation_{1}; // 호출 지점 캐시의 설정 세대 (0 은 캐시 없음)
+    mutable std::mutex mutex_;
+    std::map<std::string, int, std::less<>> fileLevels_;
+    std::string configPath_;
+    int signalPipe_[2] = {-1, -1};
+};
+
+#endif // _AZLOGD_LEVEL_H_
@@ -0,0 +1,82 @@
+// 꺼진 로그 레벨 호출 비용 측정
+//
+// 사용법: azlog_level_bench [iterations]
+//   - 빈 루프
+//   - relaxed atomic load + 분기 (기준)
+//   - 전역 레벨로 꺼진 AZLOGDD (인자에 비싼 함수 호출과 ScanResult 포함)
+//   - 전역 최대 레벨은 통과하지만 파일별 레벨로 꺼진 AZLOGDD
+// 꺼진 호출에서 인자가 한 번도 평가되지 않았는지도 함께 확인
+
+#include "azlog.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+static long long evaluations = 0;
+
+// 평가되면 안 되는 인자 (호출되면 문자열 할당 + 카운트)
+static const char *expensiveArgument()
+{
+    ++evaluations;
+    static std::string value;
+    value = std::string(64, 'x');
+    return value.c_str();
+}
+
+static std::vector<ScanResult> expensiveScanResults()
+{
+    ++evaluations;
+    return {{"Hub_1234", {{"Server_1", 12345}, {"Server_2", 23456}}}};
+}
+
+template <class Body>
+static double measure(const char *name, long long iterations, Body body)
+{
+    auto start = std::chrono::steady_clock::now();
+    for (long long i = 0; i < iterations; ++i)
+    {
+        body(i);
+    }
+    double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / iterations;
+    printf("%-44s %8.3f ns/call\n", name, ns);
+    return ns;
+}
+
+int main(int argc, char *argv[])
+{
+    long long iterations = argc > 1 ? atoll(argv[1]) : 100000000LL;
+    volatile long long sink = 0;
+    std::atomic<int> reference{AZLOGD_LEVEL_INFO};
+
+    AzLogLevels &levels = AzLogLevels::instance();
+    levels.setGlobalLevel(AZLOGD_LEVEL_INFO);
+
+    printf("iterations: %lld, global level: %s\n", iterations, az_levelName(levels.globalLevel()));
+    measure("empty loop", iterations, [&](long long i)
+            { sink = i; });
+    measure("relaxed load + branch (reference)", iterations, [&](long long i)
+            {
+                if (reference.load(std::memory_order_relaxed) >= AZLOGD_LEVEL_DEBUG)
+                {
+                    sink = sink + 1;
+                }
+                sink = i; });
+    measure("AZLOGDD disabled by global level", iterations, [&](long long i)
+            {
+                AZLOGDD("value %s %lld", "debug_log.txt", expensiveScanResults(), expensiveArgument(), i);
+                sink = i; });
+
+    // debug_log.txt 만 DEBUG: 최대 레벨 검사는 통과하고 파일별 검사에서 걸러짐
+    levels.setFileLevel("debug_log.txt", AZLOGD_LEVEL_DEBUG);
+    measure("AZLOGDD disabled by file level", iterations / 10, [&](long long i)
+            {
+                AZLOGDD("value %s %lld", "info_log.txt", expensiveScanResults(), expensiveArgument(), i);
+                sink = i; });
+    levels.setFileLevel("debug_log.txt", -1);
+
+    printf("argument evaluations on disabled calls: %lld\n", evaluations);
+    return evaluations == 0 ? 0 : 1;
+}
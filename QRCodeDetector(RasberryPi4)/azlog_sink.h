@@ -0,0 +1,425 @@
+#ifndef _AZLOGD_SINK_H_
+#define _AZLOGD_SINK_H_
+
+// azlog 파일 싱크 관리자
+// azlog.h 내부에서 포함됨 (ename, ensureDirectoryExists, RESOURCE_PATH 사용)
+//
+// - 로그 디렉토리는 최초 설정 시 한 번만 확인/생성 (로그 한 줄마다 stat/mkdir 하지 않음)
+// - 로그 파일별로 버퍼를 둔 FILE* 를 하나씩 열어 두고 재사용 (줄마다 open/close 하지 않음)
+// - 크기 또는 날짜 기준으로 파일을 교체하고, 교체된 파일은 백그라운드 스레드에서 gzip 압축 후 오래된 것부터 정리
+//
+// 교체된 파일 이름: debug_log.txt -> debug_log.20261019-044237.txt(.gz)
+
+#include <zlib.h>
+#include <dirent.h>
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// 로그 파일에 기록하는 한 줄의 형식 (동기 경로의 콘솔 출력은 항상 텍스트, 비동기 백엔드는 콘솔도 같은 형식)
+enum class AzLogFormat
+{
+    Text,      // COUT_ 형식
+    JsonLines, // 한 줄에 JSON 객체 하나 (수집 도구용)
+};
+
+struct AzSinkConfig
+{
+    std::string directory;                 // 비어 있으면 AZLOG_DIR 환경 변수, 그것도 없으면 RESOURCE_PATH
+    size_t maxFileBytes = 16 * 1024 * 1024; // 이 크기를 넘으면 교체 (0 이면 크기 기준 교체 안 함)
+    bool rotateDaily = true;               // 날짜가 바뀌면 교체
+    size_t maxBackups = 10;                // 로그 파일별로 남겨 둘 교체 파일 수 (0 이면 무제한)
+    bool compress = true;                  // 교체 파일 gzip 압축
+    size_t bufferSize = 65536;             // 파일별 stdio 버퍼 크기
+    AzLogFormat format = AzLogFormat::Text;
+};
+
+class AzSinkManager
+{
+public:
+    static AzSinkManager &instance()
+    {
+        static AzSinkManager manager;
+        return manager;
+    }
+
+    // 설정 변경. 열려 있는 파일은 닫고 이후 쓰기부터 새 설정으로 다시 열림
+    void configure(const AzSinkConfig &config)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        closeLocked();
+        config_ = config;
+        if (config_.directory.empty())
+        {
+            config_.directory = defaultDirectory();
+        }
+        checkDirectory();
+        jsonLines_.store(config_.format == AzLogFormat::JsonLines, std::memory_order_relaxed);
+        configured_ = true;
+    }
+
+    // 로그 줄을 만드는 쪽(VCOUT_, 비동기 백엔드)에서 형식 결정에 사용
+    bool jsonLines() const
+    {
+        return jsonLines_.load(std::memory_order_relaxed);
+    }
+
+    std::string directory()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ensureConfiguredLocked();
+        return config_.directory;
+    }
+
+    std::string path(const std::string &file)
+    {
+        return directory() + "/" + file;
+    }
+
+    void write(const std::string &file, const char *data, size_t length)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ensureConfiguredLocked();
+        Sink *sink = sinkLocked(file, length);
+        if (sink)
+        {
+            fwrite(data, 1, length, sink->fp);
+            sink->size += length;
+        }
+    }
+
+    void write(const std::string &file, const std::string &row)
+    {
+        write(file, row.data(), row.size());
+    }
+
+    void flush(const std::string &file)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = sinks_.find(file);
+        if (it != sinks_.end())
+        {
+            fflush(it->second.fp);
+        }
+    }
+
+    void flushAll()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (auto &sink : sinks_)
+        {
+            fflush(sink.second.fp);
+        }
+    }
+
+    void closeAll()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        closeLocked();
+    }
+
+private:
+    struct Sink
+    {
+        FILE *fp = nullptr;
+        size_t size = 0;
+        time_t rotateAt = 0; // 날짜 기준 교체 시각 (다음 자정)
+        std::string lastStamp; // 마지막 교체 시각과 그 초 안의 교체 횟수 (이름 순서 유지용)
+        int stampCount = 0;
+    };
+
+    // 교체된 파일 후처리 (압축 + 정리)
+    struct RotatedFile
+    {
+        std::string path;
+        std::string file; // 원래 로그 파일 이름
+        bool compress;
+        size_t maxBackups;
+    };
+
+    AzSinkManager() = default;
+
+    ~AzSinkManager()
+    {
+        closeAll();
+        {
+            std::lock_guard<std::mutex> lock(jobsMutex_);
+            stopping_ = true;
+        }
+        jobsCv_.notify_one();
+        if (worker_.joinable())
+        {
+            worker_.join();
+        }
+    }
+
+    void ensureConfiguredLocked()
+    {
+        if (!configured_)
+        {
+            config_.directory = defaultDirectory();
+            checkDirectory();
+            configured_ = true;
+        }
+    }
+
+    // 호출한 쪽의 errno 가 로그 줄에 섞이지 않도록 보존
+    void checkDirectory()
+    {
+        int savedErrno = errno;
+        ensureDirectoryExists(config_.directory);
+        errno = savedErrno;
+    }
+
+    static std::string defaultDirectory()
+    {
+        const char *env = std::getenv("AZLOG_DIR");
+        return env && *env ? env : RESOURCE_PATH;
+    }
+
+    static time_t nextMidnight(time_t now)
+    {
+        struct tm tm;
+        localtime_r(&now, &tm);
+        tm.tm_hour = 0;
+        tm.tm_min = 0;
+        tm.tm_sec = 0;
+        tm.tm_mday += 1;
+        tm.tm_isdst = -1;
+        return mktime(&tm);
+    }
+
+    // 쓰기 전에 필요하면 파일을 교체하고, 열려 있지 않으면 엶
+    Sink *sinkLocked(const std::string &file, size_t incoming)
+    {
+        Sink &sink = sinks_[file];
+        if (sink.fp)
+        {
+            bool bySize = config_.maxFileBytes && sink.size > 0 && sink.size + incoming > config_.maxFileBytes;
+            bool byDate = config_.rotateDaily && time(nullptr) >= sink.rotateAt;
+            if (bySize || byDate)
+            {
+                rotateLocked(file, sink);
+            }
+        }
+        if (!sink.fp && !openLocked(file, sink))
+        {
+            sinks_.erase(file);
+            return nullptr;
+        }
+        return &sink;
+    }
+
+    bool openLocked(const std::string &file, Sink &sink)
+    {
+        std::string filePath = config_.directory + "/" + file;
+        sink.fp = fopen(filePath.c_str(), "a");
+        if (!sink.fp)
+        {
+            std::cerr << "Failed to open log file: " << filePath << " [errno: " << errno << " - " << ename[errno] << "]" << std::endl;
+            return false;
+        }
+        setvbuf(sink.fp, nullptr, _IOFBF, config_.bufferSize);
+
+        // 기존 파일에 이어 쓰는 경우 크기와 마지막 수정 날짜 기준으로 교체 시점 계산
+        struct stat info;
+        time_t now = time(nullptr);
+        sink.size = 0;
+        sink.rotateAt = nextMidnight(now);
+        if (fstat(fileno(sink.fp), &info) == 0)
+        {
+            sink.size = static_cast<size_t>(info.st_size);
+            if (info.st_size > 0)
+            {
+                sink.rotateAt = nextMidnight(info.st_mtime);
+            }
+        }
+        return true;
+    }
+
+    void rotateLocked(const std::string &file, Sink &sink)
+    {
+        fclose(sink.fp);
+        sink.fp = nullptr;
+
+        std::string filePath = config_.directory + "/" + file;
+        size_t dot = file.find_last_of('.');
+        std::string stem = dot == std::string::npos ? file : file.substr(0, dot);
+        std::string ext = dot == std::string::npos ? "" : file.substr(dot);
+
+        time_t now = time(nullptr);
+        struct tm tm;
+        localtime_r(&now, &tm);
+        char stamp[32];
+        strftime(stamp, sizeof(stamp), "%Y%m%d-%H%M%S", &tm);
+
+        // 같은 초에 여러 번 교체되면 번호를 붙여 구분 (정리된 이름을 다시 쓰지 않도록 번호는 계속 증가)
+        sink.stampCount = sink.lastStamp == stamp ? sink.stampCount + 1 : 0;
+        sink.lastStamp = stamp;
+        std::string rotated;
+        while (true)
+        {
+            rotated = config_.directory + "/" + stem + "." + stamp +
+                      (sink.stampCount ? "-" + std::to_string(sink.stampCount) : std::string()) + ext;
+            if (access(rotated.c_str(), F_OK) != 0 && access((rotated + ".gz").c_str(), F_OK) != 0)
+            {
+                break;
+            }
+            ++sink.stampCount;
+        }
+        if (rename(filePath.c_str(), rotated.c_str()) != 0)
+        {
+            std::cerr << "Failed to rotate log file: " << filePath << " [errno: " << errno << " - " << ename[errno] << "]" << std::endl;
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(jobsMutex_);
+            jobs_.push_back({rotated, file, config_.compress, config_.maxBackups});
+            if (!worker_.joinable())
+            {
+                worker_ = std::thread(&AzSinkManager::runJobs, this);
+            }
+        }
+        jobsCv_.notify_one();
+    }
+
+    void closeLocked()
+    {
+        for (auto &sink : sinks_)
+        {
+            fclose(sink.second.fp);
+        }
+        sinks_.clear();
+    }
+
+    void runJobs()
+    {
+        std::unique_lock<std::mutex> lock(jobsMutex_);
+        while (true)
+        {
+            jobsCv_.wait(lock, [this]
+                         { return stopping_ || !jobs_.empty(); });
+            if (jobs_.empty())
+            {
+                return;
+            }
+            RotatedFile job = jobs_.front();
+            jobs_.pop_front();
+            lock.unlock();
+
+            if (job.compress)
+            {
+                compressFile(job.path);
+            }
+            if (job.maxBackups)
+            {
+                pruneBackups(job.path.substr(0, job.path.find_last_of('/')), job.file, job.maxBackups);
+            }
+            lock.lock();
+        }
+    }
+
+    static void compressFile(const std::string &path)
+    {
+        FILE *in = fopen(path.c_str(), "rb");
+        if (!in)
+        {
+            return;
+        }
+        std::string gzPath = path + ".gz";
+        gzFile out = gzopen(gzPath.c_str(), "wb6");
+        if (!out)
+        {
+            fclose(in);
+            return;
+        }
+
+        std::vector<char> buffer(1 << 16);
+        size_t n;
+        bool ok = true;
+        while ((n = fread(buffer.data(), 1, buffer.size(), in)) > 0)
+        {
+            if (gzwrite(out, buffer.data(), static_cast<unsigned>(n)) != static_cast<int>(n))
+            {
+                ok = false;
+                break;
+            }
+        }
+        fclose(in);
+        ok = gzclose(out) == Z_OK && ok;
+        // 압축에 실패하면 원본을 남겨 둠
+        if (ok)
+        {
+            unlink(path.c_str());
+        }
+        else
+        {
+            unlink(gzPath.c_str());
+        }
+    }
+
+    // 교체 파일 이름의 시각 기준으로 오래된 것부터 삭제
+    static void pruneBackups(const std::string &dir, const std::string &file, size_t maxBackups)
+    {
+        size_t dot = file.find_last_of('.');
+        std::string prefix = (dot == std::string::npos ? file : file.substr(0, dot)) + ".";
+
+        std::vector<std::string> backups;
+        DIR *d = opendir(dir.c_str());
+        if (!d)
+        {
+            return;
+        }
+        while (struct dirent *entry = readdir(d))
+        {
+            std::string name = entry->d_name;
+            // prefix 뒤가 날짜(숫자)로 시작하는 것만 교체 파일로 취급
+            if (name != file && name.compare(0, prefix.size(), prefix) == 0 &&
+                name.size() > prefix.size() && isdigit(static_cast<unsigned char>(name[prefix.size()])))
+            {
+                backups.push_back(name);
+            }
+        }
+        closedir(d);
+
+        // 시각(YYYYmmdd-HHMMSS) 다음에 같은 초 안의 교체 번호(-N) 순
+        auto order = [&prefix](const std::string &name)
+        {
+            size_t stamp = prefix.size() + 15;
+            long n = name.size() > stamp && name[stamp] == '-' ? strtol(name.c_str() + stamp + 1, nullptr, 10) : 0;
+            return std::make_pair(name.substr(prefix.size(), 15), n);
+        };
+        std::sort(backups.begin(), backups.end(), [&order](const std::string &a, const std::string &b)
+                  { return order(a) < order(b); });
+        for (size_t i = 0; i + maxBackups < backups.size(); ++i)
+        {
+            unlink((dir + "/" + backups[i]).c_str());
+        }
+    }
+
+    AzSinkConfig config_;
+    bool configured_ = false;
+    std::atomic<bool> jsonLines_{false};
+    std::mutex mutex_;
+    std::map<std::string, Sink> sinks_;
+
+    std::mutex jobsMutex_;
+    std::condition_variable jobsCv_;
+    std::deque<RotatedFile> jobs_;
+    bool stopping_ = false;
+    std::thread worker_;
+};
+
+#endif // _AZLOGD_SINK_H_
@@ -0,0 +1,174 @@
+#ifndef _AZLOGD_TIME_H_
+#define _AZLOGD_TIME_H_
+
+// azlog 타임스탬프 서비스
+// azlog.h 내부에서 포함됨
+//
+// - 순서는 단조 시계(steady_clock)로, 벽시계 시각은 기준점(anchor, 벽시계 - 단조 시계 차이)에서 계산
+//   (로그 호출마다 time() + localtime_r 을 하지 않음)
+// - 기준점은 1초마다 system_clock 과 비교해 1ms 넘게 어긋나면 다시 잡음. RTC 없는 Pi 는 첫 로그가 NTP 동기화
+//   전에 찍히는 경우가 많아, 처음 잡은 기준점을 계속 쓰면 이후 시각이 보정량만큼 계속 틀림
+// - "2026/10/19 4:47:4" 같은 초 단위 날짜/시각 문자열은 스레드별로 캐시해 같은 초 안에서는 재사용
+// - 마이크로초 부분(".123456")만 매번 직접 숫자로 씀
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+
+#define AZLOGD_REANCHOR_INTERVAL_NS 1000000000ULL // 기준점 확인 주기 (단조 시계 기준)
+#define AZLOGD_REANCHOR_DRIFT_NS 1000000LL        // 이보다 크게 어긋나면 기준점을 다시 잡음
+
+struct AzTimestamp
+{
+    uint64_t steadyNs; // 정렬/지연 측정용
+    uint64_t wallNs;   // 표시용 (epoch 기준)
+};
+
+class AzClock
+{
+public:
+    static uint64_t steadyNs()
+    {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                         std::chrono::steady_clock::now().time_since_epoch())
+                                         .count());
+    }
+
+    static uint64_t systemNs()
+    {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                         std::chrono::system_clock::now().time_since_epoch())
+                                         .count());
+    }
+
+    static AzTimestamp now()
+    {
+        uint64_t steady = steadyNs();
+        Anchor &a = anchor();
+        if (steady >= a.nextCheckNs.load(std::memory_order_relaxed))
+        {
+            reanchor(a, steady);
+        }
+        return {steady, steady + a.offsetNs.load(std::memory_order_relaxed)};
+    }
+
+    static uint64_t wallFromSteady(uint64_t steady)
+    {
+        return steady + anchor().offsetNs.load(std::memory_order_relaxed);
+    }
+
+    // 현재 기준점 (바이너리 로그가 같은 변환을 하도록 노출. 다시 잡힐 때마다 바뀜)
+    // 두 값을 함께 읽는 도중 기준점이 바뀌면 다시 읽음
+    static AzTimestamp currentAnchor()
+    {
+        Anchor &a = anchor();
+        uint64_t steady, offset;
+        do
+        {
+            steady = a.steadyNs.load(std::memory_order_acquire);
+            offset = a.offsetNs.load(std::memory_order_acquire);
+        } while (steady != a.steadyNs.load(std::memory_order_acquire));
+        return {steady, steady + offset};
+    }
+
+private:
+    struct Anchor
+    {
+        Anchor()
+        {
+            uint64_t steady = AzClock::steadyNs();
+            steadyNs.store(steady, std::memory_order_relaxed);
+            offsetNs.store(AzClock::systemNs() - steady, std::memory_order_relaxed);
+            nextCheckNs.store(steady + AZLOGD_REANCHOR_INTERVAL_NS, std::memory_order_relaxed);
+        }
+
+        std::atomic<uint64_t> steadyNs;    // 기준점을 잡은 단조 시각
+        std::atomic<uint64_t> offsetNs;    // 벽시계 - 단조 시계 (unsigned 산술로 감김)
+        std::atomic<uint64_t> nextCheckNs; // 다음 확인 시각
+    };
+
+    static Anchor &anchor()
+    {
+        static Anchor a;
+        return a;
+    }
+
+    // 주기마다 한 스레드만 확인 (CAS 에 진 스레드는 현재 기준점 사용)
+    static void reanchor(Anchor &a, uint64_t steady)
+    {
+        uint64_t next = a.nextCheckNs.load(std::memory_order_relaxed);
+        if (steady < next ||
+            !a.nextCheckNs.compare_exchange_strong(next, steady + AZLOGD_REANCHOR_INTERVAL_NS, std::memory_order_relaxed))
+        {
+            return;
+        }
+        uint64_t nowSteady = steadyNs();
+        uint64_t offset = systemNs() - nowSteady;
+        int64_t drift = static_cast<int64_t>(offset - a.offsetNs.load(std::memory_order_relaxed));
+        if (drift > AZLOGD_REANCHOR_DRIFT_NS || drift < -AZLOGD_REANCHOR_DRIFT_NS)
+        {
+            a.offsetNs.store(offset, std::memory_order_relaxed);
+            a.steadyNs.store(nowSteady, std::memory_order_release);
+        }
+    }
+};
+
+// 초 단위 날짜/시각 문자열 캐시 (스레드별)
+struct AzSecondCache
+{
+    time_t second = -1;
+    char text[32]; // "2026/10/19 4:47:4" (COUT_ 형식)
+    size_t textLength = 0;
+    char iso[32]; // "2026-10-19T04:47:04" (JSON lines)
+    size_t isoLength = 0;
+};
+
+static inline const AzSecondCache &az_secondCache(time_t second)
+{
+    thread_local AzSecondCache cache;
+    if (cache.second != second)
+    {
+        struct tm tm;
+        localtime_r(&second, &tm);
+        int n = snprintf(cache.text, sizeof(cache.text), "%d/%d/%d %d:%d:%d",
+                         tm.tm_year + 1900, tm.tm_mon + 1, tm.tm_mday, tm.tm_hour, tm.tm_min, tm.tm_sec);
+        cache.textLength = n > 0 ? static_cast<size_t>(n) : 0;
+        cache.isoLength = strftime(cache.iso, sizeof(cache.iso), "%Y-%m-%dT%H:%M:%S", &tm);
+        cache.second = second;
+    }
+    return cache;
+}
+
+// ".123456" 을 buf 에 씀 (7 바이트)
+static inline size_t az_formatMicros(char *buf, uint64_t wallNs)
+{
+    uint32_t micros = static_cast<uint32_t>((wallNs / 1000) % 1000000);
+    buf[0] = '.';
+    for (int i = 6; i >= 1; --i)
+    {
+        buf[i] = static_cast<char>('0' + micros % 10);
+        micros /= 10;
+    }
+    return 7;
+}
+
+// "2026/10/19 4:47:4.123456" 을 buf 에 쓰고 길이 반환 (buf 는 40 바이트 이상)
+static inline size_t az_formatTimestamp(char *buf, uint64_t wallNs)
+{
+    const AzSecondCache &cache = az_secondCache(static_cast<time_t>(wallNs / 1000000000ULL));
+    std::memcpy(buf, cache.text, cache.textLength);
+    return cache.textLength + az_formatMicros(buf + cache.textLength, wallNs);
+}
+
+// "2026-10-19T04:47:04.123456" 을 buf 에 쓰고 길이 반환 (buf 는 40 바이트 이상)
+static inline size_t az_formatTimestampIso(char *buf, uint64_t wallNs)
+{
+    const AzSecondCache &cache = az_secondCache(static_cast<time_t>(wallNs / 1000000000ULL));
+    std::memcpy(buf, cache.iso, cache.isoLength);
+    return cache.isoLength + az_formatMicros(buf + cache.isoLength, wallNs);
+}
+
+#endif // _AZLOGD_TIME_H_
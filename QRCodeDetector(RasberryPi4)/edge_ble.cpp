@@ -3,11 +3,79 @@
 #include "azlog.h"
 #include <boost/asio.hpp>
 #include "scan_result.h"
+#include "metrics.h"
+#include "mat_pool.h"
+#include "trace.h"
 #include <fstream>
 #include <vector>
+#include <array>
+#include <algorithm>
 
 using boost::asio::ip::tcp;
 
+// Edge 단계별 계측 지점
+struct EdgeMetrics
+{
+    EdgeMetrics()
+        : framesSent(registry().counter("edge_frames_sent_total", "Frames written to the server")),
+          bytesSent(registry().counter("edge_bytes_sent_total", "Frame payload bytes written to the server")),
+          framesAcked(registry().counter("edge_frames_acked_total", "Frames acknowledged by the server")),
+          framesRefused(registry().counter("edge_frames_refused_total", "Frames acknowledged with a non-OK status")),
+          sightings(registry().counter("edge_scan_sightings_total", "BLE advertisements read from the scan source")),
+          qrCodes(registry().counter("edge_qr_codes_total", "QR codes detected in captured frames")),
+          resultsSent(registry().counter("edge_results_sent_total", "Results-only uplink records written to the server")),
+          keyframesSent(registry().counter("edge_keyframes_sent_total", "Keyframes written in results-only uplink mode")),
+          qrCropsSent(registry().counter("edge_qr_crops_sent_total", "Full-resolution crops of undecoded QR codes sent on server request")),
+          framesOffloaded(registry().counter("edge_frames_offloaded_total", "Raw frames sent for processing on the server")),
+          processingSwitches(registry().counter("edge_processing_switches_total", "Automatic switches between edge and server processing")),
+          scanIdResets(registry().counter("edge_scan_id_resets_total", "Scan ID table resets after a window closed")),
+          staleBatches(registry().counter("edge_scan_stale_batches_total", "Scan batches dropped because the ID table was reset while they were filled")),
+          qr(stage("qr")),
+          process(stage("process")),
+          encode(stage("encode")),
+          send(stage("send")),
+          ack(stage("ack")),
+          compute(stage("compute")),
+          scanSource(stage("scan_source")),
+          ingest(stage("ingest")) {}
+
+    Counter &framesSent;
+    Counter &bytesSent;
+    Counter &framesAcked;
+    Counter &framesRefused;
+    Counter &sightings;
+    Counter &qrCodes;
+    Counter &resultsSent;
+    Counter &keyframesSent;
+    Counter &qrCropsSent;
+    Counter &framesOffloaded;
+    Counter &processingSwitches;
+    Counter &scanIdResets;
+    Counter &staleBatches;
+
+    Histogram &qr;         // QrDetectStage::detect (파인더 사전 탐지 + ROI 검출/디코딩)
+    Histogram &process;    // process_image_all_advanced (결과 전용 모드에서는 analyzeFrameResults)
+    Histogram &encode;     // imencode
+    Histogram &send;       // 윈도우 대기 + 소켓 write
+    Histogram &ack;        // 전송 후 ACK 수신까지 (RTT)
+    Histogram &compute;    // 프레임 하나의 Edge 연산 (전송 대기 제외, 처리 위치 선택 기준)
+    Histogram &scanSource; // ScanSource::scan (한 주기 광고 수신)
+    Histogram &ingest;     // addSightings (집계 + 창 요약 게시/로그)
+
+private:
+    static MetricsRegistry &registry() { return MetricsRegistry::instance(); }
+    static Histogram &stage(const std::string &name)
+    {
+        return registry().histogram("edge_stage_latency_seconds", "stage=\"" + name + "\"", "Per-stage latency of the edge pipeline");
+    }
+};
+
+static EdgeMetrics &edgeMetrics()
+{
+    static EdgeMetrics metrics;
+    return metrics;
+}
+
 EdgeBLE::EdgeBLE(const std::string &server_ip, unsigned short server_port)
     : running(false), server_ip_(server_ip), server_port_(server_port)
 {
@@ -19,6 +87,10 @@ void EdgeBLE::startScanning()
 {
     running = true;
     scanningThread = std::make_shared<std::thread>(&EdgeBLE::scanBLEDevices, this);
+    if (scanSource_)
+    {
+        scanSourceThread = std::make_shared<std::thread>(&EdgeBLE::runScanSource, this);
+    }
 }
 
 void EdgeBLE::stopScanning()
@@ -28,140 +100,161 @@ void EdgeBLE::stopScanning()
     {
         scanningThread->join();
     }
-}
-
-void EdgeBLE::scanBLEDevices()
-{
-    while (running)
+    if (scanSourceThread && scanSourceThread->joinable())
     {
-        std::this_thread::sleep_for(std::chrono::seconds(5)); // 5초 간격으로 전송
-        sendImageToServer();
+        scanSourceThread->join();
     }
-}
 
-void EdgeBLE::setScanResults(const std::vector<ScanResult> &results)
-{
+    // 아직 확인되지 않은 프레임의 ACK 를 모두 받은 뒤 연결 종료
     std::lock_guard<std::mutex> lock(bleMutex);
-    scanResults = results;
-
-    AZLOGDI("Scan results set: Size=%d", "debug_log.txt", scanResults, results.size());
-    for (const auto &result : scanResults)
+    try
+    {
+        while (socket_ && !inFlight_.empty())
+        {
+            receiveAcks(true);
+        }
+    }
+    catch (const std::exception &e)
     {
-        AZLOGDI("HubId: %s, Logs Count: %d", "debug_log.txt", scanResults, result.hubId.c_str(), result.logList.size());
+        AZLOGDE("Error while draining ACKs: %s", "error_log.txt", scanContext_, e.what());
     }
+    closeConnection();
 }
 
-cv::Mat EdgeBLE::calcGrayHist(const cv::Mat &img)
+void EdgeBLE::setAckWindow(uint32_t window)
 {
-    CV_Assert(img.type() == CV_8UC1);
+    std::lock_guard<std::mutex> lock(bleMutex);
+    ackWindow_ = std::max<uint32_t>(1, window);
+}
 
-    cv::Mat hist;
-    int channels[] = {0};
-    int dims = 1;
-    const int histSize[] = {256};
-    float graylevel[] = {0, 256};
-    const float *ranges[] = {graylevel};
+void EdgeBLE::setUplink(const UplinkConfig &config)
+{
+    std::lock_guard<std::mutex> lock(bleMutex);
+    uplink_ = config;
+    resultsSinceKeyframe_ = 0;
+    AZLOGDI("Uplink mode: %s, keyframe every %d, width %d", "debug_log.txt", {},
+            uplink_.mode == UplinkMode::Results ? "results" : "frames", uplink_.keyframeEvery, uplink_.keyframeWidth);
+}
 
-    cv::calcHist(&img, 1, channels, cv::noArray(), hist, dims, histSize, ranges);
+void EdgeBLE::setProcessing(const ProcessingConfig &config)
+{
+    std::lock_guard<std::mutex> lock(bleMutex);
+    offload_.configure(config);
+    AZLOGDI("Processing mode: %s, deadline %d ms, cpu %.2f/%.2f", "debug_log.txt", {}, processingModeName(config.mode),
+            config.deadlineMs, config.cpuLow, config.cpuHigh);
+}
 
-    return hist;
+void EdgeBLE::setComposite(const CompositeLayout &layout)
+{
+    std::lock_guard<std::mutex> lock(bleMutex);
+    composite_.setLayout(layout);
+    AZLOGDI("Composite layout: %zu panels, %d columns", "debug_log.txt", {}, layout.panels.size(), layout.columns);
 }
 
-cv::Mat EdgeBLE::getGrayHistImage(const cv::Mat &hist)
+void EdgeBLE::setAnalysisLevels(int levels)
 {
-    CV_Assert(hist.type() == CV_32FC1);
-    CV_Assert(hist.size() == cv::Size(1, 256));
+    std::lock_guard<std::mutex> lock(bleMutex);
+    analysisLevels_ = std::min(std::max(levels, 0), ANALYSIS_MAX_LEVELS);
+    AZLOGDI("Analysis scale: 1/%d", "debug_log.txt", {}, 1 << analysisLevels_);
+}
 
-    double histMax;
-    minMaxLoc(hist, 0, &histMax);
+void EdgeBLE::setScanSource(std::unique_ptr<ScanSource> source, std::chrono::milliseconds interval)
+{
+    scanSource_ = std::move(source);
+    scanInterval_ = std::max(std::chrono::milliseconds(1), interval);
+    AZLOGDI("Scan source set: %s, interval=%lld ms", "debug_log.txt", {}, scanSource_ ? scanSource_->name() : "none",
+            static_cast<long long>(scanInterval_.count()));
+}
 
-    cv::Mat imgHist(100, 256, CV_8UC1, cv::Scalar(255));
-    for (int i = 0; i < 256; i++)
+// 스캔 소스를 주기적으로 읽어 집계 단계로 넘김 (전송 스레드와 별도)
+void EdgeBLE::runScanSource()
+{
+    ScanBatch batch(scanIds_);
+    while (running)
     {
-        cv::line(imgHist, cv::Point(i, 100),
-                 cv::Point(i, 100 - cvRound(hist.at<float>(i, 0) * 100 / histMax)),
-                 cv::Scalar(0));
-    }
+        std::this_thread::sleep_for(scanInterval_);
+        {
+            ScopedTimer timer(edgeMetrics().scanSource);
+            if (!scanSource_->scan(batch, metricsNowNs()))
+            {
+                AZLOGDI("Scan source %s finished", "debug_log.txt", {}, scanSource_->name());
+                break;
+            }
+        }
+        edgeMetrics().sightings.add(batch.entryCount());
 
-    return imgHist;
+        ScopedTimer timer(edgeMetrics().ingest);
+        addSightings(batch);
+    }
 }
 
-cv::Mat EdgeBLE::filter_embossing(const cv::Mat &img)
+void EdgeBLE::scanBLEDevices()
 {
-    if (img.empty())
+    while (running)
     {
-        AZLOGDE("Failed to load image from sample.jpg", "error_log.txt", scanResults);
-        std::cerr << "Failed to load image from sample.jpg" << std::endl;
+        std::this_thread::sleep_for(std::chrono::seconds(5)); // 5초 간격으로 전송
+        sendImageToServer();
     }
+}
 
-    float data[] = {-1, -1, 0, -1, 0, 1, 0, 1, 1};
-    cv::Mat emboss(3, 3, CV_32FC1, data);
-
-    cv::Mat dst;
-    filter2D(img, dst, -1, emboss, cv::Point(-1, -1), 128);
+void EdgeBLE::setScanResults(const std::vector<ScanResult> &results)
+{
+    std::lock_guard<std::mutex> lock(scanMutex_);
+    scanBatch_.fromScanResults(results);
+    addSightingsLocked(scanBatch_);
+}
 
-    return dst;
+void EdgeBLE::addSightings(const ScanBatch &batch)
+{
+    std::lock_guard<std::mutex> lock(scanMutex_);
+    addSightingsLocked(batch);
 }
 
-cv::Mat EdgeBLE::blurring_mean(const cv::Mat &img)
+void EdgeBLE::addSightingsLocked(const ScanBatch &batch)
 {
-    if (img.empty())
+    if (batch.stale())
     {
-        AZLOGDE("Failed to load image from sample.jpg", "error_log.txt", scanResults);
-        std::cerr << "Failed to load image from sample.jpg" << std::endl;
+        edgeMetrics().staleBatches.add();
+        return;
     }
+    uint64_t now = metricsNowNs();
+    scanAggregator_.add(batch, now);
 
-    cv::Mat dst;
-    for (int ksize = 3; ksize <= 7; ksize += 2)
+    // 창이 닫히면 그 요약으로 교체. 아직 결과가 없으면 현재 창의 요약을 먼저 사용
+    if (scanAggregator_.windowElapsed(now))
     {
-        blur(img, dst, cv::Size(ksize, ksize));
-
-        cv::String desc = cv::format("Mean: %dx%d", ksize, ksize);
-        putText(dst, desc, cv::Point(10, 30), cv::FONT_HERSHEY_SIMPLEX, 1.0, cv::Scalar(255), 1, cv::LINE_AA);
+        scanAggregator_.closeWindow(scanWindow_, now);
+        AZLOGDI("Scan window closed: sightings=%llu unique=%zu overflow=%llu", "debug_log.txt", {},
+                static_cast<unsigned long long>(scanWindow_.sightings), scanWindow_.summaries.size(),
+                static_cast<unsigned long long>(scanWindow_.overflow));
     }
-
-    return dst;
-}
-
-cv::Mat EdgeBLE::blurring_affine_Transform(const cv::Mat &img)
-{
-    if (img.empty())
+    else if (scanResults.empty())
     {
-        AZLOGDE("Failed to load image from sample.jpg", "error_log.txt", scanResults);
-        std::cerr << "Failed to load image from sample.jpg" << std::endl;
-        return cv::Mat(); // 비어있는 Mat 반환
+        scanAggregator_.collect(scanWindow_, now);
+    }
+    else
+    {
+        return;
     }
 
-    // 원본 및 변환 좌표 설정
-    cv::Point2f srcPts[3] = {
-        cv::Point2f(0, 0),
-        cv::Point2f(img.cols - 1, 0),
-        cv::Point2f(img.cols - 1, img.rows - 1)};
-    cv::Point2f dstPts[3] = {
-        cv::Point2f(0, 0),
-        cv::Point2f(img.cols - 1, 0),
-        cv::Point2f(img.cols - 50, img.rows - 50)}; // 변환을 더 명확하게 하기 위해 x 좌표도 이동
-
-    // 변환 행렬 계산
-    cv::Mat M = getAffineTransform(srcPts, dstPts);
-
-    // 행렬 출력 (디버깅용)
-    std::cout << "Affine Transform Matrix:\n"
-              << M << std::endl;
-
-    // 블러링 적용
-    cv::Mat blurred;
-    blur(img, blurred, cv::Size(7, 7)); // 블러링 커널 크기 7x7
-
-    // 어파인 변환 수행
-    cv::Mat dst;
-    warpAffine(blurred, dst, M, img.size()); // img.size()로 출력 이미지 크기 지정
+    scanResults = scanWindow_.toScanResults(scanIds_, scanWallClockUs());
 
-    // 변환된 이미지 저장 (디버깅용)
-    cv::imwrite("affine_transformed_image.jpg", dst);
+    // 창이 닫혀 집계 테이블이 비었을 때 ID 테이블이 반 넘게 찼으면 비움. 기기가 계속 바뀌어도 가득 차서
+    // 새 ID 가 모두 SCAN_ID_OVERFLOW ("?") 로 합쳐지지 않도록 함. 아직 보이는 기기는 다음 스캔에서 다시 등록됨
+    if (scanAggregator_.uniqueKeys() == 0 && scanIds_.size() >= scanIds_.capacity() / 2)
+    {
+        AZLOGDI("Scan ID table reset: %zu ids", "debug_log.txt", {}, scanIds_.size());
+        scanIds_.clear();
+        scanWindow_.summaries.clear(); // 이전 세대 ID (이미 scanResults 로 변환됨)
+        edgeMetrics().scanIdResets.add();
+    }
+    scanContext_.update(scanResults);
 
-    // 결과 반환
-    return dst;
+    AZLOGDI("Scan results set: Size=%zu", "debug_log.txt", scanContext_, scanResults.size());
+    for (const auto &result : scanResults)
+    {
+        AZLOGDI("HubId: %s, Logs Count: %zu", "debug_log.txt", scanContext_, result.hubId.c_str(), result.logList.size());
+    }
 }
 
 // 정적 멤버 변수 초기화
@@ -215,240 +308,434 @@ cv::Mat EdgeBLE::event_lbuttondown(const cv::Mat &img)
     return transformed;
 }
 
-cv::Mat EdgeBLE::hough_lines(const cv::Mat &img)
+void EdgeBLE::onMouse(int event, int x, int y, int flags, void *userdata)
 {
-    if(img.empty()) {
-        std::cerr << "Input image is empty!" << std::endl;
-        return cv::Mat();
+    if (event == cv::EVENT_LBUTTONDOWN)
+    {
+        if (selectedPoints.size() < 4)
+        {
+            selectedPoints.emplace_back(cv::Point2f(x, y));
+            std::cout << "Point selected: (" << x << ", " << y << ")" << std::endl;
+
+            cv::Mat *img = static_cast<cv::Mat *>(userdata);
+            cv::circle(*img, cv::Point(x, y), 5, cv::Scalar(0, 0, 255), -1);
+            cv::imshow("Select Points", *img);
+        }
     }
+}
 
-    cv::Mat edge;
-    Canny(img, edge, 50, 150);
+void EdgeBLE::ensureConnected()
+{
+    if (socket_)
+    {
+        return;
+    }
 
-    std::vector<cv::Vec2f> lines;
-    cv::HoughLines(edge, lines, 1, CV_PI / 180, 250);
+    // 서버 주소 및 포트 설정
+    tcp::resolver resolver(io_context_);
+    auto endpoints = resolver.resolve(server_ip_, std::to_string(server_port_));
+    socket_ = std::make_unique<tcp::socket>(io_context_);
+    boost::asio::connect(*socket_, endpoints);
+
+    // 세션 모드 시작 알림
+    uint32_t magic = htonl(FRAME_SESSION_MAGIC);
+    boost::asio::write(*socket_, boost::asio::buffer(&magic, sizeof(magic)));
+
+    nextSeq_ = 0;
+    sendCredits_ = ackWindow_;
+    inFlight_.clear();
+    // 새 세션에는 스캔 결과를 다시 보내고, 결과 전용 모드면 키프레임부터 보냄
+    sentScanVersion_ = 0;
+    keyframeRequested_ = uplink_.mode == UplinkMode::Results;
+    qrCropRequested_ = false;
+    AZLOGDI("Session opened to %s:%d (window=%u)", "debug_log.txt", scanContext_, server_ip_.c_str(), server_port_, ackWindow_);
+}
 
-    cv::Mat dst;
-    cv::cvtColor(edge, dst, cv::COLOR_GRAY2BGR);
+void EdgeBLE::closeConnection()
+{
+    if (!socket_)
+    {
+        return;
+    }
 
-    for(size_t i=0; i<lines.size(); i++) {
-        float r = lines[i][0], t = lines[i][1];
-        double cos_t = cos(t), sin_t = sin(t);
-        double x0 = r*cos_t, y0 = r * sin_t;
-        double alpha = 1000;
+    boost::system::error_code ec;
+    socket_->shutdown(tcp::socket::shutdown_both, ec);
+    socket_->close(ec);
+    socket_.reset();
 
-        cv::Point pt1(cvRound(x0 + alpha * (-sin_t)), cvRound(y0 + alpha * cos_t));
-        cv::Point pt2(cvRound(x0 - alpha * (-sin_t)), cvRound(y0 - alpha * cos_t));
-        line(dst, pt1, pt2, cv::Scalar(0, 0, 255), 2, cv::LINE_AA);
+    if (!inFlight_.empty())
+    {
+        AZLOGDW("Session closed with %zu unacknowledged frames", "warning_log.txt", scanContext_, inFlight_.size());
+        inFlight_.clear();
     }
-
-    return dst;
 }
 
-cv::Mat EdgeBLE::hough_lines_optimized(const cv::Mat &img)
+// 도착한 ACK 를 처리. blocking 이면 최소 하나의 ACK 를 받을 때까지 대기
+void EdgeBLE::receiveAcks(bool blocking)
 {
-    if(img.empty()) {
-        std::cerr << "Input image is empty!" << std::endl;
-        return cv::Mat();
-    }
+    unsigned char buffer[ACK_MESSAGE_SIZE];
+    while (socket_ && (blocking || socket_->available() >= ACK_MESSAGE_SIZE))
+    {
+        boost::asio::read(*socket_, boost::asio::buffer(buffer, sizeof(buffer)));
+        blocking = false;
 
-    // Step 1: Noise reduction
-    cv::Mat blurred, edge;
-    cv::GaussianBlur(img, blurred, cv::Size(5, 5), 1.5);
-    cv::Canny(blurred, edge, 50, 150);
+        AckMessage ack = decodeAck(buffer);
+        if (ack.magic != FRAME_ACK_MAGIC)
+        {
+            throw std::runtime_error("Invalid ACK from server");
+        }
 
-    // Step 2: Hough Line Transform
-    std::vector<cv::Vec2f> lines;
-    cv::HoughLines(edge, lines, 1, CV_PI / 180, 450);
+        // 서버가 알려준 수용 가능 프레임 수로 전송 한도 갱신
+        sendCredits_ = ack.credits;
+        if (ack.status == static_cast<uint16_t>(AckStatus::Credit))
+        {
+            continue;
+        }
+        if (ack.status == static_cast<uint16_t>(AckStatus::TooLarge))
+        {
+            throw std::runtime_error("Server closed session: frame too large");
+        }
 
-    cv::Mat dst;
-    cv::cvtColor(edge, dst, cv::COLOR_GRAY2BGR);
+        auto it = inFlight_.find(ack.seq);
+        if (it == inFlight_.end())
+        {
+            AZLOGDW("Unexpected ACK for seq %u", "warning_log.txt", scanContext_, ack.seq);
+            continue;
+        }
 
-    // Step 3: Filter lines based on angle and position
-    for(size_t i = 0; i < lines.size(); i++) {
-        float r = lines[i][0], t = lines[i][1];
-        // Filter for near-vertical or near-horizontal lines
-        if (std::abs(t) < CV_PI / 18 || std::abs(t - CV_PI / 2) < CV_PI / 18) {
-            double cos_t = cos(t), sin_t = sin(t);
-            double x0 = r * cos_t, y0 = r * sin_t;
-            double alpha = 1000;
+        auto elapsed = std::chrono::steady_clock::now() - it->second;
+        auto rtt = std::chrono::duration_cast<std::chrono::microseconds>(elapsed);
+        inFlight_.erase(it);
+        edgeMetrics().ack.record(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+        edgeMetrics().framesAcked.add();
 
-            cv::Point pt1(cvRound(x0 + alpha * (-sin_t)), cvRound(y0 + alpha * cos_t));
-            cv::Point pt2(cvRound(x0 - alpha * (-sin_t)), cvRound(y0 - alpha * cos_t));
-            line(dst, pt1, pt2, cv::Scalar(0, 0, 255), 2, cv::LINE_AA);
+        if (ack.status == static_cast<uint16_t>(AckStatus::Keyframe))
+        {
+            // 결과 레코드는 정상 처리됨. 서버가 디코딩 못 한 QR 을 원본 해상도로 원함
+            qrCropRequested_ = true;
+            AZLOGDI("Server requested a QR crop (seq %u)", "debug_log.txt", scanContext_, ack.seq);
         }
+        else if (ack.status != static_cast<uint16_t>(AckStatus::Ok))
+        {
+            edgeMetrics().framesRefused.add();
+            AZLOGDW("Server rejected frame seq %u (status %d)", "warning_log.txt", scanContext_, ack.seq, ack.status);
+        }
+        AZLOGDD("ACK seq %u received in %lld us", "debug_log.txt", scanContext_, ack.seq, static_cast<long long>(rtt.count()));
     }
-
-    return dst;
 }
 
-
-void EdgeBLE::onMouse(int event, int x, int y, int flags, void *userdata)
+// 윈도우와 서버 credit 에 여유가 있으면 즉시 전송, 없으면 ACK 를 기다린 뒤 전송
+void EdgeBLE::sendFrame(const std::vector<uchar> &payload, FrameType type, uint16_t flags)
 {
-    if (event == cv::EVENT_LBUTTONDOWN)
+    ScopedTimer timer(edgeMetrics().send);
+    uint64_t startNs = metricsNowNs();
+    receiveAcks(false);
+    // credit 이 0 이어도 미확인 프레임이 없으면 하나는 보내서 교착을 피함 (서버가 거부할 수 있음)
     {
-        if (selectedPoints.size() < 4)
+        TRACE_SCOPE("ack_wait");
+        while (!inFlight_.empty() && (inFlight_.size() >= ackWindow_ || sendCredits_ == 0))
         {
-            selectedPoints.emplace_back(cv::Point2f(x, y));
-            std::cout << "Point selected: (" << x << ", " << y << ")" << std::endl;
-
-            cv::Mat *img = static_cast<cv::Mat *>(userdata);
-            cv::circle(*img, cv::Point(x, y), 5, cv::Scalar(0, 0, 255), -1);
-            cv::imshow("Select Points", *img);
+            receiveAcks(true);
         }
     }
+
+    FrameHeader header{static_cast<uint32_t>(payload.size()), nextSeq_++, static_cast<uint16_t>(type), flags};
+    unsigned char headerBuffer[FRAME_HEADER_SIZE];
+    encodeFrameHeader(header, headerBuffer);
+    TRACE_FRAME(header.seq); // 결과 + 키프레임처럼 한 프레임에서 여러 번 보내면 메시지마다 seq 가 다름
+
+    // 헤더와 페이로드를 한 번의 write 로 전송 (scatter-gather)
+    std::array<boost::asio::const_buffer, 2> buffers = {
+        boost::asio::buffer(headerBuffer, sizeof(headerBuffer)),
+        boost::asio::buffer(payload)};
+    {
+        TRACE_SCOPE("socket_write");
+        boost::asio::write(*socket_, buffers);
+    }
+    edgeMetrics().framesSent.add();
+    edgeMetrics().bytesSent.add(payload.size());
+
+    inFlight_.emplace(header.seq, std::chrono::steady_clock::now());
+    if (sendCredits_ > 0)
+    {
+        --sendCredits_;
+    }
+    sendNs_ += metricsNowNs() - startNs;
 }
 
-cv::Mat EdgeBLE::process_image_all_advanced(const cv::Mat &img)
+// 결과 전용 모드: 검출 결과 레코드를 보내고, 키프레임 주기가 됐으면 축소한 원본을, 서버가 요청했으면 QR crop 도 보냄
+void EdgeBLE::sendResults(const cv::Mat &image, const std::vector<QrDetection> &qrCodes, const AzScanContext::Snapshot &scans)
 {
-    if (img.empty()) {
-        std::cerr << "Error: Input image is empty!" << std::endl;
-        return cv::Mat();
-    }
+    FrameResults results;
+    results.captureUs = static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::system_clock::now().time_since_epoch()).count());
 
-    // Step 1: 그레이스케일 변환 및 대비 조정
-    cv::Mat gray, enhanced;
-    cv::cvtColor(img, gray, cv::COLOR_BGR2GRAY);
+    for (const auto &code : qrCodes)
+    {
+        QrResult qr;
+        qr.text = code.text;
+        for (size_t k = 0; k < 4; ++k)
+        {
+            qr.corners[2 * k] = code.corners[k].x;
+            qr.corners[2 * k + 1] = code.corners[k].y;
+        }
+        results.qrCodes.push_back(std::move(qr));
+    }
 
-    // CLAHE(Contrast Limited Adaptive Histogram Equalization) 적용
-    cv::Ptr<cv::CLAHE> clahe = cv::createCLAHE(2.0, cv::Size(8, 8));
-    clahe->apply(gray, enhanced);
+    {
+        ScopedTimer timer(edgeMetrics().process);
+        TRACE_SCOPE("process");
+        analyzeFrameResults(image, results, uplink_.maxBoxes, uplink_.minBoxArea, analysisLevels_);
+    }
 
-    // Step 2: 가우시안 블러 적용 (노이즈 제거)
-    cv::Mat blurred;
-    cv::GaussianBlur(enhanced, blurred, cv::Size(5, 5), 1.5);
+    // 스캔 결과는 바뀌었을 때만 포함
+    if (sentScanVersion_ != scans.version)
+    {
+        results.hasScans = true;
+        results.scans = scans.results;
+    }
 
-    // Step 3: Canny Edge Detection 수행
-    cv::Mat edges;
-    cv::Canny(blurred, edges, 50, 150);
+    std::vector<uchar> payload;
+    {
+        ScopedTimer timer(edgeMetrics().encode);
+        TRACE_SCOPE("encode_results");
+        encodeFrameResults(results, payload);
+    }
+    AZLOGDI("Sending results: %zu bytes, qr=%zu lines=%zu boxes=%zu scans=%d (seq %u)", "debug_log.txt", scanContext_,
+            payload.size(), results.qrCodes.size(), results.lines.size(), results.boxes.size(), results.hasScans, nextSeq_);
+    sendFrame(payload, FrameType::Results);
+    edgeMetrics().resultsSent.add();
+    if (results.hasScans)
+    {
+        sentScanVersion_ = scans.version;
+    }
 
-    // Step 4: Hough Line Transform 적용
-    std::vector<cv::Vec2f> lines;
-    cv::Mat lineImage = img.clone();
-    cv::HoughLines(edges, lines, 1, CV_PI / 180, 100);
+    ++resultsSinceKeyframe_;
+    if (keyframeRequested_ || (uplink_.keyframeEvery > 0 && resultsSinceKeyframe_ >= uplink_.keyframeEvery))
+    {
+        sendKeyframe(image);
+    }
+    if (qrCropRequested_)
+    {
+        sendQrCrop(image, qrCodes);
+    }
+}
 
-    for (size_t i = 0; i < lines.size(); i++) {
-        float rho = lines[i][0], theta = lines[i][1];
-        double a = cos(theta), b = sin(theta);
-        double x0 = a * rho, y0 = b * rho;
-        cv::Point pt1(cvRound(x0 + 1000 * (-b)), cvRound(y0 + 1000 * (a)));
-        cv::Point pt2(cvRound(x0 - 1000 * (-b)), cvRound(y0 - 1000 * (a)));
-        cv::line(lineImage, pt1, pt2, cv::Scalar(0, 0, 255), 2, cv::LINE_AA);
+void EdgeBLE::sendKeyframe(const cv::Mat &image)
+{
+    std::vector<uchar> buffer;
+    {
+        ScopedTimer timer(edgeMetrics().encode);
+        TRACE_SCOPE("imencode");
+        if (uplink_.keyframeWidth > 0 && image.cols > uplink_.keyframeWidth)
+        {
+            cv::Mat thumbnail;
+            int height = std::max(1, image.rows * uplink_.keyframeWidth / image.cols);
+            cv::resize(image, thumbnail, cv::Size(uplink_.keyframeWidth, height), 0, 0, cv::INTER_AREA);
+            cv::imencode(".jpg", thumbnail, buffer);
+        }
+        else
+        {
+            cv::imencode(".jpg", image, buffer);
+        }
     }
+    AZLOGDI("Sending keyframe: %zu bytes (seq %u)", "debug_log.txt", scanContext_, buffer.size(), nextSeq_);
+    sendFrame(buffer);
+    edgeMetrics().keyframesSent.add();
+    keyframeRequested_ = false;
+    resultsSinceKeyframe_ = 0;
+}
 
-    // Step 5: 형태학적 연산을 활용한 노이즈 제거
-    cv::Mat morphKernel = cv::getStructuringElement(cv::MORPH_RECT, cv::Size(3, 3));
-    cv::Mat morphProcessed;
-    cv::morphologyEx(edges, morphProcessed, cv::MORPH_CLOSE, morphKernel);
+// 디코딩 못 한 QR 들을 모두 덮는 영역을 여백과 함께 원본 해상도로 잘라 보냄. 축소한 키프레임으로는 모듈이 뭉개져
+// 서버도 디코딩할 수 없으므로 전체 프레임 대신 이 영역만 보냄. 현재 프레임에 그런 QR 이 없으면 요청을 버림
+void EdgeBLE::sendQrCrop(const cv::Mat &image, const std::vector<QrDetection> &qrCodes)
+{
+    qrCropRequested_ = false;
+    cv::Rect area;
+    for (const auto &code : qrCodes)
+    {
+        if (code.text.empty() && !code.corners.empty())
+        {
+            cv::Rect box = cv::boundingRect(code.corners);
+            int margin = std::max(8, std::max(box.width, box.height) / 4); // 조용한 영역 (4 모듈) 이상
+            box = cv::Rect(box.x - margin, box.y - margin, box.width + 2 * margin, box.height + 2 * margin);
+            area = area.empty() ? box : (area | box);
+        }
+    }
+    area &= cv::Rect(0, 0, image.cols, image.rows);
+    if (area.empty())
+    {
+        AZLOGDD("No undecoded QR in the current frame, skipping the requested crop", "debug_log.txt", scanContext_);
+        return;
+    }
 
-    // Step 6: 윤곽선 검출 및 강조
-    std::vector<std::vector<cv::Point>> contours;
-    std::vector<cv::Vec4i> hierarchy;
-    cv::Mat contourImage = img.clone();
-    cv::findContours(morphProcessed, contours, hierarchy, cv::RETR_EXTERNAL, cv::CHAIN_APPROX_SIMPLE);
-    cv::drawContours(contourImage, contours, -1, cv::Scalar(0, 255, 0), 2);
+    std::vector<uchar> payload(QR_CROP_HEADER_SIZE);
+    encodeQrCropHeader(QrCropHeader{static_cast<uint16_t>(area.x), static_cast<uint16_t>(area.y),
+                                    static_cast<uint16_t>(std::min(image.cols, 65535)),
+                                    static_cast<uint16_t>(std::min(image.rows, 65535))},
+                       payload.data());
+    {
+        ScopedTimer timer(edgeMetrics().encode);
+        TRACE_SCOPE("imencode");
+        std::vector<uchar> jpeg;
+        cv::imencode(".jpg", image(area), jpeg);
+        payload.insert(payload.end(), jpeg.begin(), jpeg.end());
+    }
+    AZLOGDI("Sending QR crop %dx%d at (%d, %d): %zu bytes (seq %u)", "debug_log.txt", scanContext_, area.width,
+            area.height, area.x, area.y, payload.size(), nextSeq_);
+    sendFrame(payload, FrameType::QrCrop);
+    edgeMetrics().qrCropsSent.add();
+}
 
-    // Step 7: 모든 이미지 크기 및 타입 맞추기
-    cv::Size targetSize(img.cols, img.rows);
+// 서버 처리 모드: 처리하지 않은 원본을 그대로 인코딩해 보냄 (서버가 image_ops 로 같은 처리를 수행)
+void EdgeBLE::sendRaw(const cv::Mat &image)
+{
+    std::vector<uchar> buffer;
+    {
+        ScopedTimer timer(edgeMetrics().encode);
+        TRACE_SCOPE("imencode");
+        cv::imencode(".jpg", image, buffer);
+    }
+    AZLOGDI("Sending raw frame for server processing: %zu bytes (seq %u)", "debug_log.txt", scanContext_, buffer.size(), nextSeq_);
+    sendFrame(buffer, FrameType::Jpeg, FRAME_FLAG_RAW);
+    edgeMetrics().framesOffloaded.add();
+}
 
-    std::vector<cv::Mat> images = {enhanced, edges, lineImage};
+// Edge 처리 모드: 처리한 합성 이미지를 JPEG 로 보냄
+void EdgeBLE::sendProcessed(const cv::Mat &image)
+{
+    // 새로운 이미지 처리 로직 적용
+    cv::Mat processedImage;
+    {
+        ScopedTimer timer(edgeMetrics().process);
+        TRACE_SCOPE("process");
+        processedImage = process_image_all_advanced(image, composite_, analysisLevels_);
+    }
 
-    for (auto &mat : images) {
-        // 1. 크기 통일
-        if (mat.size() != targetSize) {
-            cv::resize(mat, mat, targetSize);
-        }
+    // 1. 이미지가 비어 있으면 오류 출력 후 종료
+    if (processedImage.empty()) {
+        AZLOGDE("Error: Processed image is empty", "error_log.txt", scanContext_);
+        std::cerr << "Error: Processed image is empty!" << std::endl;
+        return;
+    }
 
-        // 2. 채널 개수 통일
-        if (mat.channels() == 1) {
-            cv::cvtColor(mat, mat, cv::COLOR_GRAY2BGR);
-        } else if (mat.channels() != 3) {
-            std::cerr << "Unexpected channel count: " << mat.channels() << std::endl;
-            return cv::Mat();
-        }
+    // 2. 정확한 타입 변환 수행 (합성 캔버스는 이미 BGR 이므로 복사하지 않고 바로 인코딩)
+    cv::Mat finalImage;
+    if (processedImage.channels() == 1) {
+        cv::cvtColor(processedImage, finalImage, cv::COLOR_GRAY2BGR);
+    } else if (processedImage.channels() == 3) {
+        finalImage = processedImage;
+    } else {
+        AZLOGDE("Unexpected number of channels: %d", "error_log.txt", scanContext_, processedImage.channels());
+        std::cerr << "Unexpected number of channels: " << processedImage.channels() << std::endl;
+        return;
+    }
 
-        // 3. 데이터 타입 통일 (CV_8UC3)
-        if (mat.type() != CV_8UC3) {
-            mat.convertTo(mat, CV_8UC3);
-        }
+    // 3. 최종 이미지를 서버로 전송
+    std::vector<uchar> buffer;
+    {
+        ScopedTimer timer(edgeMetrics().encode);
+        TRACE_SCOPE("imencode");
+        cv::imencode(".jpg", finalImage, buffer);
     }
 
-    // Step 8: 최종 이미지 병합
-    cv::Mat finalResult;
-    cv::hconcat(images, finalResult);
+    AZLOGDI("Sending image size: %zu bytes (seq %u)", "debug_log.txt", scanContext_, buffer.size(), nextSeq_);
 
-    return finalResult;
+    sendFrame(buffer);
+
+    AZLOGDI("Image sent successfully.", "debug_log.txt", scanContext_);
 }
 
 void EdgeBLE::sendImageToServer()
 {
     std::lock_guard<std::mutex> lock(bleMutex);
 
-    if (scanResults.empty())
+    // 스캔 결과는 이 시점의 스냅숏만 사용 (scanMutex_ 를 잡지 않으므로 전송 중에도 집계가 계속됨)
+    std::shared_ptr<const AzScanContext::Snapshot> scans = scanContext_.snapshot();
+    if (scans->results.empty())
     {
-        AZLOGDW("No scan results available to send. Check if setScanResults was called.", "warning_log.txt", scanResults);
+        AZLOGDW("No scan results available to send. Check if setScanResults was called.", "warning_log.txt", scanContext_);
         return;
     }
 
     try
     {
-        boost::asio::io_context io_context;
-
-        // 서버 주소 및 포트 설정
-        tcp::resolver resolver(io_context);
-        auto endpoints = resolver.resolve(server_ip_, std::to_string(server_port_));
-        auto socket = std::make_shared<tcp::socket>(io_context);
-        boost::asio::connect(*socket, endpoints);
+        ensureConnected();
 
-        cv::Mat image = cv::imread("building.jpg");
+        // 이 프레임의 구간들은 첫 메시지의 seq 로 묶음 (서버 트레이스와 합칠 때 기준)
+        TRACE_FRAME(nextSeq_);
+        TRACE_SCOPE("frame");
+        cv::Mat image;
+        {
+            TRACE_SCOPE("imread");
+            image = cv::imread("building.jpg");
+        }
         if (image.empty())
         {
-            AZLOGDE("Failed to load image from sample.jpg", "error_log.txt", scanResults);
+            AZLOGDE("Failed to load image from sample.jpg", "error_log.txt", scanContext_);
             std::cerr << "Failed to load image from sample.jpg" << std::endl;
             return;
         }
 
-        // 새로운 이미지 처리 로직 적용
-        cv::Mat processedImage = process_image_all_advanced(image);
+        // 프레임 연산 시간 = 전체 - 소켓 전송/ACK 대기 (네트워크 지연으로 처리 위치를 바꾸지 않도록)
+        uint64_t startNs = metricsNowNs();
+        uint64_t sendNsBefore = sendNs_;
 
-        // 1. 이미지가 비어 있으면 오류 출력 후 종료
-        if (processedImage.empty()) {
-            AZLOGDE("Error: Processed image is empty", "error_log.txt", scanResults);
-            std::cerr << "Error: Processed image is empty!" << std::endl;
-            return;
+        if (offload_.offloaded())
+        {
+            sendRaw(image);
         }
-
-        // 2. 정확한 타입 변환 수행
-        cv::Mat finalImage;
-        if (processedImage.channels() == 1) {
-            cv::cvtColor(processedImage, finalImage, cv::COLOR_GRAY2BGR);
-        } else if (processedImage.channels() == 3) {
-            finalImage = processedImage.clone();
-        } else {
-            AZLOGDE("Unexpected number of channels: %d", "error_log.txt", scanResults, processedImage.channels());
-            std::cerr << "Unexpected number of channels: " << processedImage.channels() << std::endl;
-            return;
+        else
+        {
+            // QR 코드 검출 (추적 중인 코드는 예측 ROI 만 재확인, 필요할 때만 피라미드 파인더 탐색)
+            std::vector<QrDetection> qrCodes;
+            {
+                ScopedTimer timer(edgeMetrics().qr);
+                TRACE_SCOPE("qr_detect");
+                qrCodes = qrDetect_.detect(image);
+            }
+            edgeMetrics().qrCodes.add(qrCodes.size());
+            const QrDetectStats &qrStats = qrDetect_.lastStats();
+            AZLOGDI("QR scan: searched=%d candidates=%zu dropped=%zu rois=%zu area=%.3f codes=%zu tracked=%zu lost=%zu",
+                    "debug_log.txt", scanContext_, qrStats.searched, qrStats.candidates, qrStats.dropped, qrStats.rois,
+                    qrStats.roiFraction, qrCodes.size(), qrStats.tracked, qrStats.lost);
+            for (const auto &code : qrCodes)
+            {
+                AZLOGDI("QR code: \"%s\" at (%.0f, %.0f) track %u", "debug_log.txt", scanContext_, code.text.c_str(),
+                        code.corners[0].x, code.corners[0].y, code.track);
+            }
+
+            if (uplink_.mode == UplinkMode::Results)
+            {
+                sendResults(image, qrCodes, *scans);
+            }
+            else
+            {
+                sendProcessed(image);
+            }
         }
 
-        // 3. 최종 이미지를 서버로 전송
-        std::vector<uchar> buffer;
-        cv::imencode(".jpg", finalImage, buffer);
-        std::string image_data(buffer.begin(), buffer.end());
-
-        uint32_t data_size = static_cast<uint32_t>(image_data.size());
-        uint32_t data_size_network_order = htonl(data_size);
-
-        AZLOGDI("Sending image size: %d bytes", "debug_log.txt", scanResults, data_size);
-
-        boost::asio::write(*socket, boost::asio::buffer(&data_size_network_order, sizeof(data_size_network_order)));
-        boost::asio::write(*socket, boost::asio::buffer(image_data));
-
-        AZLOGDI("Image sent successfully.", "debug_log.txt", scanResults);
-
+        uint64_t computeNs = metricsNowNs() - startNs - (sendNs_ - sendNsBefore);
+        edgeMetrics().compute.record(computeNs);
+        if (offload_.record(computeNs))
+        {
+            edgeMetrics().processingSwitches.add();
+            AZLOGDI("Processing moved to %s: cpu=%.2f deadline misses=%.2f frame=%.1f ms", "debug_log.txt", scanContext_,
+                    offload_.offloaded() ? "server" : "edge", offload_.cpuLoad(), offload_.missRate(), computeNs / 1e6);
+        }
+        if (cv::Mat::getDefaultAllocator() == &MatPool::instance())
+        {
+            MatPoolStats pool = MatPool::instance().stats();
+            AZLOGDD("Mat pool: hits=%llu misses=%llu fallbacks=%llu owned=%zu cached=%zu", "debug_log.txt", scanContext_,
+                    static_cast<unsigned long long>(pool.hits), static_cast<unsigned long long>(pool.misses),
+                    static_cast<unsigned long long>(pool.fallbacks), pool.ownedBytes, pool.cachedBytes);
+        }
     }
     catch (const std::exception &e)
     {
-        AZLOGDE("Error in sendImageToServer: %s", "error_log.txt", scanResults, e.what());
+        AZLOGDE("Error in sendImageToServer: %s", "error_log.txt", scanContext_, e.what());
         std::cerr << "Error in sendImageToServer: " << e.what() << std::endl;
+        // 다음 전송에서 새 세션으로 재연결
+        closeConnection();
     }
 }
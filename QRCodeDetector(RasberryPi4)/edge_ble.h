@@ -10,7 +10,69 @@
 #include <chrono>
 #include <string>
 #include <thread>
+#include <map>
+#include <sstream>
+#include <boost/asio.hpp>
 #include "scan_result.h"
+#include "scan_aggregator.h"
+#include "scan_source.h"
+#include "qr_detect.h"
+#include "azlog.h"
+#include "frame_protocol.h"
+#include "frame_results.h"
+#include "image_ops.h"
+#include "offload_policy.h"
+
+// 서버로 올려 보내는 내용
+enum class UplinkMode
+{
+    Frames,  // 처리된 합성 이미지를 매번 JPEG 로 전송 (기존 동작)
+    Results, // 검출 결과 레코드만 전송, 전체 프레임은 키프레임 주기 때만 (서버가 요청하면 QR 부분만 원본 해상도로)
+};
+
+struct UplinkConfig
+{
+    UplinkMode mode = UplinkMode::Frames;
+    int keyframeEvery = 30;   // 결과 레코드 N 개마다 키프레임 하나 (0 이면 새 세션 때만)
+    int keyframeWidth = 320;  // 키프레임 너비 (0 이면 원본 크기, 비율 유지)
+    size_t maxBoxes = 256;    // 레코드에 넣을 윤곽선 사각형 최대 수 (면적 큰 순)
+    int minBoxArea = 64;      // 이보다 작은 윤곽선 사각형은 제외 (px^2)
+};
+
+// "results,keyframe=30,width=320,boxes=256,min-area=64" 또는 "frames" 형식 파싱. 알 수 없는 값이 있으면 false
+static inline bool parseUplinkConfig(const std::string &text, UplinkConfig &config)
+{
+    std::stringstream stream(text);
+    std::string item;
+    while (std::getline(stream, item, ','))
+    {
+        size_t eq = item.find('=');
+        if (item.empty())
+            continue;
+        if (item == "frames")
+            config.mode = UplinkMode::Frames;
+        else if (item == "results")
+            config.mode = UplinkMode::Results;
+        else if (eq == std::string::npos)
+            return false;
+        else
+        {
+            std::string key = item.substr(0, eq);
+            int value = std::atoi(item.c_str() + eq + 1);
+            if (key == "keyframe")
+                config.keyframeEvery = std::max(0, value);
+            else if (key == "width")
+                config.keyframeWidth = std::max(0, value);
+            else if (key == "boxes")
+                config.maxBoxes = static_cast<size_t>(std::max(0, value));
+            else if (key == "min-area")
+                config.minBoxArea = std::max(0, value);
+            else
+                return false;
+        }
+    }
+    return true;
+}
 
 class EdgeBLE
 {
@@ -22,31 +84,91 @@ public:
     void stopScanning();
     void setScanResults(const std::vector<ScanResult> &results);
 
-    cv::Mat calcGrayHist(const cv::Mat &img);
-    cv::Mat getGrayHistImage(const cv::Mat &hist);
-    cv::Mat filter_embossing(const cv::Mat &img);
-    cv::Mat blurring_mean(const cv::Mat &img);
-    cv::Mat blurring_affine_Transform(const cv::Mat &img);
+    // 스캔 배치를 집계 단계에 추가 (batch 는 scanIds() 로 만든 것이어야 함)
+    // 창(기본 5초)이 닫힐 때마다 중복이 제거된 요약이 전송/로그용 스캔 결과가 됨
+    void addSightings(const ScanBatch &batch);
+    ScanIdTable &scanIds() { return scanIds_; }
+
+    // 스캔 입력 소스 지정 (startScanning 이전). 스캔 중에는 interval 마다 소스를 읽어 addSightings 로 넘김
+    void setScanSource(std::unique_ptr<ScanSource> source, std::chrono::milliseconds interval = std::chrono::milliseconds(100));
+
+    // ACK 를 기다리지 않고 연속 전송할 수 있는 최대 미확인 프레임 수
+    void setAckWindow(uint32_t window);
+
+    // 업링크 모드 (기본: 매 프레임 JPEG)
+    void setUplink(const UplinkConfig &config);
+
+    // 프레임 처리 위치 (기본: Edge). 서버 처리면 원본 JPEG 를 FRAME_FLAG_RAW 로 보냄
+    void setProcessing(const ProcessingConfig &config);
+
+    // Edge 처리 때 전송하는 합성 이미지 배치 (기본: 대비 | 에지 | 직선)
+    void setComposite(const CompositeLayout &layout);
+
+    // Edge 처리 / 결과 전용 모드의 분석 해상도 (pyrDown 횟수, 0 = 원본). 결과 좌표는 항상 원본 기준
+    void setAnalysisLevels(int levels);
+
+    // 처리 함수는 image_ops.h (서버와 공유). 투시 변환 점 선택만 GUI 가 필요해 여기 남음
     cv::Mat event_lbuttondown(const cv::Mat &img);
-    cv::Mat hough_lines(const cv::Mat &img);
-    cv::Mat hough_lines_optimized(const cv::Mat &img);
-    cv::Mat process_image_all_advanced(const cv::Mat &img);
 
 private:
     void scanBLEDevices();
+    void runScanSource();
     void sendImageToServer();
 
+    // 서버와의 세션 연결 관리 (연결 유지 + 파이프라인 ACK)
+    void ensureConnected();
+    void closeConnection();
+    void sendFrame(const std::vector<uchar> &payload, FrameType type = FrameType::Jpeg, uint16_t flags = 0);
+    void sendProcessed(const cv::Mat &image);
+    void sendResults(const cv::Mat &image, const std::vector<QrDetection> &qrCodes, const AzScanContext::Snapshot &scans);
+    void sendKeyframe(const cv::Mat &image);
+    void sendQrCrop(const cv::Mat &image, const std::vector<QrDetection> &qrCodes);
+    void sendRaw(const cv::Mat &image);
+    void receiveAcks(bool blocking);
+    void addSightingsLocked(const ScanBatch &batch);
+
     bool running;
 
     static void onMouse(int event, int x, int y, int flags, void *userdata);
     static std::vector<cv::Point2f> selectedPoints;
 
     std::shared_ptr<std::thread> scanningThread;
-    std::mutex bleMutex;
+    std::mutex bleMutex; // 연결 / 전송 상태 (전송 스레드가 프레임 처리 내내 잡음)
+
+    // 스캔 집계 상태는 scanMutex_ 로 따로 보호. 전송 중에도 스캔 스레드의 addSightings 가 막히지 않도록 전송 스레드는
+    // scanContext_ 의 스냅숏만 읽음
+    std::mutex scanMutex_;
     std::vector<ScanResult> scanResults;
+    AzScanContext scanContext_; // 로그 / 전송용 스캔 결과 (창이 닫힐 때만 직렬화, 스냅숏은 잠금 없이 읽음)
+    ScanIdTable scanIds_;
+    ScanBatch scanBatch_{scanIds_}; // setScanResults 입력 변환용 (호출마다 재사용)
+    ScanAggregator scanAggregator_;
+    ScanWindow scanWindow_;
+    std::unique_ptr<ScanSource> scanSource_;
+    std::chrono::milliseconds scanInterval_{100};
+    std::shared_ptr<std::thread> scanSourceThread;
+    QrDetectStage qrDetect_; // 전송 스레드 전용 (bleMutex 안에서만 사용)
+    CompositeCanvas composite_; // 전송 스레드 전용. 합성 이미지를 프레임마다 같은 버퍼에 그림
+    int analysisLevels_ = 0;    // bleMutex 보호
 
     std::string server_ip_;
     unsigned short server_port_;
+
+    boost::asio::io_context io_context_;
+    std::unique_ptr<boost::asio::ip::tcp::socket> socket_;
+    uint32_t nextSeq_ = 0;
+    uint32_t ackWindow_ = FRAME_DEFAULT_WINDOW;
+    uint32_t sendCredits_ = FRAME_DEFAULT_WINDOW; // 마지막 ACK 이후 서버가 허용한 추가 전송 가능 프레임 수
+    std::map<uint32_t, std::chrono::steady_clock::time_point> inFlight_; // seq -> 전송 시각
+
+    UplinkConfig uplink_;
+    int resultsSinceKeyframe_ = 0;
+    bool keyframeRequested_ = false; // 새 세션 -> 다음 전송 때 키프레임
+    bool qrCropRequested_ = false;   // 서버가 디코딩 못 한 QR 을 요청 -> 다음 전송 때 원본 해상도 crop
+    uint64_t sentScanVersion_ = 0;   // 서버에 마지막으로 보낸 scanContext_ 스냅숏 버전 (새 세션이면 0)
+
+    OffloadPolicy offload_;
+    uint64_t sendNs_ = 0; // sendFrame 누적 시간 (프레임 연산 시간에서 전송 대기를 빼는 데 사용)
 };
 
 #endif // EDGE_BLE_H
@@ -1,12 +1,50 @@
+#include <cstdlib>
 #include <iostream>
 #include <memory>
 #include <string>
 #include "azlog.h"
 #include "edge_ble.h"
 #include "scan_result.h"
+#include "metrics.h"
+#include "mat_pool.h"
+#include "trace.h"
 
 int main()
 {
+    // 로그 레벨 설정 (없으면 컴파일 시 AZLOGD_LEVEL). 실행 중 SIGHUP 으로 다시 읽고 SIGUSR1/SIGUSR2 로 레벨 조정
+    const char *logConfig = std::getenv("AZLOG_CONFIG");
+    std::string logConfigPath = logConfig && *logConfig ? logConfig : "azlog.conf";
+    AzLogLevels::instance().loadConfig(logConfigPath);
+    AzLogLevels::instance().installSignalHandlers(logConfigPath);
+
+    // 로그 기록을 백그라운드 스레드로 넘겨 스캔/전송 경로가 디스크 I/O 를 기다리지 않도록 함
+    // (종료 시 남은 로그는 자동으로 모두 기록됨)
+    // AZLOG_BINARY 환경 변수가 있으면 바이너리 모드로 기록하고 나중에 azlog_decode 로 변환
+    if (std::getenv("AZLOG_BINARY"))
+    {
+        AzBinaryLogger::instance().start();
+    }
+    else
+    {
+        AzAsyncLogger::instance().start();
+    }
+
+    // 처리 함수들의 Mat 버퍼를 크기 등급별로 재사용해 프레임마다 malloc / 페이지 폴트가 생기지 않도록 함
+    // EDGE_MAT_POOL 로 조정 (예: "cap-mb=64,max-block-mb=16,thread-blocks=4"), "off" 면 표준 할당자
+    MatPoolConfig poolConfig;
+    const char *matPool = std::getenv("EDGE_MAT_POOL");
+    if (matPool && !parseMatPoolConfig(matPool, poolConfig))
+    {
+        AZLOGDW("Invalid EDGE_MAT_POOL: %s (using defaults for unknown keys)", "warning_log.txt", {}, matPool);
+    }
+    if (poolConfig.capBytes > 0)
+    {
+        MatPool::instance().configure(poolConfig);
+        MatPool::instance().install();
+        AZLOGDI("Mat pool installed: cap %zu MB, max block %zu MB", "debug_log.txt", {}, poolConfig.capBytes >> 20,
+                poolConfig.maxBlock >> 20);
+    }
+
     try
     {
         // 서버 IP와 포트를 설정
@@ -20,11 +58,98 @@ int main()
         result.logList.push_back({"Server_1", 12345});
         scanResults.push_back(result);
 
+        // 단계별 지연 시간/카운터를 10초마다 Prometheus 텍스트 포맷으로 기록
+        MetricsFileDumper metricsDumper("edge_metrics.prom", std::chrono::seconds(10));
+
+#if FRAME_TRACE
+        // EDGE_TRACE 가 있으면 프레임 단계별 트레이스를 그 경로에 10초마다 Chrome trace JSON 으로 기록
+        // (서버의 --trace 결과와 trace_merge 로 합침)
+        std::unique_ptr<TraceFileDumper> traceDumper;
+        const char *tracePath = std::getenv("EDGE_TRACE");
+        if (tracePath && *tracePath)
+        {
+            FrameTracer::instance().start("edge");
+            traceDumper = std::make_unique<TraceFileDumper>(tracePath, std::chrono::seconds(10));
+            AZLOGDI("Frame trace enabled: %s", "debug_log.txt", {}, tracePath);
+        }
+#else
+        if (std::getenv("EDGE_TRACE"))
+        {
+            AZLOGDW("EDGE_TRACE ignored: built without FRAME_TRACE", "warning_log.txt", {});
+        }
+#endif
+
         // BLE 서비스 초기화
         auto bleService = std::make_shared<EdgeBLE>(server_ip, server_port);
 
-        // Set scan results
-        bleService->setScanResults(scanResults);
+        // EDGE_SCAN_SIM 이 있으면 합성 BLE 스캔 소스로 광고를 계속 생성 (예: "hubs=4,devices=200,rate=10000,churn=0.05,dup=0.3")
+        // 없으면 고정된 스캔 결과 하나를 사용
+        const char *scanSim = std::getenv("EDGE_SCAN_SIM");
+        if (scanSim)
+        {
+            SyntheticScanConfig simConfig;
+            if (!parseSyntheticScanConfig(scanSim, simConfig))
+            {
+                AZLOGDW("Invalid EDGE_SCAN_SIM: %s (using defaults for unknown keys)", "warning_log.txt", {}, scanSim);
+            }
+            bleService->setScanSource(std::make_unique<SyntheticScanSource>(simConfig));
+            scanResults.clear();
+        }
+        else
+        {
+            // Set scan results
+            bleService->setScanResults(scanResults);
+        }
+
+        // EDGE_UPLINK=results 이면 JPEG 대신 검출 결과 레코드만 전송 (예: "results,keyframe=30,width=320")
+        const char *uplink = std::getenv("EDGE_UPLINK");
+        if (uplink)
+        {
+            UplinkConfig uplinkConfig;
+            if (!parseUplinkConfig(uplink, uplinkConfig))
+            {
+                AZLOGDW("Invalid EDGE_UPLINK: %s (using defaults for unknown keys)", "warning_log.txt", {}, uplink);
+            }
+            bleService->setUplink(uplinkConfig);
+        }
+
+        // EDGE_COMPOSITE 로 전송 합성 이미지 배치 선택 (예: "grid" 는 대비/에지/직선/윤곽선 2x2)
+        const char *composite = std::getenv("EDGE_COMPOSITE");
+        if (composite)
+        {
+            CompositeLayout layout;
+            if (!parseCompositeLayout(composite, layout))
+            {
+                AZLOGDW("Invalid EDGE_COMPOSITE: %s (using defaults for unknown keys)", "warning_log.txt", {}, composite);
+            }
+            bleService->setComposite(layout);
+        }
+
+        // EDGE_ANALYSIS_SCALE 로 분석 해상도 선택: full(기본) / half
+        // 검출만 줄인 영상에서 하고 직선 / 윤곽선은 원본 좌표로 그리고 보냄
+        const char *analysisScale = std::getenv("EDGE_ANALYSIS_SCALE");
+        if (analysisScale)
+        {
+            int levels = 0;
+            if (!parseAnalysisScale(analysisScale, levels))
+            {
+                AZLOGDW("Invalid EDGE_ANALYSIS_SCALE: %s (using full)", "warning_log.txt", {}, analysisScale);
+            }
+            bleService->setAnalysisLevels(levels);
+        }
+
+        // EDGE_PROCESSING 으로 처리 위치 선택: edge(기본) / server / auto (예: "auto,deadline-ms=1000,cpu-high=0.85")
+        // server 또는 auto 로 넘어간 동안에는 원본 JPEG 만 보내고 서버가 같은 처리를 수행
+        const char *processing = std::getenv("EDGE_PROCESSING");
+        if (processing)
+        {
+            ProcessingConfig processingConfig;
+            if (!parseProcessingConfig(processing, processingConfig))
+            {
+                AZLOGDW("Invalid EDGE_PROCESSING: %s (using defaults for unknown keys)", "warning_log.txt", {}, processing);
+            }
+            bleService->setProcessing(processingConfig);
+        }
 
         // Logging after scanResults initialization
         AZLOGDI("BLE 서비스 초기화 중: 서버 IP=%s, 포트=%d", "info_log.txt", scanResults, server_ip.c_str(), server_port);
@@ -0,0 +1,348 @@
+#ifndef MAT_POOL_H
+#define MAT_POOL_H
+
+#include <opencv2/opencv.hpp>
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <mutex>
+#include <new>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "metrics.h"
+
+// 크기 등급별로 블록을 재사용하는 cv::MatAllocator (Edge 파이프라인용)
+//
+// 처리 함수들은 프레임마다 같은 크기의 출력 / 임시 Mat 을 만들고 버리므로, 해제된 블록을 크기 등급별로 보관했다가
+// 다음 프레임의 같은 등급 요청에 돌려줌. 기본 할당자로 설치하면 함수 코드를 바꾸지 않고 프레임당 malloc 이 거의 0 이 됨.
+//   - 등급: 256 B 부터 2의 거듭제곱 구간마다 4 단계 (낭비 최대 25%). maxBlock 보다 큰 요청은 표준 할당자로
+//   - 블록 앞쪽(64 B 정렬)에 UMatData 를 placement new 로 두어 Mat 하나당 풀 연산 한 번 (헤더용 new 도 없음)
+//   - 해제된 블록은 먼저 스레드별 캐시(등급당 threadBlocks 개)로, 넘치면 전역 목록(뮤텍스)으로 감
+//   - 풀이 시스템에서 받은 바이트(사용 중 + 보관)가 capBytes 를 넘게 되면 전역 목록의 큰 블록부터 돌려주고,
+//     그래도 넘으면 그 요청은 표준 할당자로 처리 (메모리 상한)
+// 한 번 설치한 풀은 그 풀로 만든 Mat 이 모두 사라질 때까지 살아 있어야 하므로 프로세스 수명 동안 유지하는 단일 인스턴스.
+
+struct MatPoolConfig
+{
+    size_t capBytes = 64u << 20; // 풀이 가질 수 있는 최대 바이트 (0 이면 풀을 쓰지 않고 모두 표준 할당자)
+    size_t maxBlock = 16u << 20; // 이보다 큰 Mat 은 풀에 넣지 않음
+    size_t threadBlocks = 4;     // 스레드별 캐시에 등급당 보관할 블록 수
+};
+
+// "cap-mb=64,max-block-mb=16,thread-blocks=4" 또는 "off" 형식. 알 수 없는 값이 있으면 false
+static inline bool parseMatPoolConfig(const std::string &text, MatPoolConfig &config)
+{
+    std::stringstream stream(text);
+    std::string item;
+    while (std::getline(stream, item, ','))
+    {
+        size_t eq = item.find('=');
+        if (item.empty())
+            continue;
+        if (item == "off")
+            config.capBytes = 0;
+        else if (eq == std::string::npos)
+            return false;
+        else
+        {
+            std::string key = item.substr(0, eq);
+            long long value = std::max(0LL, std::atoll(item.c_str() + eq + 1));
+            if (key == "cap-mb")
+                config.capBytes = static_cast<size_t>(value) << 20;
+            else if (key == "max-block-mb")
+                config.maxBlock = std::max<size_t>(1, static_cast<size_t>(value)) << 20;
+            else if (key == "thread-blocks")
+                config.threadBlocks = static_cast<size_t>(value);
+            else
+                return false;
+        }
+    }
+    return true;
+}
+
+struct MatPoolStats
+{
+    uint64_t allocations = 0; // 풀이 처리한 Mat 할당 수
+    uint64_t hits = 0;        // 그중 보관 블록을 재사용한 수
+    uint64_t misses = 0;      // 새 블록을 시스템에서 받은 수
+    uint64_t fallbacks = 0;   // 너무 크거나 상한 초과로 표준 할당자에 넘긴 수
+    uint64_t released = 0;    // 상한 때문에 시스템에 돌려준 블록 수
+    size_t ownedBytes = 0;    // 풀이 시스템에서 받아 가진 바이트 (사용 중 + 보관)
+    size_t cachedBytes = 0;   // 그중 보관 중 (스레드 캐시 + 전역 목록)
+    size_t peakBytes = 0;     // ownedBytes 최댓값
+};
+
+class MatPool : public cv::MatAllocator
+{
+public:
+    static MatPool &instance()
+    {
+        static MatPool *pool = new MatPool(); // 종료 시점에도 남은 Mat / 스레드 캐시가 쓸 수 있도록 해제하지 않음
+        return *pool;
+    }
+
+    // install 이전에 호출 (설치 후에는 capBytes 만 바꾸는 것이 안전)
+    void configure(const MatPoolConfig &config)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        config_ = config;
+        classes_ = classIndex(config.maxBlock) + 1;
+        if (global_.size() < classes_)
+        {
+            global_.resize(classes_);
+        }
+    }
+
+    const MatPoolConfig &config() const { return config_; }
+
+    // 이후 만들어지는 모든 Mat 이 풀을 사용 (기존 Mat 은 원래 할당자로 해제됨)
+    void install() { cv::Mat::setDefaultAllocator(this); }
+    void uninstall() { cv::Mat::setDefaultAllocator(cv::Mat::getStdAllocator()); }
+
+    MatPoolStats stats() const
+    {
+        MatPoolStats stats;
+        stats.allocations = allocations_.value();
+        stats.hits = hits_.value();
+        stats.misses = misses_.value();
+        stats.fallbacks = fallbacks_.value();
+        stats.released = released_.value();
+        stats.ownedBytes = owned_.load(std::memory_order_relaxed);
+        stats.cachedBytes = cached_.load(std::memory_order_relaxed);
+        stats.peakBytes = peak_.load(std::memory_order_relaxed);
+        return stats;
+    }
+
+    // 전역 목록의 보관 블록을 모두 시스템에 돌려줌 (스레드 캐시는 각 스레드 종료 시 전역으로 옮겨짐)
+    void trim()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        releaseLocked(SIZE_MAX);
+    }
+
+    cv::UMatData *allocate(int dims, const int *sizes, int type, void *data, size_t *step, cv::AccessFlag flags,
+                           cv::UMatUsageFlags usageFlags) const override
+    {
+        size_t total = CV_ELEM_SIZE(type);
+        for (int i = dims - 1; i >= 0; i--)
+        {
+            if (step && !data)
+            {
+                step[i] = total;
+            }
+            total *= sizes[i];
+        }
+
+        // 사용자 버퍼를 감싸는 경우(드묾)와 너무 큰 Mat 은 표준 할당자로
+        size_t bytes = HEADER_SIZE + total;
+        if (data || bytes > config_.maxBlock || config_.capBytes == 0)
+        {
+            fallbacks_.add();
+            return cv::Mat::getStdAllocator()->allocate(dims, sizes, type, data, step, flags, usageFlags);
+        }
+
+        size_t index = classIndex(bytes);
+        void *block = take(index);
+        if (!block)
+        {
+            fallbacks_.add();
+            return cv::Mat::getStdAllocator()->allocate(dims, sizes, type, data, step, flags, usageFlags);
+        }
+        allocations_.add();
+
+        cv::UMatData *u = new (block) cv::UMatData(this);
+        u->data = u->origdata = static_cast<uchar *>(block) + HEADER_SIZE;
+        u->size = total;
+        u->allocatorFlags_ = static_cast<int>(index);
+        return u;
+    }
+
+    bool allocate(cv::UMatData *u, cv::AccessFlag, cv::UMatUsageFlags) const override
+    {
+        return u != nullptr;
+    }
+
+    void deallocate(cv::UMatData *u) const override
+    {
+        if (!u)
+        {
+            return;
+        }
+        CV_Assert(u->urefcount == 0);
+        CV_Assert(u->refcount == 0);
+        size_t index = static_cast<size_t>(u->allocatorFlags_);
+        u->~UMatData();
+        give(index, u);
+    }
+
+private:
+    static constexpr size_t HEADER_SIZE = (sizeof(cv::UMatData) + 63) / 64 * 64;
+    static constexpr size_t MIN_CLASS = 256;
+
+    // 스레드별 보관 블록. 스레드가 끝나면 전역 목록으로 옮김
+    struct ThreadCache
+    {
+        std::vector<std::vector<void *>> lists;
+        bool *exited;
+        ~ThreadCache()
+        {
+            MatPool::instance().flush(*this);
+            *exited = true;
+        }
+    };
+
+    MatPool() : MatPool(MetricsRegistry::instance()) {}
+    explicit MatPool(MetricsRegistry &registry)
+        : allocations_(registry.counter("edge_mat_pool_allocations_total", "Mat buffers served by the pooled allocator")),
+          hits_(registry.counter("edge_mat_pool_hits_total", "Mat buffers served from a cached block")),
+          misses_(registry.counter("edge_mat_pool_misses_total", "Mat buffers that needed a new block from the system")),
+          fallbacks_(registry.counter("edge_mat_pool_fallbacks_total", "Mat buffers passed to the standard allocator (too large or over the cap)")),
+          released_(registry.counter("edge_mat_pool_released_total", "Cached blocks returned to the system to stay under the cap"))
+    {
+        configure(MatPoolConfig());
+    }
+
+    // 256 B 이하는 0, 그 위로는 (2^p, 2^(p+1)] 구간을 4 단계로 나눔
+    static size_t classIndex(size_t bytes)
+    {
+        if (bytes <= MIN_CLASS)
+        {
+            return 0;
+        }
+        size_t p = 63 - static_cast<size_t>(__builtin_clzll(bytes - 1));
+        size_t q = (bytes + (size_t(1) << (p - 2)) - 1) >> (p - 2); // 5..8
+        return 1 + (p - 8) * 4 + (q - 5);
+    }
+
+    static size_t classSize(size_t index)
+    {
+        if (index == 0)
+        {
+            return MIN_CLASS;
+        }
+        size_t i = index - 1;
+        return (5 + i % 4) << (8 + i / 4 - 2);
+    }
+
+    // 스레드 종료 처리 중(캐시 소멸 후)에 해제되는 Mat 은 전역 목록을 바로 사용
+    static ThreadCache *threadCache()
+    {
+        thread_local bool exited = false;
+        if (exited)
+        {
+            return nullptr;
+        }
+        thread_local ThreadCache cache{{}, &exited};
+        return &cache;
+    }
+
+    void *take(size_t index) const
+    {
+        size_t size = classSize(index);
+        ThreadCache *cache = threadCache();
+        if (cache && index < cache->lists.size() && !cache->lists[index].empty())
+        {
+            void *block = cache->lists[index].back();
+            cache->lists[index].pop_back();
+            cached_.fetch_sub(size, std::memory_order_relaxed);
+            hits_.add();
+            return block;
+        }
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!global_[index].empty())
+        {
+            void *block = global_[index].back();
+            global_[index].pop_back();
+            cached_.fetch_sub(size, std::memory_order_relaxed);
+            hits_.add();
+            return block;
+        }
+
+        // 새 블록. 상한을 넘으면 보관 블록부터 돌려주고, 그래도 넘으면 포기
+        size_t owned = owned_.load(std::memory_order_relaxed);
+        if (owned + size > config_.capBytes)
+        {
+            releaseLocked(owned + size - config_.capBytes);
+            if (owned_.load(std::memory_order_relaxed) + size > config_.capBytes)
+            {
+                return nullptr;
+            }
+        }
+        void *block = std::aligned_alloc(64, size);
+        if (!block)
+        {
+            return nullptr;
+        }
+        misses_.add();
+        owned = owned_.fetch_add(size, std::memory_order_relaxed) + size;
+        if (owned > peak_.load(std::memory_order_relaxed))
+        {
+            peak_.store(owned, std::memory_order_relaxed);
+        }
+        return block;
+    }
+
+    void give(size_t index, void *block) const
+    {
+        size_t size = classSize(index);
+        cached_.fetch_add(size, std::memory_order_relaxed);
+        ThreadCache *cache = threadCache();
+        if (cache && cache->lists.size() < classes_)
+        {
+            cache->lists.resize(classes_);
+        }
+        if (cache && index < cache->lists.size() && cache->lists[index].size() < config_.threadBlocks)
+        {
+            cache->lists[index].push_back(block);
+            return;
+        }
+        std::lock_guard<std::mutex> lock(mutex_);
+        global_[index].push_back(block);
+    }
+
+    void flush(ThreadCache &cache) const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (size_t index = 0; index < cache.lists.size(); ++index)
+        {
+            global_[index].insert(global_[index].end(), cache.lists[index].begin(), cache.lists[index].end());
+            cache.lists[index].clear();
+        }
+    }
+
+    // 전역 목록의 큰 블록부터 bytes 이상을 시스템에 돌려줌 (mutex_ 보유 상태)
+    void releaseLocked(size_t bytes) const
+    {
+        size_t freed = 0;
+        for (size_t index = global_.size(); index-- > 0 && freed < bytes;)
+        {
+            size_t size = classSize(index);
+            while (!global_[index].empty() && freed < bytes)
+            {
+                std::free(global_[index].back());
+                global_[index].pop_back();
+                owned_.fetch_sub(size, std::memory_order_relaxed);
+                cached_.fetch_sub(size, std::memory_order_relaxed);
+                released_.add();
+                freed += size;
+            }
+        }
+    }
+
+    MatPoolConfig config_;
+    size_t classes_ = 0;
+    mutable std::mutex mutex_;
+    mutable std::vector<std::vector<void *>> global_;
+    mutable std::atomic<size_t> owned_{0};
+    mutable std::atomic<size_t> cached_{0};
+    mutable std::atomic<size_t> peak_{0};
+    Counter &allocations_;
+    Counter &hits_;
+    Counter &misses_;
+    Counter &fallbacks_;
+    Counter &released_;
+};
+
+#endif // MAT_POOL_H
@@ -0,0 +1,218 @@
+#ifndef OFFLOAD_POLICY_H
+#define OFFLOAD_POLICY_H
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <sstream>
+#include <string>
+
+// 프레임 처리 위치 (Edge 에서 처리 / 원본을 보내 서버에서 처리) 선택
+//
+// Auto 면 프레임마다 Edge 의 CPU 사용률(/proc/stat)과 프레임 처리 시간이 deadline 을 넘겼는지를 기록하고
+//   - Edge 처리 중: 최근 window 프레임의 deadline 초과 비율이 missHigh 이상이거나 CPU 가 cpuHigh 이상이면 서버로
+//   - 서버 처리 중: CPU 가 cpuLow 미만이고, 마지막으로 Edge 에서 잰 처리 시간을 더해도 deadline 의 headroom 배 안이면 Edge 로.
+//     그 측정값은 오래되면 맞지 않으므로 CPU 가 낮은 채로 probe 프레임이 지나면 일단 Edge 로 돌아가 다시 잼
+// 전환 직후 hold 프레임 동안은 다시 바꾸지 않음 (서버로 넘기면 CPU 가 바로 내려가므로 왕복 방지).
+// 기기마다 따로 판단하므로 느린 기기만 서버를 쓰고, 서버가 바빠져도 Edge 가 여유 있으면 돌아옴.
+
+enum class ProcessingMode
+{
+    Edge,   // 항상 Edge 에서 처리 (기존 동작)
+    Server, // 항상 원본 프레임을 보내 서버에서 처리
+    Auto,   // CPU 사용률 / deadline 초과에 따라 자동 선택
+};
+
+struct ProcessingConfig
+{
+    ProcessingMode mode = ProcessingMode::Edge;
+    int deadlineMs = 1000;  // 프레임 하나의 Edge 연산(검출 + 처리 + 인코딩) 허용 시간
+    double cpuHigh = 0.85;  // 이 이상이면 서버로 넘김 (전체 코어 평균 사용률)
+    double cpuLow = 0.60;   // 이 미만이어야 Edge 로 돌아옴
+    int window = 10;        // deadline 초과 비율을 보는 최근 프레임 수
+    double missHigh = 0.2;  // 이 비율 이상 deadline 을 넘기면 서버로 넘김
+    double headroom = 0.7;  // Edge 로 돌아올 때 예상 처리 시간이 deadline 의 이 배 이하여야 함
+    int hold = 10;          // 전환 후 최소 유지 프레임 수
+    int probe = 120;        // 서버 처리 중 CPU 가 낮으면 이 프레임 수마다 Edge 처리 시간을 다시 잼 (0 이면 안 함)
+};
+
+static inline const char *processingModeName(ProcessingMode mode)
+{
+    switch (mode)
+    {
+    case ProcessingMode::Server:
+        return "server";
+    case ProcessingMode::Auto:
+        return "auto";
+    case ProcessingMode::Edge:
+    default:
+        return "edge";
+    }
+}
+
+// "auto,deadline-ms=1000,cpu-high=0.85,cpu-low=0.6,window=10,miss=0.2,headroom=0.7,hold=10,probe=120"
+// 또는 "edge" / "server"
+// 알 수 없는 값이 있으면 false
+static inline bool parseProcessingConfig(const std::string &text, ProcessingConfig &config)
+{
+    std::stringstream stream(text);
+    std::string item;
+    while (std::getline(stream, item, ','))
+    {
+        size_t eq = item.find('=');
+        if (item.empty())
+            continue;
+        if (item == "edge")
+            config.mode = ProcessingMode::Edge;
+        else if (item == "server")
+            config.mode = ProcessingMode::Server;
+        else if (item == "auto")
+            config.mode = ProcessingMode::Auto;
+        else if (eq == std::string::npos)
+            return false;
+        else
+        {
+            std::string key = item.substr(0, eq);
+            double value = std::atof(item.c_str() + eq + 1);
+            if (key == "deadline-ms")
+                config.deadlineMs = std::max(1, static_cast<int>(value));
+            else if (key == "cpu-high")
+                config.cpuHigh = std::min(1.0, std::max(0.0, value));
+            else if (key == "cpu-low")
+                config.cpuLow = std::min(1.0, std::max(0.0, value));
+            else if (key == "window")
+                config.window = std::max(1, static_cast<int>(value));
+            else if (key == "miss")
+                config.missHigh = std::min(1.0, std::max(0.0, value));
+            else if (key == "headroom")
+                config.headroom = std::max(0.0, value);
+            else if (key == "hold")
+                config.hold = std::max(0, static_cast<int>(value));
+            else if (key == "probe")
+                config.probe = std::max(0, static_cast<int>(value));
+            else
+                return false;
+        }
+    }
+    return true;
+}
+
+// /proc/stat 첫 줄(전체 CPU) 기준 직전 호출 이후 사용률. 처음 호출이거나 읽을 수 없으면 -1
+class CpuLoadSampler
+{
+public:
+    double sample()
+    {
+        FILE *file = std::fopen("/proc/stat", "r");
+        if (!file)
+        {
+            return -1.0;
+        }
+        unsigned long long user = 0, nice = 0, system = 0, idle = 0, iowait = 0, irq = 0, softirq = 0, steal = 0;
+        int fields = std::fscanf(file, "cpu %llu %llu %llu %llu %llu %llu %llu %llu", &user, &nice, &system, &idle,
+                                 &iowait, &irq, &softirq, &steal);
+        std::fclose(file);
+        if (fields < 4)
+        {
+            return -1.0;
+        }
+
+        uint64_t idleTotal = idle + iowait;
+        uint64_t total = user + nice + system + idle + iowait + irq + softirq + steal;
+        double load = -1.0;
+        if (total_ != 0 && total > total_)
+        {
+            load = 1.0 - static_cast<double>(idleTotal - idle_) / static_cast<double>(total - total_);
+        }
+        idle_ = idleTotal;
+        total_ = total;
+        return load;
+    }
+
+private:
+    uint64_t idle_ = 0;
+    uint64_t total_ = 0;
+};
+
+class OffloadPolicy
+{
+public:
+    void configure(const ProcessingConfig &config)
+    {
+        config_ = config;
+        offloaded_ = config.mode == ProcessingMode::Server;
+        misses_.clear();
+        sinceSwitch_ = 0;
+    }
+
+    const ProcessingConfig &config() const { return config_; }
+
+    // 이번 프레임을 서버에서 처리할지
+    bool offloaded() const { return offloaded_; }
+
+    // 마지막 record 때의 CPU 사용률 (모르면 -1) / 최근 window 프레임의 deadline 초과 비율
+    double cpuLoad() const { return cpuLoad_; }
+    double missRate() const { return missRate_; }
+
+    // 프레임 하나의 Edge 연산 시간(ns)을 기록하고 다음 프레임의 처리 위치를 정함. 처리 위치가 바뀌면 true
+    bool record(uint64_t frameNs)
+    {
+        bool missed = frameNs > static_cast<uint64_t>(config_.deadlineMs) * 1000000ULL;
+        misses_.push_back(missed);
+        while (misses_.size() > static_cast<size_t>(config_.window))
+        {
+            misses_.pop_front();
+        }
+        missRate_ = static_cast<double>(std::count(misses_.begin(), misses_.end(), true)) / misses_.size();
+        if (!offloaded_)
+        {
+            localNs_ = frameNs;
+        }
+        cpuLoad_ = cpu_.sample();
+        ++sinceSwitch_;
+
+        if (config_.mode != ProcessingMode::Auto || sinceSwitch_ < config_.hold)
+        {
+            return false;
+        }
+
+        bool next = offloaded_;
+        if (!offloaded_)
+        {
+            next = (cpuLoad_ >= 0 && cpuLoad_ >= config_.cpuHigh) ||
+                   (misses_.size() >= static_cast<size_t>(config_.window) && missRate_ >= config_.missHigh);
+        }
+        else
+        {
+            // 서버 처리 중 잰 시간(원본 인코딩)에 마지막 Edge 처리 시간을 더해 Edge 로 돌아왔을 때를 추정
+            double budget = config_.deadlineMs * 1e6 * config_.headroom;
+            bool idle = cpuLoad_ >= 0 ? cpuLoad_ < config_.cpuLow : missRate_ == 0.0;
+            bool fits = static_cast<double>(frameNs + localNs_) <= budget;
+            bool stale = config_.probe > 0 && sinceSwitch_ >= config_.probe;
+            next = !(idle && (fits || stale));
+        }
+
+        if (next == offloaded_)
+        {
+            return false;
+        }
+        offloaded_ = next;
+        misses_.clear();
+        sinceSwitch_ = 0;
+        return true;
+    }
+
+private:
+    ProcessingConfig config_;
+    bool offloaded_ = false;
+    std::deque<bool> misses_;
+    int sinceSwitch_ = 0;
+    uint64_t localNs_ = 0; // 마지막으로 Edge 에서 처리한 프레임의 연산 시간
+    double cpuLoad_ = -1.0;
+    double missRate_ = 0.0;
+    CpuLoadSampler cpu_;
+};
+
+#endif // OFFLOAD_POLICY_H
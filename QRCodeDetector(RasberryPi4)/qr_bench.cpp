@@ -0,0 +1,307 @@
+// QR 검출 단계 벤치마크: 전체 프레임 검출 vs 파인더 사전 탐지 (단일 해상도 / 피라미드 / 피라미드 + 추적)
+//
+// 사용법: qr_bench [--frames N] [--sequence N] [--width W] [--height H] [--background IMAGE] [--codes N]
+//                  [--min-module N] [--max-module N] [--seed N]
+// 배경(기본: 합성 질감, --background 지정 시 그 이미지를 크기 조정) 위에 QRCodeEncoder 로 만든 코드를
+// 무작위 위치/모듈 크기로 --codes 개 붙이고 --sequence 프레임 동안 조금씩 움직이는 장면과, 코드가 없는 장면을
+// 번갈아 만듦. 방식별 프레임당 지연(p50/p99/평균)과 모듈 크기별 검출률(디코딩한 문자열이 붙인 것과 일치),
+// 오검출 수를 보고함.
+
+#include <opencv2/opencv.hpp>
+#include "metrics.h"
+#include "qr_detect.h"
+
+#include <cstdio>
+#include <iostream>
+#include <map>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+struct BenchConfig
+{
+    int frames = 300;   // 코드 있는 장면 + 없는 장면의 전체 프레임 수
+    int sequence = 10;  // 장면 하나의 프레임 수 (장면 안에서 코드가 움직임)
+    int width = 1280;
+    int height = 720;
+    int codes = 1;      // 코드 있는 장면마다 붙일 코드 수
+    int minModule = 2;  // 붙일 코드의 모듈 크기 범위 (px)
+    int maxModule = 12;
+    std::string background;
+    unsigned seed = 7;
+};
+
+// 작은 코드: 모듈이 이 크기 이하 (px)
+static const int SMALL_MODULE = 3;
+
+struct BenchFrame
+{
+    cv::Mat image;
+    std::map<std::string, int> texts; // 붙인 코드 내용 -> 모듈 크기 (코드 없는 프레임은 비어 있음)
+};
+
+struct ModeResult
+{
+    explicit ModeResult(const std::string &name)
+        : withCodes("qr_bench_" + name + "_with_codes_ns", "", ""),
+          withoutCodes("qr_bench_" + name + "_without_codes_ns", "", "") {}
+
+    Histogram withCodes;
+    Histogram withoutCodes;
+    uint64_t placed[2] = {0, 0};  // [작은 코드, 나머지]
+    uint64_t decoded[2] = {0, 0};
+    uint64_t falsePositives = 0;  // 붙이지 않은 내용이거나 코드 없는 프레임에서의 검출
+    uint64_t searches = 0;        // 피라미드 / 전체 프레임 탐색을 한 프레임 수
+    double roiFraction = 0;
+};
+
+static void printUsage(const char *program)
+{
+    std::cerr << "Usage: " << program << " [--frames N] [--sequence N] [--width W] [--height H] [--background IMAGE]"
+              << " [--codes N] [--min-module N] [--max-module N] [--seed N]" << std::endl;
+}
+
+static cv::Mat makeBackground(const BenchConfig &config, std::mt19937 &rng)
+{
+    cv::Mat background;
+    if (!config.background.empty())
+    {
+        cv::Mat loaded = cv::imread(config.background);
+        if (loaded.empty())
+        {
+            std::cerr << "Failed to load " << config.background << ", using synthetic background" << std::endl;
+        }
+        else
+        {
+            cv::resize(loaded, background, cv::Size(config.width, config.height));
+            return background;
+        }
+    }
+
+    // 합성 질감: 잡음을 흐리게 한 뒤 사각형/선 몇 개 (엣지가 많은 실제 장면 흉내)
+    background.create(config.height, config.width, CV_8UC3);
+    cv::randu(background, cv::Scalar::all(40), cv::Scalar::all(220));
+    cv::GaussianBlur(background, background, cv::Size(7, 7), 0);
+    std::uniform_int_distribution<int> x(0, config.width - 1), y(0, config.height - 1), shade(0, 255);
+    for (int i = 0; i < 40; ++i)
+    {
+        cv::Scalar color(shade(rng), shade(rng), shade(rng));
+        cv::rectangle(background, cv::Rect(cv::Point(x(rng), y(rng)), cv::Point(x(rng), y(rng))), color, 3);
+        cv::line(background, cv::Point(x(rng), y(rng)), cv::Point(x(rng), y(rng)), color, 2);
+    }
+    return background;
+}
+
+// 장면 하나에 붙일 코드: 모듈 크기로 키운 이미지(흰 여백 4 모듈 포함)와 시작 위치, 프레임당 이동
+struct SceneCode
+{
+    std::string text;
+    int module;
+    cv::Mat image;
+    cv::Point2f position;
+    cv::Point2f velocity;
+};
+
+// 다른 코드와 겹치지 않는 자리를 고름. 자리가 없으면 false
+static bool makeSceneCode(cv::QRCodeEncoder &encoder, const std::string &text, int module, const cv::Size &frameSize,
+                          std::mt19937 &rng, std::vector<cv::Rect> &used, SceneCode &code)
+{
+    cv::Mat encoded, scaled;
+    encoder.encode(text, encoded);
+    if (encoded.empty())
+    {
+        return false;
+    }
+    int quiet = 4 * module;
+    cv::resize(encoded, scaled, cv::Size(encoded.cols * module, encoded.rows * module), 0, 0, cv::INTER_NEAREST);
+    code.image.create(scaled.rows + 2 * quiet, scaled.cols + 2 * quiet, CV_8UC3);
+    code.image.setTo(cv::Scalar::all(255));
+    cv::Mat inner = code.image(cv::Rect(quiet, quiet, scaled.cols, scaled.rows));
+    cv::cvtColor(scaled, inner, cv::COLOR_GRAY2BGR);
+
+    // 장면 동안 움직이는 범위(최대 3 px/프레임)까지 여유를 둠
+    int side = code.image.cols;
+    int travel = 3 * 16;
+    if (side + 2 * travel >= frameSize.width || side + 2 * travel >= frameSize.height)
+    {
+        return false;
+    }
+    std::uniform_int_distribution<int> x(travel, frameSize.width - side - travel), y(travel, frameSize.height - side - travel);
+    std::uniform_real_distribution<float> speed(-3.0f, 3.0f);
+    for (int attempt = 0; attempt < 20; ++attempt)
+    {
+        cv::Rect rect(x(rng) - travel, y(rng) - travel, side + 2 * travel, side + 2 * travel);
+        bool overlaps = false;
+        for (const auto &other : used)
+        {
+            overlaps = overlaps || (rect & other).area() > 0;
+        }
+        if (overlaps)
+        {
+            continue;
+        }
+        used.push_back(rect);
+        code.text = text;
+        code.module = module;
+        code.position = cv::Point2f(static_cast<float>(rect.x + travel), static_cast<float>(rect.y + travel));
+        code.velocity = cv::Point2f(speed(rng), speed(rng));
+        return true;
+    }
+    return false;
+}
+
+static void runMode(QrDetectStage &stage, const std::vector<BenchFrame> &frames, ModeResult &result)
+{
+    for (const auto &frame : frames)
+    {
+        uint64_t start = metricsNowNs();
+        std::vector<QrDetection> detections = stage.detect(frame.image);
+        uint64_t elapsed = metricsNowNs() - start;
+        (frame.texts.empty() ? result.withoutCodes : result.withCodes).record(elapsed);
+        result.roiFraction += stage.lastStats().roiFraction;
+        result.searches += stage.lastStats().searched ? 1 : 0;
+
+        for (const auto &placed : frame.texts)
+        {
+            ++result.placed[placed.second <= SMALL_MODULE ? 0 : 1];
+        }
+        std::set<std::string> found;
+        for (const auto &detection : detections)
+        {
+            auto placed = frame.texts.find(detection.text);
+            if (placed != frame.texts.end() && found.insert(detection.text).second)
+            {
+                ++result.decoded[placed->second <= SMALL_MODULE ? 0 : 1];
+            }
+            else if (!detection.text.empty() || frame.texts.empty())
+            {
+                ++result.falsePositives;
+            }
+        }
+    }
+    result.roiFraction /= std::max<size_t>(1, frames.size());
+}
+
+static void printMode(const char *name, const ModeResult &result, size_t frames)
+{
+    Histogram::Snapshot with = result.withCodes.snapshot();
+    Histogram::Snapshot without = result.withoutCodes.snapshot();
+    double meanMs = (with.sum + without.sum) / 1e6 / std::max<size_t>(1, frames);
+    auto rate = [](uint64_t decoded, uint64_t placed)
+    { return placed ? 100.0 * decoded / placed : 0.0; };
+    printf("%-14s: mean %.2f ms | with codes p50 %.2f ms, p99 %.2f ms | without codes p50 %.2f ms, p99 %.2f ms\n", name,
+           meanMs, with.quantile(0.5) / 1e6, with.quantile(0.99) / 1e6, without.quantile(0.5) / 1e6,
+           without.quantile(0.99) / 1e6);
+    printf("%-14s  decoded small %llu / %llu (%.1f%%), large %llu / %llu (%.1f%%), false positives %llu\n", "",
+           static_cast<unsigned long long>(result.decoded[0]), static_cast<unsigned long long>(result.placed[0]),
+           rate(result.decoded[0], result.placed[0]), static_cast<unsigned long long>(result.decoded[1]),
+           static_cast<unsigned long long>(result.placed[1]), rate(result.decoded[1], result.placed[1]),
+           static_cast<unsigned long long>(result.falsePositives));
+    printf("%-14s  searched %llu / %zu frames, avg detector area %.1f%% of frame\n", "",
+           static_cast<unsigned long long>(result.searches), frames, 100.0 * result.roiFraction);
+}
+
+int main(int argc, char *argv[])
+{
+    BenchConfig config;
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        if (i + 1 >= argc)
+        {
+            printUsage(argv[0]);
+            return 1;
+        }
+        std::string value = argv[++i];
+
+        if (arg == "--frames")
+            config.frames = std::max(2, std::stoi(value));
+        else if (arg == "--sequence")
+            config.sequence = std::max(1, std::min(16, std::stoi(value)));
+        else if (arg == "--width")
+            config.width = std::max(160, std::stoi(value));
+        else if (arg == "--height")
+            config.height = std::max(120, std::stoi(value));
+        else if (arg == "--background")
+            config.background = value;
+        else if (arg == "--codes")
+            config.codes = std::max(1, std::stoi(value));
+        else if (arg == "--min-module")
+            config.minModule = std::max(1, std::stoi(value));
+        else if (arg == "--max-module")
+            config.maxModule = std::max(1, std::stoi(value));
+        else if (arg == "--seed")
+            config.seed = static_cast<unsigned>(std::stoul(value));
+        else
+        {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+    config.maxModule = std::max(config.minModule, config.maxModule);
+
+    // 프레임 준비 (측정에서 제외). 짝수 번째 장면은 코드 있음, 홀수 번째는 없음
+    std::mt19937 rng(config.seed);
+    cv::Ptr<cv::QRCodeEncoder> encoder = cv::QRCodeEncoder::create();
+    std::uniform_int_distribution<int> modulePick(config.minModule, config.maxModule);
+    std::vector<BenchFrame> frames(config.frames);
+    int scenes = 0;
+    for (int f = 0; f < config.frames; f += config.sequence, ++scenes)
+    {
+        cv::Mat background = makeBackground(config, rng);
+        std::vector<SceneCode> codes;
+        std::vector<cv::Rect> used;
+        for (int c = 0; scenes % 2 == 0 && c < config.codes; ++c)
+        {
+            SceneCode code;
+            std::string text = "HUB-" + std::to_string(1000 + scenes) + "-" + std::to_string(c);
+            if (makeSceneCode(*encoder, text, modulePick(rng), background.size(), rng, used, code))
+            {
+                codes.push_back(std::move(code));
+            }
+        }
+
+        for (int t = 0; t < config.sequence && f + t < config.frames; ++t)
+        {
+            BenchFrame &frame = frames[f + t];
+            frame.image = background.clone();
+            for (const auto &code : codes)
+            {
+                cv::Point at(cvRound(code.position.x + code.velocity.x * t), cvRound(code.position.y + code.velocity.y * t));
+                cv::Mat target = frame.image(cv::Rect(at.x, at.y, code.image.cols, code.image.rows));
+                code.image.copyTo(target);
+                frame.texts[code.text] = code.module;
+            }
+        }
+    }
+
+    struct Mode
+    {
+        const char *name;
+        QrDetectConfig config;
+    };
+    std::vector<Mode> modes(4);
+    modes[0].name = "full frame";
+    modes[0].config.preLocalize = false;
+    modes[1].name = "single level";
+    modes[1].config.pyramidLevels = 1;
+    modes[1].config.track = false;
+    modes[2].name = "pyramid";
+    modes[2].config.track = false;
+    modes[3].name = "pyramid+track";
+
+    printf("===== QR detection benchmark report =====\n");
+    printf("frames        : %d (%dx%d, %d scenes of %d frames, every other scene with %d codes, module %d-%d px,"
+           " small <= %d px)\n",
+           config.frames, config.width, config.height, scenes, config.sequence, config.codes, config.minModule,
+           config.maxModule, SMALL_MODULE);
+    for (auto &mode : modes)
+    {
+        QrDetectStage stage(mode.config);
+        ModeResult result(mode.name);
+        runMode(stage, frames, result);
+        printMode(mode.name, result, frames.size());
+    }
+    return 0;
+}
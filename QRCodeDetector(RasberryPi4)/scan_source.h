@@ -0,0 +1,246 @@
+#ifndef SCAN_SOURCE_H
+#define SCAN_SOURCE_H
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "scan_batch.h"
+
+// BLE 스캔 입력 소스
+//
+// EdgeBLE 의 스캔 스레드가 주기마다 scan() 을 호출해 그동안 들어온 광고(advertisement)를 ScanBatch 로 받아
+// addSightings 로 넘김. 실제 BLE 어댑터 없이도 수신/집계/로그 비용을 측정할 수 있도록 합성 소스를 제공.
+
+class ScanSource
+{
+public:
+    virtual ~ScanSource() = default;
+
+    virtual const char *name() const = 0;
+
+    // 이전 호출 이후(nowNs 기준) 수신한 광고를 batch 에 채움 (batch 는 reset 후 채움). 소스가 끝났으면 false
+    virtual bool scan(ScanBatch &batch, uint64_t nowNs) = 0;
+};
+
+struct SyntheticScanConfig
+{
+    int hubs = 4;
+    int devicesPerHub = 200;            // 허브마다 동시에 보이는 기기 수
+    int serverIds = 16;                 // 기기가 속한 serverId 종류 수
+    double advertisementsPerSec = 10000; // 전체 광고 수신율
+    double churnPerSec = 0.05;          // 초당 새 기기로 바뀌는 기기 비율
+    double duplicateRatio = 0.3;        // 직전 광고를 그대로 다시 받는 비율 (같은 허브)
+    int rssiMin = -95;                  // 기기별 기준 신호 세기 범위 (dBm)
+    int rssiMax = -40;
+    size_t maxPerScan = 200000;         // 한 번에 만드는 최대 광고 수 (스레드가 오래 멈춘 뒤 폭주 방지)
+    uint64_t seed = 1;
+};
+
+// "hubs=4,devices=200,rate=10000,churn=0.05,dup=0.3" 형식 파싱. 알 수 없는 키가 있으면 false
+static inline bool parseSyntheticScanConfig(const std::string &text, SyntheticScanConfig &config)
+{
+    std::stringstream stream(text);
+    std::string item;
+    while (std::getline(stream, item, ','))
+    {
+        size_t eq = item.find('=');
+        if (item.empty())
+            continue;
+        if (eq == std::string::npos)
+            return false;
+        std::string key = item.substr(0, eq);
+        double value = std::atof(item.c_str() + eq + 1);
+        if (key == "hubs")
+            config.hubs = std::max(1, static_cast<int>(value));
+        else if (key == "devices")
+            config.devicesPerHub = std::max(1, static_cast<int>(value));
+        else if (key == "servers")
+            config.serverIds = std::max(1, static_cast<int>(value));
+        else if (key == "rate")
+            config.advertisementsPerSec = std::max(0.0, value);
+        else if (key == "churn")
+            config.churnPerSec = std::max(0.0, value);
+        else if (key == "dup")
+            config.duplicateRatio = std::min(1.0, std::max(0.0, value));
+        else if (key == "seed")
+            config.seed = static_cast<uint64_t>(value);
+        else
+            return false;
+    }
+    return true;
+}
+
+// 합성 BLE 스캔 소스
+// 허브마다 devicesPerHub 개의 기기(serverId, uuid, 기준 RSSI)를 유지하고, 경과 시간에 비례해
+// 광고를 만들어 냄. 일부 기기는 churn 비율로 새 uuid 의 기기로 교체되고, 일부 광고는 직전 광고의 중복.
+class SyntheticScanSource : public ScanSource
+{
+public:
+    explicit SyntheticScanSource(const SyntheticScanConfig &config = SyntheticScanConfig())
+        : config_(config), rng_(config.seed)
+    {
+        config_.hubs = std::max(1, config_.hubs);
+        config_.devicesPerHub = std::max(1, config_.devicesPerHub);
+        config_.serverIds = std::max(1, config_.serverIds);
+        if (config_.rssiMin > config_.rssiMax)
+        {
+            std::swap(config_.rssiMin, config_.rssiMax);
+        }
+    }
+
+    const char *name() const override { return "synthetic"; }
+
+    bool scan(ScanBatch &batch, uint64_t nowNs) override
+    {
+        batch.reset();
+        if (hubs_.empty() || ids_ != &batch.ids())
+        {
+            populate(batch.ids());
+        }
+        else if (generation_ != ids_->generation())
+        {
+            reintern();
+        }
+        if (lastNs_ == 0)
+        {
+            lastNs_ = nowNs;
+            return true;
+        }
+        double elapsedSec = (nowNs - lastNs_) / 1e9;
+        lastNs_ = nowNs;
+
+        replaceDevices(elapsedSec);
+
+        advertisementCarry_ += config_.advertisementsPerSec * elapsedSec;
+        size_t count = std::min(static_cast<size_t>(advertisementCarry_), config_.maxPerScan);
+        advertisementCarry_ = std::min(advertisementCarry_ - static_cast<double>(count), 1.0);
+
+        // 허브별로 고르게 나눔 (나머지는 앞쪽 허브부터)
+        std::uniform_real_distribution<double> unit(0.0, 1.0);
+        std::uniform_int_distribution<int> noise(-6, 6);
+        for (size_t h = 0; h < hubs_.size(); ++h)
+        {
+            Hub &hub = hubs_[h];
+            size_t hubCount = count / hubs_.size() + (h < count % hubs_.size() ? 1 : 0);
+            if (hubCount == 0)
+            {
+                continue;
+            }
+            batch.beginHub(hub.id);
+            std::uniform_int_distribution<size_t> pick(0, hub.devices.size() - 1);
+            for (size_t i = 0; i < hubCount; ++i)
+            {
+                if (!(i > 0 && unit(rng_) < config_.duplicateRatio))
+                {
+                    hub.last = pick(rng_);
+                }
+                const Device &device = hub.devices[hub.last];
+                int rssi = std::min(-1, std::max(-127, device.baseRssi + noise(rng_)));
+                batch.addEntry(device.serverId, device.uuid, static_cast<int8_t>(rssi));
+            }
+        }
+        generated_ += count;
+        return true;
+    }
+
+    uint64_t generated() const { return generated_; }
+    uint64_t replaced() const { return replaced_; }
+
+private:
+    struct Device
+    {
+        ScanId serverId;
+        int32_t uuid;
+        int baseRssi;
+    };
+
+    struct Hub
+    {
+        ScanId id;
+        std::vector<Device> devices;
+        size_t last = 0; // 직전 광고한 기기 (중복 광고용)
+    };
+
+    void populate(ScanIdTable &ids)
+    {
+        ids_ = &ids;
+        generation_ = ids.generation();
+        serverIds_.clear();
+        for (int s = 0; s < config_.serverIds; ++s)
+        {
+            serverIds_.push_back(ids.intern("Server_" + std::to_string(s + 1)));
+        }
+        hubs_.assign(config_.hubs, Hub());
+        for (int h = 0; h < config_.hubs; ++h)
+        {
+            hubs_[h].id = ids.intern("Hub_" + std::to_string(1000 + h));
+            for (int d = 0; d < config_.devicesPerHub; ++d)
+            {
+                hubs_[h].devices.push_back(newDevice());
+            }
+        }
+    }
+
+    // ID 테이블이 clear 된 뒤 같은 이름으로 다시 등록 (기기 목록은 유지)
+    void reintern()
+    {
+        generation_ = ids_->generation();
+        std::vector<ScanId> previous = serverIds_;
+        for (int s = 0; s < config_.serverIds; ++s)
+        {
+            serverIds_[s] = ids_->intern("Server_" + std::to_string(s + 1));
+        }
+        for (size_t h = 0; h < hubs_.size(); ++h)
+        {
+            hubs_[h].id = ids_->intern("Hub_" + std::to_string(1000 + h));
+            for (Device &device : hubs_[h].devices)
+            {
+                size_t s = std::find(previous.begin(), previous.end(), device.serverId) - previous.begin();
+                device.serverId = serverIds_[std::min(s, serverIds_.size() - 1)];
+            }
+        }
+    }
+
+    Device newDevice()
+    {
+        std::uniform_int_distribution<size_t> server(0, serverIds_.size() - 1);
+        std::uniform_int_distribution<int> rssi(config_.rssiMin, config_.rssiMax);
+        return {serverIds_[server(rng_)], nextUuid_++ % 1000000, rssi(rng_)};
+    }
+
+    void replaceDevices(double elapsedSec)
+    {
+        size_t total = hubs_.size() * static_cast<size_t>(config_.devicesPerHub);
+        churnCarry_ += config_.churnPerSec * elapsedSec * total;
+        size_t count = std::min(static_cast<size_t>(churnCarry_), total);
+        churnCarry_ -= static_cast<double>(count);
+        churnCarry_ = std::min(churnCarry_, 1.0);
+
+        std::uniform_int_distribution<size_t> hub(0, hubs_.size() - 1);
+        std::uniform_int_distribution<size_t> device(0, config_.devicesPerHub - 1);
+        for (size_t i = 0; i < count; ++i)
+        {
+            hubs_[hub(rng_)].devices[device(rng_)] = newDevice();
+        }
+        replaced_ += count;
+    }
+
+    SyntheticScanConfig config_;
+    std::mt19937_64 rng_;
+    ScanIdTable *ids_ = nullptr;
+    uint64_t generation_ = 0; // serverIds_ / 허브 ID 를 등록한 ID 테이블 세대
+    std::vector<ScanId> serverIds_;
+    std::vector<Hub> hubs_;
+    int32_t nextUuid_ = 10000;
+    uint64_t lastNs_ = 0;
+    double advertisementCarry_ = 0;
+    double churnCarry_ = 0;
+    uint64_t generated_ = 0;
+    uint64_t replaced_ = 0;
+};
+
+#endif // SCAN_SOURCE_H
@@ -0,0 +1,150 @@
+#ifndef FRAME_PROTOCOL_H
+#define FRAME_PROTOCOL_H
+
+#include <cstdint>
+#include <cstring>
+#include <arpa/inet.h>
+
+// Edge <-> MAC Server 사이의 프레임 프로토콜 정의
+//
+// 레거시 모드 : [u32 길이][JPEG 데이터] 를 연결당 한 번 전송 (응답 "Acknowledged")
+// 세션 모드   : 연결 직후 FRAME_SESSION_MAGIC 을 전송한 뒤
+//               [FrameHeader][페이로드] 를 한 연결에서 반복 전송.
+//               서버는 프레임마다 AckMessage(seq 포함)를 즉시 회신하므로
+//               클라이언트는 ACK 를 기다리지 않고 윈도우 크기만큼 프레임을 연속 전송할 수 있음.
+//               ACK 의 credits 는 서버가 추가로 수용할 수 있는 프레임 수이며,
+//               클라이언트는 미확인 프레임 수를 min(윈도우, credits) 이하로 유지해야 함.
+//
+// 모든 정수 필드는 네트워크 바이트 오더(빅 엔디언)로 전송됨.
+
+// 세션 모드 시작을 알리는 매직 값 ("AZS1")
+// 레거시 길이 프리픽스로 해석하면 약 1GB 이므로 정상 JPEG 길이와 충돌하지 않음
+static constexpr uint32_t FRAME_SESSION_MAGIC = 0x415A5331;
+
+// ACK 메시지 매직 값 ("ACK1")
+static constexpr uint32_t FRAME_ACK_MAGIC = 0x41434B31;
+
+// 레거시 모드 응답 문자열
+static constexpr const char *FRAME_LEGACY_ACK = "Acknowledged";
+
+// 클라이언트 기본 미확인 프레임 윈도우 크기
+static constexpr uint32_t FRAME_DEFAULT_WINDOW = 8;
+
+// 프레임 페이로드 종류
+enum class FrameType : uint16_t
+{
+    Jpeg = 1,    // JPEG 인코딩 이미지 (결과 전용 모드에서는 키프레임 / 썸네일)
+    Results = 2, // 검출 결과 레코드 (frame_results.h)
+    QrCrop = 3,  // 디코딩 못 한 QR 주변을 원본 해상도로 자른 JPEG ([QrCropHeader][JPEG], 결과 전용 모드)
+};
+
+// ACK 상태 코드
+enum class AckStatus : uint16_t
+{
+    Ok = 0,          // 정상 수신 및 처리
+    DecodeError = 1, // 수신했으나 디코딩 실패
+    Rejected = 2,    // 서버 메모리 예산 초과로 읽고 버림
+    Dropped = 3,     // 대기 중 더 새로운 프레임에 밀려 처리되지 않음 (drop-oldest)
+    TooLarge = 4,    // 최대 프레임 크기 초과. 서버가 연결을 종료함
+    Credit = 5,      // 프레임 확인이 아닌 credit 갱신 전용 메시지 (seq 무시)
+    Keyframe = 6,    // 정상 처리 + 디코딩 못 한 QR 을 원본 해상도로 잘라(QrCrop) 보내 달라는 요청 (결과 전용 모드)
+};
+
+// FrameHeader::flags
+// Jpeg 프레임이 처리되지 않은 카메라 원본이라는 표시. 서버가 Edge 대신 image_ops.h 의 처리를 수행함
+// (Edge 의 CPU 가 부족할 때 처리를 서버로 넘기는 경우)
+static constexpr uint16_t FRAME_FLAG_RAW = 0x0001;
+
+// 세션 모드 프레임 헤더 (12 바이트)
+struct FrameHeader
+{
+    uint32_t payloadSize; // 페이로드 바이트 수
+    uint32_t seq;         // 연결 내 프레임 시퀀스 번호
+    uint16_t type;        // FrameType
+    uint16_t flags;       // FRAME_FLAG_* (나머지 비트는 예약, 0)
+};
+
+// 서버 -> 클라이언트 ACK (12 바이트)
+struct AckMessage
+{
+    uint32_t magic;  // FRAME_ACK_MAGIC
+    uint32_t seq;    // 확인된 프레임 시퀀스 번호
+    uint16_t status; // AckStatus
+    uint16_t credits; // 서버가 이 연결에서 추가로 수용 가능한 프레임 수
+};
+
+// FrameType::QrCrop 페이로드 앞의 자른 위치 (8 바이트). 서버는 crop 안에서 찾은 꼭짓점에 (x, y) 를 더해 원본 좌표로 환산
+struct QrCropHeader
+{
+    uint16_t x;           // 원본 프레임에서 crop 의 왼쪽 위
+    uint16_t y;
+    uint16_t frameWidth;  // 원본 프레임 크기
+    uint16_t frameHeight;
+};
+
+static constexpr size_t FRAME_HEADER_SIZE = 12;
+static constexpr size_t ACK_MESSAGE_SIZE = 12;
+static constexpr size_t QR_CROP_HEADER_SIZE = 8;
+
+// 헤더를 네트워크 바이트 오더로 직렬화
+static inline void encodeFrameHeader(const FrameHeader &header, unsigned char *out)
+{
+    uint32_t size = htonl(header.payloadSize);
+    uint32_t seq = htonl(header.seq);
+    uint16_t type = htons(header.type);
+    uint16_t flags = htons(header.flags);
+    std::memcpy(out, &size, 4);
+    std::memcpy(out + 4, &seq, 4);
+    std::memcpy(out + 8, &type, 2);
+    std::memcpy(out + 10, &flags, 2);
+}
+
+// 네트워크 바이트 오더 버퍼에서 헤더 복원
+static inline FrameHeader decodeFrameHeader(const unsigned char *in)
+{
+    uint32_t size, seq;
+    uint16_t type, flags;
+    std::memcpy(&size, in, 4);
+    std::memcpy(&seq, in + 4, 4);
+    std::memcpy(&type, in + 8, 2);
+    std::memcpy(&flags, in + 10, 2);
+    return FrameHeader{ntohl(size), ntohl(seq), ntohs(type), ntohs(flags)};
+}
+
+static inline void encodeAck(const AckMessage &ack, unsigned char *out)
+{
+    uint32_t magic = htonl(ack.magic);
+    uint32_t seq = htonl(ack.seq);
+    uint16_t status = htons(ack.status);
+    uint16_t credits = htons(ack.credits);
+    std::memcpy(out, &magic, 4);
+    std::memcpy(out + 4, &seq, 4);
+    std::memcpy(out + 8, &status, 2);
+    std::memcpy(out + 10, &credits, 2);
+}
+
+static inline AckMessage decodeAck(const unsigned char *in)
+{
+    uint32_t magic, seq;
+    uint16_t status, credits;
+    std::memcpy(&magic, in, 4);
+    std::memcpy(&seq, in + 4, 4);
+    std::memcpy(&status, in + 8, 2);
+    std::memcpy(&credits, in + 10, 2);
+    return AckMessage{ntohl(magic), ntohl(seq), ntohs(status), ntohs(credits)};
+}
+
+static inline void encodeQrCropHeader(const QrCropHeader &crop, unsigned char *out)
+{
+    uint16_t values[4] = {htons(crop.x), htons(crop.y), htons(crop.frameWidth), htons(crop.frameHeight)};
+    std::memcpy(out, values, QR_CROP_HEADER_SIZE);
+}
+
+static inline QrCropHeader decodeQrCropHeader(const unsigned char *in)
+{
+    uint16_t values[4];
+    std::memcpy(values, in, QR_CROP_HEADER_SIZE);
+    return QrCropHeader{ntohs(values[0]), ntohs(values[1]), ntohs(values[2]), ntohs(values[3])};
+}
+
+#endif // FRAME_PROTOCOL_H
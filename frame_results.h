@@ -0,0 +1,317 @@
+#ifndef FRAME_RESULTS_H
+#define FRAME_RESULTS_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <arpa/inet.h>
+#include "scan_result.h"
+
+// 결과 전용 업링크 레코드 (FrameType::Results 페이로드)
+//
+// Edge 가 JPEG 대신 프레임에서 검출한 것만 보냄: QR 내용과 꼭짓점, 직선 파라미터, 윤곽선 외접 사각형,
+// 그리고 마지막으로 보낸 뒤 바뀐 경우에만 스캔 결과. 보통 수백 바이트 (JPEG 는 수백 KB).
+//
+// [u8 version][u8 flags][u16 width][u16 height][u64 captureUs]
+// [u16 QR 수]    { [u16 길이][내용][i16 x 4 꼭짓점 (x, y)] }
+// [u16 직선 수]  { [i16 rho (1/8 px, ±4096 px)][u16 theta (0~π 를 0~65535 로)] }
+// [u16 사각형 수]{ [u16 x][u16 y][u16 width][u16 height] }
+// FRAME_RESULTS_SCANS 이면 이어서
+// [u16 허브 수]  { [u16 길이][hubId][u16 항목 수] { [u16 길이][serverId][i32 uuid]
+//                  [u32 관측 횟수][u32 처음 관측][u32 마지막 관측][i8 rssi 최소][i8 최대][i8 평균] } }
+// 관측 시각은 captureUs 보다 몇 ms 전인지 (모르면 0xFFFFFFFF). 버전 1 레코드는 항목이 serverId / uuid 뿐이고
+// 나머지 요약은 기본값 (ScanStats)
+//
+// 정수는 frame_protocol.h 와 같이 네트워크 바이트 오더. 좌표는 원본 프레임 px
+
+static constexpr uint8_t FRAME_RESULTS_VERSION = 2;
+static constexpr uint32_t FRAME_RESULTS_UNKNOWN_AGE = 0xFFFFFFFFu;
+
+// flags
+static constexpr uint8_t FRAME_RESULTS_SCANS = 0x01; // 스캔 결과 포함
+
+struct QrResult
+{
+    std::string text; // 디코딩 실패 시 빈 문자열 (서버에 키프레임을 요청하는 근거)
+    float corners[8]; // x0, y0, ... x3, y3
+};
+
+struct LineResult
+{
+    float rho;   // cv::HoughLines 의 (rho, theta)
+    float theta;
+};
+
+struct BoxResult
+{
+    uint16_t x;
+    uint16_t y;
+    uint16_t width;
+    uint16_t height;
+};
+
+struct FrameResults
+{
+    uint16_t width = 0;
+    uint16_t height = 0;
+    uint64_t captureUs = 0; // Edge 시계 기준 촬영 시각 (UNIX epoch us)
+    std::vector<QrResult> qrCodes;
+    std::vector<LineResult> lines;
+    std::vector<BoxResult> boxes;
+    bool hasScans = false;
+    std::vector<ScanResult> scans;
+};
+
+namespace frame_results_detail
+{
+    static inline void put16(std::vector<unsigned char> &out, uint16_t value)
+    {
+        value = htons(value);
+        const unsigned char *bytes = reinterpret_cast<const unsigned char *>(&value);
+        out.insert(out.end(), bytes, bytes + 2);
+    }
+
+    static inline void put32(std::vector<unsigned char> &out, uint32_t value)
+    {
+        value = htonl(value);
+        const unsigned char *bytes = reinterpret_cast<const unsigned char *>(&value);
+        out.insert(out.end(), bytes, bytes + 4);
+    }
+
+    static inline void putString(std::vector<unsigned char> &out, const std::string &value)
+    {
+        uint16_t length = static_cast<uint16_t>(std::min<size_t>(value.size(), UINT16_MAX));
+        put16(out, length);
+        out.insert(out.end(), value.begin(), value.begin() + length);
+    }
+
+    static inline int16_t clamp16(double value)
+    {
+        return static_cast<int16_t>(std::lround(std::min(32767.0, std::max(-32768.0, value))));
+    }
+
+    // 관측 시각 -> captureUs 기준 경과 ms (captureUs 이후면 0)
+    static inline uint32_t ageMs(uint64_t captureUs, uint64_t seenUs)
+    {
+        if (seenUs == 0)
+        {
+            return FRAME_RESULTS_UNKNOWN_AGE;
+        }
+        uint64_t age = (captureUs - std::min(captureUs, seenUs)) / 1000;
+        return static_cast<uint32_t>(std::min<uint64_t>(age, FRAME_RESULTS_UNKNOWN_AGE - 1));
+    }
+
+    static inline uint64_t seenUs(uint64_t captureUs, uint32_t ageMs)
+    {
+        if (ageMs == FRAME_RESULTS_UNKNOWN_AGE)
+        {
+            return 0;
+        }
+        return captureUs - std::min<uint64_t>(captureUs, static_cast<uint64_t>(ageMs) * 1000);
+    }
+
+    // 경계 검사를 하는 순차 읽기. 한 번이라도 넘치면 ok() 가 false
+    class Reader
+    {
+    public:
+        Reader(const unsigned char *data, size_t size) : data_(data), size_(size) {}
+
+        bool ok() const { return ok_; }
+        bool done() const { return offset_ == size_; }
+
+        uint8_t u8()
+        {
+            unsigned char value = 0;
+            take(&value, 1);
+            return value;
+        }
+
+        uint16_t u16()
+        {
+            uint16_t value = 0;
+            take(&value, 2);
+            return ntohs(value);
+        }
+
+        uint32_t u32()
+        {
+            uint32_t value = 0;
+            take(&value, 4);
+            return ntohl(value);
+        }
+
+        std::string string()
+        {
+            uint16_t length = u16();
+            if (!ok_ || size_ - offset_ < length)
+            {
+                ok_ = false;
+                return std::string();
+            }
+            std::string value(reinterpret_cast<const char *>(data_ + offset_), length);
+            offset_ += length;
+            return value;
+        }
+
+    private:
+        void take(void *out, size_t bytes)
+        {
+            if (!ok_ || size_ - offset_ < bytes)
+            {
+                ok_ = false;
+                return;
+            }
+            std::memcpy(out, data_ + offset_, bytes);
+            offset_ += bytes;
+        }
+
+        const unsigned char *data_;
+        size_t size_;
+        size_t offset_ = 0;
+        bool ok_ = true;
+    };
+}
+
+// 레코드 직렬화 (out 은 비운 뒤 채움). 각 목록은 최대 65535 개까지만 기록
+static inline void encodeFrameResults(const FrameResults &results, std::vector<unsigned char> &out)
+{
+    using namespace frame_results_detail;
+    out.clear();
+    out.push_back(FRAME_RESULTS_VERSION);
+    out.push_back(results.hasScans ? FRAME_RESULTS_SCANS : 0);
+    put16(out, results.width);
+    put16(out, results.height);
+    put32(out, static_cast<uint32_t>(results.captureUs >> 32));
+    put32(out, static_cast<uint32_t>(results.captureUs));
+
+    size_t count = std::min<size_t>(results.qrCodes.size(), UINT16_MAX);
+    put16(out, static_cast<uint16_t>(count));
+    for (size_t i = 0; i < count; ++i)
+    {
+        putString(out, results.qrCodes[i].text);
+        for (float corner : results.qrCodes[i].corners)
+        {
+            put16(out, static_cast<uint16_t>(clamp16(corner)));
+        }
+    }
+
+    count = std::min<size_t>(results.lines.size(), UINT16_MAX);
+    put16(out, static_cast<uint16_t>(count));
+    for (size_t i = 0; i < count; ++i)
+    {
+        double theta = std::min(M_PI, std::max(0.0, static_cast<double>(results.lines[i].theta)));
+        put16(out, static_cast<uint16_t>(clamp16(results.lines[i].rho * 8.0)));
+        put16(out, static_cast<uint16_t>(std::lround(theta / M_PI * 65535.0)));
+    }
+
+    count = std::min<size_t>(results.boxes.size(), UINT16_MAX);
+    put16(out, static_cast<uint16_t>(count));
+    for (size_t i = 0; i < count; ++i)
+    {
+        const BoxResult &box = results.boxes[i];
+        put16(out, box.x);
+        put16(out, box.y);
+        put16(out, box.width);
+        put16(out, box.height);
+    }
+
+    if (results.hasScans)
+    {
+        count = std::min<size_t>(results.scans.size(), UINT16_MAX);
+        put16(out, static_cast<uint16_t>(count));
+        for (size_t i = 0; i < count; ++i)
+        {
+            const ScanResult &scan = results.scans[i];
+            putString(out, scan.hubId);
+            size_t entries = std::min<size_t>(scan.logList.size(), UINT16_MAX);
+            put16(out, static_cast<uint16_t>(entries));
+            for (size_t e = 0; e < entries; ++e)
+            {
+                const Entry &entry = scan.logList[e];
+                putString(out, entry.serverId);
+                put32(out, static_cast<uint32_t>(entry.uuid));
+                put32(out, entry.stats.count);
+                put32(out, ageMs(results.captureUs, entry.stats.firstSeenUs));
+                put32(out, ageMs(results.captureUs, entry.stats.lastSeenUs));
+                out.push_back(static_cast<unsigned char>(entry.stats.rssiMin));
+                out.push_back(static_cast<unsigned char>(entry.stats.rssiMax));
+                out.push_back(static_cast<unsigned char>(entry.stats.rssiMean));
+            }
+        }
+    }
+}
+
+// 레코드 복원 (버전 1 도 읽음). 모르는 버전이거나 잘렸거나 남는 바이트가 있으면 false
+static inline bool decodeFrameResults(const unsigned char *data, size_t size, FrameResults &results)
+{
+    using namespace frame_results_detail;
+    Reader reader(data, size);
+    results = FrameResults();
+    uint8_t version = reader.u8();
+    if (version < 1 || version > FRAME_RESULTS_VERSION)
+    {
+        return false;
+    }
+    uint8_t flags = reader.u8();
+    results.width = reader.u16();
+    results.height = reader.u16();
+    uint64_t high = reader.u32();
+    results.captureUs = (high << 32) | reader.u32();
+
+    results.qrCodes.resize(reader.u16());
+    for (auto &code : results.qrCodes)
+    {
+        code.text = reader.string();
+        for (float &corner : code.corners)
+        {
+            corner = static_cast<int16_t>(reader.u16());
+        }
+    }
+
+    results.lines.resize(reader.u16());
+    for (auto &line : results.lines)
+    {
+        line.rho = static_cast<int16_t>(reader.u16()) / 8.0f;
+        line.theta = static_cast<float>(reader.u16() / 65535.0 * M_PI);
+    }
+
+    results.boxes.resize(reader.u16());
+    for (auto &box : results.boxes)
+    {
+        box.x = reader.u16();
+        box.y = reader.u16();
+        box.width = reader.u16();
+        box.height = reader.u16();
+    }
+
+    results.hasScans = (flags & FRAME_RESULTS_SCANS) != 0;
+    if (results.hasScans)
+    {
+        results.scans.resize(reader.u16());
+        for (auto &scan : results.scans)
+        {
+            scan.hubId = reader.string();
+            scan.logList.resize(reader.u16());
+            for (auto &entry : scan.logList)
+            {
+                entry.serverId = reader.string();
+                entry.uuid = static_cast<int32_t>(reader.u32());
+                if (version >= 2)
+                {
+                    entry.stats.count = reader.u32();
+                    entry.stats.firstSeenUs = seenUs(results.captureUs, reader.u32());
+                    entry.stats.lastSeenUs = seenUs(results.captureUs, reader.u32());
+                    entry.stats.rssiMin = static_cast<int8_t>(reader.u8());
+                    entry.stats.rssiMax = static_cast<int8_t>(reader.u8());
+                    entry.stats.rssiMean = static_cast<int8_t>(reader.u8());
+                }
+            }
+        }
+    }
+    return reader.ok() && reader.done();
+}
+
+#endif // FRAME_RESULTS_H
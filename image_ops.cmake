@@ -0,0 +1,11 @@
+# Edge 와 서버가 함께 쓰는 이미지 처리 라이브러리 (image_ops.h)
+# 각 프로젝트에서 OpenCV 를 찾은 뒤 include 하고 image_ops 를 링크
+add_library(image_ops STATIC ${CMAKE_CURRENT_LIST_DIR}/image_ops.cpp)
+target_include_directories(image_ops PUBLIC ${CMAKE_CURRENT_LIST_DIR} ${OpenCV_INCLUDE_DIRS})
+target_link_libraries(image_ops PUBLIC ${OpenCV_LIBS})
+
+# 프레임 단계별 트레이스 (trace.h). 켜면 image_ops 를 링크하는 대상(edge_ble, mac_server 등)에 FRAME_TRACE=1 이 전파됨
+option(FRAME_TRACE "Build with per-stage Chrome trace instrumentation (trace.h)" OFF)
+if(FRAME_TRACE)
+    target_compile_definitions(image_ops PUBLIC FRAME_TRACE=1)
+endif()
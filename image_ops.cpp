@@ -0,0 +1,449 @@
+#include "image_ops.h"
+#include "trace.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+cv::Mat calcGrayHist(const cv::Mat &img)
+{
+    CV_Assert(img.type() == CV_8UC1);
+
+    cv::Mat hist;
+    int channels[] = {0};
+    int dims = 1;
+    const int histSize[] = {256};
+    float graylevel[] = {0, 256};
+    const float *ranges[] = {graylevel};
+
+    cv::calcHist(&img, 1, channels, cv::noArray(), hist, dims, histSize, ranges);
+
+    return hist;
+}
+
+cv::Mat getGrayHistImage(const cv::Mat &hist)
+{
+    CV_Assert(hist.type() == CV_32FC1);
+    CV_Assert(hist.size() == cv::Size(1, 256));
+
+    double histMax;
+    minMaxLoc(hist, 0, &histMax);
+
+    cv::Mat imgHist(100, 256, CV_8UC1, cv::Scalar(255));
+    for (int i = 0; i < 256; i++)
+    {
+        cv::line(imgHist, cv::Point(i, 100),
+                 cv::Point(i, 100 - cvRound(hist.at<float>(i, 0) * 100 / histMax)),
+                 cv::Scalar(0));
+    }
+
+    return imgHist;
+}
+
+cv::Mat filter_embossing(const cv::Mat &img)
+{
+    if (img.empty())
+    {
+        std::cerr << "Failed to load image from sample.jpg" << std::endl;
+    }
+
+    float data[] = {-1, -1, 0, -1, 0, 1, 0, 1, 1};
+    cv::Mat emboss(3, 3, CV_32FC1, data);
+
+    cv::Mat dst;
+    filter2D(img, dst, -1, emboss, cv::Point(-1, -1), 128);
+
+    return dst;
+}
+
+cv::Mat blurring_mean(const cv::Mat &img)
+{
+    if (img.empty())
+    {
+        std::cerr << "Failed to load image from sample.jpg" << std::endl;
+    }
+
+    cv::Mat dst;
+    for (int ksize = 3; ksize <= 7; ksize += 2)
+    {
+        blur(img, dst, cv::Size(ksize, ksize));
+
+        cv::String desc = cv::format("Mean: %dx%d", ksize, ksize);
+        putText(dst, desc, cv::Point(10, 30), cv::FONT_HERSHEY_SIMPLEX, 1.0, cv::Scalar(255), 1, cv::LINE_AA);
+    }
+
+    return dst;
+}
+
+cv::Mat blurring_affine_Transform(const cv::Mat &img)
+{
+    if (img.empty())
+    {
+        std::cerr << "Failed to load image from sample.jpg" << std::endl;
+        return cv::Mat(); // 비어있는 Mat 반환
+    }
+
+    // 원본 및 변환 좌표 설정
+    cv::Point2f srcPts[3] = {
+        cv::Point2f(0, 0),
+        cv::Point2f(img.cols - 1, 0),
+        cv::Point2f(img.cols - 1, img.rows - 1)};
+    cv::Point2f dstPts[3] = {
+        cv::Point2f(0, 0),
+        cv::Point2f(img.cols - 1, 0),
+        cv::Point2f(img.cols - 50, img.rows - 50)}; // 변환을 더 명확하게 하기 위해 x 좌표도 이동
+
+    // 변환 행렬 계산
+    cv::Mat M = getAffineTransform(srcPts, dstPts);
+
+    // 행렬 출력 (디버깅용)
+    std::cout << "Affine Transform Matrix:\n"
+              << M << std::endl;
+
+    // 블러링 적용
+    cv::Mat blurred;
+    blur(img, blurred, cv::Size(7, 7)); // 블러링 커널 크기 7x7
+
+    // 어파인 변환 수행
+    cv::Mat dst;
+    warpAffine(blurred, dst, M, img.size()); // img.size()로 출력 이미지 크기 지정
+
+    // 변환된 이미지 저장 (디버깅용)
+    cv::imwrite("affine_transformed_image.jpg", dst);
+
+    // 결과 반환
+    return dst;
+}
+
+// 직선 검출 해상도 변환: 에지 영상을 2x2 최대값 풀링으로 levels 번 줄임 (HoughLines 비용은 에지 화소 수에 비례)
+// 에지 검출과 윤곽선은 원본 해상도 그대로라 사각형 결과는 levels 와 무관함. 실제로 줄인 횟수를 반환
+static int poolEdges(const cv::Mat &edges, cv::Mat &dst, int levels)
+{
+    levels = std::min(std::max(levels, 0), ANALYSIS_MAX_LEVELS);
+    dst = edges;
+    int done = 0;
+    for (; done < levels && dst.cols >= 64 && dst.rows >= 64; ++done)
+    {
+        cv::Mat next;
+        cv::resize(dst, next, cv::Size((dst.cols + 1) / 2, (dst.rows + 1) / 2), 0, 0, cv::INTER_AREA);
+        cv::threshold(next, dst, 0, 255, cv::THRESH_BINARY);
+    }
+    return done;
+}
+
+// 풀링한 에지는 가까운 에지가 한 화소로 합쳐져 투표 수가 해상도만큼 줄지 않음.
+// 원본 해상도 결과와 맞춘 배율 (analysis_scale_bench 합성 장면 두 개에서 직선 재현율 / 정밀도가 함께 90% 안팎이 되는 값)
+static int houghThreshold(int fullThreshold, int levels)
+{
+    static const double scales[ANALYSIS_MAX_LEVELS + 1] = {1.0, 0.98};
+    return std::max(8, static_cast<int>(std::lround(fullThreshold * scales[levels])));
+}
+
+// 풀링한 에지에서 찾은 직선을 원본 좌표로. 풀링 화소 i 는 원본 화소 2^levels * i ~ 2^levels * (i + 1) - 1 의 중심
+static void scaleLines(std::vector<cv::Vec2f> &lines, int levels)
+{
+    if (levels == 0)
+        return;
+    float scale = static_cast<float>(1 << levels);
+    float offset = (scale - 1) / 2;
+    for (cv::Vec2f &line : lines)
+        line[0] = line[0] * scale + offset * (std::cos(line[1]) + std::sin(line[1]));
+}
+
+cv::Mat hough_lines(const cv::Mat &img, int levels)
+{
+    if(img.empty()) {
+        std::cerr << "Input image is empty!" << std::endl;
+        return cv::Mat();
+    }
+
+    cv::Mat edge, small;
+    Canny(img, edge, 50, 150);
+
+    std::vector<cv::Vec2f> lines;
+    levels = poolEdges(edge, small, levels);
+    cv::HoughLines(small, lines, 1, CV_PI / 180, houghThreshold(250, levels));
+    scaleLines(lines, levels);
+
+    cv::Mat dst;
+    cv::cvtColor(edge, dst, cv::COLOR_GRAY2BGR);
+
+    for(size_t i=0; i<lines.size(); i++) {
+        float r = lines[i][0], t = lines[i][1];
+        double cos_t = cos(t), sin_t = sin(t);
+        double x0 = r*cos_t, y0 = r * sin_t;
+        double alpha = 1000;
+
+        cv::Point pt1(cvRound(x0 + alpha * (-sin_t)), cvRound(y0 + alpha * cos_t));
+        cv::Point pt2(cvRound(x0 - alpha * (-sin_t)), cvRound(y0 - alpha * cos_t));
+        line(dst, pt1, pt2, cv::Scalar(0, 0, 255), 2, cv::LINE_AA);
+    }
+
+    return dst;
+}
+
+cv::Mat hough_lines_optimized(const cv::Mat &img, int levels)
+{
+    if(img.empty()) {
+        std::cerr << "Input image is empty!" << std::endl;
+        return cv::Mat();
+    }
+
+    // Step 1: Noise reduction
+    cv::Mat blurred, edge, small;
+    cv::GaussianBlur(img, blurred, cv::Size(5, 5), 1.5);
+    cv::Canny(blurred, edge, 50, 150);
+
+    // Step 2: Hough Line Transform
+    std::vector<cv::Vec2f> lines;
+    levels = poolEdges(edge, small, levels);
+    cv::HoughLines(small, lines, 1, CV_PI / 180, houghThreshold(450, levels));
+    scaleLines(lines, levels);
+
+    cv::Mat dst;
+    cv::cvtColor(edge, dst, cv::COLOR_GRAY2BGR);
+
+    // Step 3: Filter lines based on angle and position
+    for(size_t i = 0; i < lines.size(); i++) {
+        float r = lines[i][0], t = lines[i][1];
+        // Filter for near-vertical or near-horizontal lines
+        if (std::abs(t) < CV_PI / 18 || std::abs(t - CV_PI / 2) < CV_PI / 18) {
+            double cos_t = cos(t), sin_t = sin(t);
+            double x0 = r * cos_t, y0 = r * sin_t;
+            double alpha = 1000;
+
+            cv::Point pt1(cvRound(x0 + alpha * (-sin_t)), cvRound(y0 + alpha * cos_t));
+            cv::Point pt2(cvRound(x0 - alpha * (-sin_t)), cvRound(y0 - alpha * cos_t));
+            line(dst, pt1, pt2, cv::Scalar(0, 0, 255), 2, cv::LINE_AA);
+        }
+    }
+
+    return dst;
+}
+
+void analyze_image(const cv::Mat &img, cv::Mat &enhanced, cv::Mat &edges, std::vector<cv::Vec2f> &lines,
+                   std::vector<std::vector<cv::Point>> &contours, int levels)
+{
+    // Step 1: 그레이스케일 변환 및 대비 조정
+    cv::Mat gray;
+    {
+        TRACE_SCOPE("gray");
+        cv::cvtColor(img, gray, cv::COLOR_BGR2GRAY);
+    }
+
+    // CLAHE(Contrast Limited Adaptive Histogram Equalization) 적용
+    {
+        TRACE_SCOPE("clahe");
+        cv::Ptr<cv::CLAHE> clahe = cv::createCLAHE(2.0, cv::Size(8, 8));
+        clahe->apply(gray, enhanced);
+    }
+
+    // Step 2: 가우시안 블러 적용 (노이즈 제거)
+    cv::Mat blurred;
+    {
+        TRACE_SCOPE("blur");
+        cv::GaussianBlur(enhanced, blurred, cv::Size(5, 5), 1.5);
+    }
+
+    // Step 3: Canny Edge Detection 수행
+    {
+        TRACE_SCOPE("canny");
+        cv::Canny(blurred, edges, 50, 150);
+    }
+
+    // Step 4: Hough Line Transform 적용
+    {
+        TRACE_SCOPE("hough");
+        cv::Mat small;
+        levels = poolEdges(edges, small, levels);
+        cv::HoughLines(small, lines, 1, CV_PI / 180, houghThreshold(100, levels));
+        scaleLines(lines, levels);
+    }
+
+    // Step 5: 형태학적 연산을 활용한 노이즈 제거
+    TRACE_SCOPE("contours");
+    cv::Mat morphKernel = cv::getStructuringElement(cv::MORPH_RECT, cv::Size(3, 3));
+    cv::Mat morphProcessed;
+    cv::morphologyEx(edges, morphProcessed, cv::MORPH_CLOSE, morphKernel);
+
+    // Step 6: 윤곽선 검출
+    std::vector<cv::Vec4i> hierarchy;
+    cv::findContours(morphProcessed, contours, hierarchy, cv::RETR_EXTERNAL, cv::CHAIN_APPROX_SIMPLE);
+}
+
+cv::Mat process_image_all_advanced(const cv::Mat &img, int levels)
+{
+    if (img.empty()) {
+        std::cerr << "Error: Input image is empty!" << std::endl;
+        return cv::Mat();
+    }
+
+    cv::Mat enhanced, edges;
+    std::vector<cv::Vec2f> lines;
+    std::vector<std::vector<cv::Point>> contours;
+    analyze_image(img, enhanced, edges, lines, contours, levels);
+    return drawAnalysis(img, enhanced, edges, lines, contours);
+}
+
+cv::Mat process_image_all_advanced(const cv::Mat &img, CompositeCanvas &canvas, int levels)
+{
+    if (img.empty()) {
+        std::cerr << "Error: Input image is empty!" << std::endl;
+        return cv::Mat();
+    }
+
+    cv::Mat enhanced, edges;
+    std::vector<cv::Vec2f> lines;
+    std::vector<std::vector<cv::Point>> contours;
+    analyze_image(img, enhanced, edges, lines, contours, levels);
+    return canvas.render(img, enhanced, edges, lines, contours);
+}
+
+cv::Mat drawAnalysis(const cv::Mat &img, const cv::Mat &enhanced, const cv::Mat &edges, const std::vector<cv::Vec2f> &lines,
+                     const std::vector<std::vector<cv::Point>> &contours, CompositeCanvas *canvas)
+{
+    if (canvas)
+    {
+        return canvas->render(img, enhanced, edges, lines, contours);
+    }
+    CompositeCanvas local;
+    return local.render(img, enhanced, edges, lines, contours);
+}
+
+void CompositeCanvas::setLayout(const CompositeLayout &layout)
+{
+    if (!(layout == layout_))
+    {
+        layout_ = layout;
+        canvas_.release(); // 다음 render 에서 새 크기로 할당
+    }
+}
+
+// src 를 cell 크기 / BGR 로 맞춰 cell 에 직접 씀. 크기가 같으면 중간 사본 없음
+static bool writeCell(const cv::Mat &src, cv::Mat &cell)
+{
+    cv::Mat sized = src;
+    if (src.size() != cell.size()) {
+        cv::resize(src, sized, cell.size());
+    }
+    if (sized.depth() != CV_8U) {
+        sized.convertTo(sized, CV_8U);
+    }
+
+    if (sized.channels() == 1) {
+        cv::cvtColor(sized, cell, cv::COLOR_GRAY2BGR);
+    } else if (sized.channels() == 3) {
+        sized.copyTo(cell);
+    } else {
+        std::cerr << "Unexpected channel count: " << sized.channels() << std::endl;
+        return false;
+    }
+    return true;
+}
+
+cv::Mat CompositeCanvas::render(const cv::Mat &img, const cv::Mat &enhanced, const cv::Mat &edges,
+                                const std::vector<cv::Vec2f> &lines, const std::vector<std::vector<cv::Point>> &contours)
+{
+    TRACE_SCOPE("composite");
+    int columns = std::max(1, std::min(layout_.columns, static_cast<int>(layout_.panels.size())));
+    int rows = (static_cast<int>(layout_.panels.size()) + columns - 1) / columns;
+    cv::Size cellSize(img.cols, img.rows);
+    cv::Size canvasSize(cellSize.width * columns, cellSize.height * rows);
+    if (canvas_.size() != canvasSize || canvas_.type() != CV_8UC3)
+    {
+        // 남는 칸이 검정으로 남도록 처음 한 번만 0 으로 채움
+        canvas_.create(canvasSize, CV_8UC3);
+        canvas_.setTo(cv::Scalar::all(0));
+    }
+
+    for (size_t i = 0; i < layout_.panels.size(); ++i)
+    {
+        cv::Rect rect(static_cast<int>(i % columns) * cellSize.width, static_cast<int>(i / columns) * cellSize.height,
+                      cellSize.width, cellSize.height);
+        cv::Mat cell = canvas_(rect);
+
+        switch (layout_.panels[i])
+        {
+        case CompositePanel::Enhanced:
+            if (!writeCell(enhanced, cell))
+                return cv::Mat();
+            break;
+        case CompositePanel::Edges:
+            if (!writeCell(edges, cell))
+                return cv::Mat();
+            break;
+        case CompositePanel::Original:
+            if (!writeCell(img, cell))
+                return cv::Mat();
+            break;
+        case CompositePanel::Lines:
+            // 검출한 직선 그리기 (칸 밖으로 나가는 부분은 ROI 경계에서 잘림)
+            if (!writeCell(img, cell))
+                return cv::Mat();
+            for (size_t k = 0; k < lines.size(); k++) {
+                float rho = lines[k][0], theta = lines[k][1];
+                double a = cos(theta), b = sin(theta);
+                double x0 = a * rho, y0 = b * rho;
+                cv::Point pt1(cvRound(x0 + 1000 * (-b)), cvRound(y0 + 1000 * (a)));
+                cv::Point pt2(cvRound(x0 - 1000 * (-b)), cvRound(y0 - 1000 * (a)));
+                cv::line(cell, pt1, pt2, cv::Scalar(0, 0, 255), 2, cv::LINE_AA);
+            }
+            break;
+        case CompositePanel::Contours:
+            // 윤곽선 강조
+            if (!writeCell(img, cell))
+                return cv::Mat();
+            cv::drawContours(cell, contours, -1, cv::Scalar(0, 255, 0), 2);
+            break;
+        }
+    }
+    return canvas_;
+}
+
+void analyzeFrameResults(const cv::Mat &img, FrameResults &results, size_t maxBoxes, int minBoxArea, int levels)
+{
+    results.width = static_cast<uint16_t>(std::min(img.cols, 65535));
+    results.height = static_cast<uint16_t>(std::min(img.rows, 65535));
+    results.lines.clear();
+    results.boxes.clear();
+    if (img.empty())
+    {
+        return;
+    }
+
+    cv::Mat enhanced, edges;
+    std::vector<cv::Vec2f> lines;
+    std::vector<std::vector<cv::Point>> contours;
+    analyze_image(img, enhanced, edges, lines, contours, levels);
+    collectFrameResults(lines, contours, results, maxBoxes, minBoxArea);
+}
+
+void collectFrameResults(const std::vector<cv::Vec2f> &lines, const std::vector<std::vector<cv::Point>> &contours,
+                         FrameResults &results, size_t maxBoxes, int minBoxArea)
+{
+    results.lines.clear();
+    results.boxes.clear();
+    for (const auto &line : lines)
+    {
+        results.lines.push_back({line[0], line[1]});
+    }
+
+    // 작은 윤곽선(잡음)은 빼고 면적 큰 순으로 maxBoxes 개까지
+    std::vector<cv::Rect> boxes;
+    for (const auto &contour : contours)
+    {
+        cv::Rect box = cv::boundingRect(contour);
+        if (box.area() >= minBoxArea)
+        {
+            boxes.push_back(box);
+        }
+    }
+    size_t keep = std::min(boxes.size(), maxBoxes);
+    std::partial_sort(boxes.begin(), boxes.begin() + keep, boxes.end(), [](const cv::Rect &a, const cv::Rect &b)
+                      { return a.area() > b.area(); });
+    for (size_t i = 0; i < keep; ++i)
+    {
+        const cv::Rect &box = boxes[i];
+        results.boxes.push_back({static_cast<uint16_t>(box.x), static_cast<uint16_t>(box.y),
+                                 static_cast<uint16_t>(box.width), static_cast<uint16_t>(box.height)});
+    }
+}
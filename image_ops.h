@@ -0,0 +1,164 @@
+#ifndef IMAGE_OPS_H
+#define IMAGE_OPS_H
+
+#include <opencv2/opencv.hpp>
+#include <algorithm>
+#include <cstddef>
+#include <cstdlib>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "frame_results.h"
+
+// Edge 와 서버가 함께 쓰는 이미지 처리 함수 (image_ops 라이브러리, image_ops.cmake)
+//
+// Edge 가 직접 처리할 수도 있고, 원본 프레임(FRAME_FLAG_RAW)을 보내 서버가 같은 함수로 처리할 수도 있으므로
+// 어느 쪽에서 돌든 결과가 같도록 한 곳에 둠. 모두 입력만 읽고 상태가 없어 여러 스레드에서 동시에 호출해도 됨.
+
+// 분석 해상도: 비용 대부분인 HoughLines 를 에지 영상을 levels 번 2x2 최대값 풀링한 영상에서 하고 직선(rho)을 원본 좌표로 환산함.
+// CLAHE / Canny / 윤곽선은 항상 원본 해상도라 사각형은 levels 와 무관. 0 이면 원본 해상도 (기본)
+// analysis_scale_bench: 합성 장면 1280x720 에서 1/2 은 p50 x1.9, 직선 재현율 90% / 정밀도 91%, 사각형 일치 100%.
+// 1/4 이하는 임계값을 맞춰도 재현율 / 정밀도가 70% 안팎이라 지원하지 않음
+static constexpr int ANALYSIS_MAX_LEVELS = 1;
+
+// "full" / "half" -> levels 0~1
+static inline bool parseAnalysisScale(const std::string &name, int &levels)
+{
+    static const char *names[] = {"full", "half"};
+    for (int i = 0; i <= ANALYSIS_MAX_LEVELS; ++i)
+    {
+        if (name == names[i])
+        {
+            levels = i;
+            return true;
+        }
+    }
+    return false;
+}
+
+// 단순 필터 / 시각화
+cv::Mat calcGrayHist(const cv::Mat &img);
+cv::Mat getGrayHistImage(const cv::Mat &hist);
+cv::Mat filter_embossing(const cv::Mat &img);
+cv::Mat blurring_mean(const cv::Mat &img);
+cv::Mat blurring_affine_Transform(const cv::Mat &img);
+// 반환 이미지는 원본 크기 에지 영상 위에 직선을 그린 것
+cv::Mat hough_lines(const cv::Mat &img, int levels = 0);
+cv::Mat hough_lines_optimized(const cv::Mat &img, int levels = 0);
+
+// process_image_all_advanced 의 분석 단계 (CLAHE -> 블러 -> Canny -> HoughLines -> 윤곽선). 그리기는 하지 않음
+// enhanced / edges / lines / contours 모두 원본 해상도 (levels 는 직선 검출에만 적용)
+void analyze_image(const cv::Mat &img, cv::Mat &enhanced, cv::Mat &edges, std::vector<cv::Vec2f> &lines,
+                   std::vector<std::vector<cv::Point>> &contours, int levels = 0);
+
+// 분석 결과를 [대비 강화 | 에지 | 직선] 으로 이어 붙인 BGR 이미지 (칸은 원본 크기). 입력이 비었으면 빈 Mat
+cv::Mat process_image_all_advanced(const cv::Mat &img, int levels = 0);
+
+// 분석 결과를 결과 레코드에 채움 (width / height / 직선 / 윤곽선 사각형, 기존 목록은 비움)
+// 사각형은 minBoxArea(px^2, 원본 기준) 미만을 빼고 면적 큰 순으로 maxBoxes 개까지
+void analyzeFrameResults(const cv::Mat &img, FrameResults &results, size_t maxBoxes = 256, int minBoxArea = 64,
+                         int levels = 0);
+
+// 합성 이미지의 칸 하나에 들어갈 내용
+enum class CompositePanel
+{
+    Enhanced, // CLAHE 대비 강화 (회색조 -> BGR)
+    Edges,    // Canny 에지 (회색조 -> BGR)
+    Lines,    // 원본 + 검출 직선
+    Contours, // 원본 + 윤곽선
+    Original, // 원본
+};
+
+// 합성 이미지 배치. 칸은 원본 크기이고 panels 순서대로 왼쪽 위부터 columns 개씩 채움 (남는 칸은 검정)
+struct CompositeLayout
+{
+    int columns = 3;
+    std::vector<CompositePanel> panels = {CompositePanel::Enhanced, CompositePanel::Edges, CompositePanel::Lines};
+
+    bool operator==(const CompositeLayout &other) const { return columns == other.columns && panels == other.panels; }
+};
+
+// "row" (대비 | 에지 | 직선, 기본), "grid" (2x2 에 윤곽선 추가) 또는 "panels=lines+contours,cols=1" 형식
+// 칸 이름: enhanced, edges, lines, contours, original. 알 수 없는 값이 있으면 false
+static inline bool parseCompositeLayout(const std::string &text, CompositeLayout &layout)
+{
+    static const char *names[] = {"enhanced", "edges", "lines", "contours", "original"};
+    std::stringstream stream(text);
+    std::string item;
+    while (std::getline(stream, item, ','))
+    {
+        size_t eq = item.find('=');
+        if (item.empty())
+            continue;
+        if (item == "row")
+            layout = CompositeLayout();
+        else if (item == "grid")
+        {
+            layout.columns = 2;
+            layout.panels = {CompositePanel::Enhanced, CompositePanel::Edges, CompositePanel::Lines, CompositePanel::Contours};
+        }
+        else if (eq == std::string::npos)
+            return false;
+        else
+        {
+            std::string key = item.substr(0, eq);
+            std::string value = item.substr(eq + 1);
+            if (key == "cols")
+                layout.columns = std::max(1, std::atoi(value.c_str()));
+            else if (key == "panels")
+            {
+                std::vector<CompositePanel> panels;
+                std::stringstream list(value);
+                std::string name;
+                while (std::getline(list, name, '+'))
+                {
+                    size_t index = 0;
+                    while (index < 5 && name != names[index])
+                        ++index;
+                    if (index == 5)
+                        return false;
+                    panels.push_back(static_cast<CompositePanel>(index));
+                }
+                if (panels.empty())
+                    return false;
+                layout.panels = panels;
+                layout.columns = static_cast<int>(panels.size());
+            }
+            else
+                return false;
+        }
+    }
+    return true;
+}
+
+// 한 번 할당한 합성 이미지 캔버스. 각 칸의 결과를 캔버스의 ROI 에 바로 써서 (회색조 -> BGR 변환 포함)
+// 단계별 BGR 사본이나 hconcat 복사가 없음. 크기 / 배치가 같으면 프레임마다 같은 버퍼를 다시 씀.
+// 스레드 하나에서만 사용. render 가 돌려준 Mat 은 캔버스 버퍼를 가리키므로 다음 render 전까지만 유효
+class CompositeCanvas
+{
+public:
+    explicit CompositeCanvas(const CompositeLayout &layout = CompositeLayout()) : layout_(layout) {}
+
+    const CompositeLayout &layout() const { return layout_; }
+    void setLayout(const CompositeLayout &layout);
+
+    // 실패(지원하지 않는 채널 수 등) 시 빈 Mat
+    cv::Mat render(const cv::Mat &img, const cv::Mat &enhanced, const cv::Mat &edges, const std::vector<cv::Vec2f> &lines,
+                   const std::vector<std::vector<cv::Point>> &contours);
+
+private:
+    CompositeLayout layout_;
+    cv::Mat canvas_;
+};
+
+// process_image_all_advanced 를 캔버스 버퍼에 그림 (Edge 전송 스레드처럼 매 프레임 같은 크기를 처리할 때)
+cv::Mat process_image_all_advanced(const cv::Mat &img, CompositeCanvas &canvas, int levels = 0);
+
+// 위 두 함수의 뒷단. analyze_image 한 번으로 합성 이미지와 결과 레코드를 모두 만들 때 사용 (서버 처리)
+// canvas 가 없으면 기본 배치로 새 버퍼에 그림
+cv::Mat drawAnalysis(const cv::Mat &img, const cv::Mat &enhanced, const cv::Mat &edges, const std::vector<cv::Vec2f> &lines,
+                     const std::vector<std::vector<cv::Point>> &contours, CompositeCanvas *canvas = nullptr);
+void collectFrameResults(const std::vector<cv::Vec2f> &lines, const std::vector<std::vector<cv::Point>> &contours,
+                         FrameResults &results, size_t maxBoxes = 256, int minBoxArea = 64);
+
+#endif // IMAGE_OPS_H
@@ -0,0 +1,397 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// 저부하 메트릭 수집 (Edge / MAC Server 공용)
+//
+// - Counter   : 스레드별 슬롯에 relaxed atomic 덧셈. 기록 경로에 락 없음
+// - Histogram : HDR 방식 로그-선형 버킷 (2의 거듭제곱 구간마다 16개 하위 버킷, 상대 오차 약 6%)
+//               스레드별 버킷 배열에 기록하고 스냅샷 시에만 합산
+// - 스냅샷은 Prometheus 텍스트 포맷으로 출력 (HTTP 엔드포인트 또는 주기적 파일 덤프)
+
+static constexpr size_t METRICS_MAX_THREADS = 64; // 스레드 슬롯 수. 초과 시 슬롯을 공유 (여전히 원자적)
+
+// 현재 스레드의 슬롯 번호 (최초 호출 시 한 번 할당)
+static inline size_t metricsThreadSlot()
+{
+    static std::atomic<size_t> nextSlot{0};
+    thread_local size_t slot = nextSlot.fetch_add(1, std::memory_order_relaxed) % METRICS_MAX_THREADS;
+    return slot;
+}
+
+static inline uint64_t metricsNowNs()
+{
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                     std::chrono::steady_clock::now().time_since_epoch())
+                                     .count());
+}
+
+class Counter
+{
+public:
+    Counter(std::string name, std::string help) : name_(std::move(name)), help_(std::move(help)) {}
+
+    void add(uint64_t value = 1)
+    {
+        slots_[metricsThreadSlot()].value.fetch_add(value, std::memory_order_relaxed);
+    }
+
+    uint64_t value() const
+    {
+        uint64_t total = 0;
+        for (const auto &slot : slots_)
+        {
+            total += slot.value.load(std::memory_order_relaxed);
+        }
+        return total;
+    }
+
+    const std::string &name() const { return name_; }
+    const std::string &help() const { return help_; }
+
+private:
+    // false sharing 방지를 위해 캐시 라인 단위로 정렬
+    struct alignas(64) Slot
+    {
+        std::atomic<uint64_t> value{0};
+    };
+
+    std::string name_;
+    std::string help_;
+    std::array<Slot, METRICS_MAX_THREADS> slots_;
+};
+
+// 나노초 단위 지연 시간 히스토그램
+class Histogram
+{
+public:
+    static constexpr int SUB_BITS = 4;
+    static constexpr uint64_t SUB_COUNT = 1u << SUB_BITS;
+    static constexpr size_t BUCKET_COUNT = (64 - SUB_BITS + 1) * SUB_COUNT;
+
+    struct Snapshot
+    {
+        std::vector<uint64_t> buckets = std::vector<uint64_t>(BUCKET_COUNT, 0);
+        uint64_t count = 0;
+        uint64_t sum = 0;
+        uint64_t max = 0;
+
+        // q (0~1) 분위수의 근사값 (버킷 상한)
+        uint64_t quantile(double q) const
+        {
+            if (count == 0)
+            {
+                return 0;
+            }
+            uint64_t rank = static_cast<uint64_t>(q * static_cast<double>(count - 1)) + 1;
+            uint64_t seen = 0;
+            for (size_t i = 0; i < BUCKET_COUNT; ++i)
+            {
+                seen += buckets[i];
+                if (seen >= rank)
+                {
+                    return std::min(bucketUpperBound(i), max);
+                }
+            }
+            return max;
+        }
+    };
+
+    Histogram(std::string name, std::string labels, std::string help)
+        : name_(std::move(name)), labels_(std::move(labels)), help_(std::move(help)) {}
+
+    ~Histogram()
+    {
+        for (auto &shard : shards_)
+        {
+            delete shard.load(std::memory_order_acquire);
+        }
+    }
+
+    void record(uint64_t valueNs)
+    {
+        Shard &shard = localShard();
+        shard.buckets[bucketIndex(valueNs)].fetch_add(1, std::memory_order_relaxed);
+        shard.count.fetch_add(1, std::memory_order_relaxed);
+        shard.sum.fetch_add(valueNs, std::memory_order_relaxed);
+
+        uint64_t currentMax = shard.max.load(std::memory_order_relaxed);
+        while (valueNs > currentMax && !shard.max.compare_exchange_weak(currentMax, valueNs, std::memory_order_relaxed))
+        {
+        }
+    }
+
+    Snapshot snapshot() const
+    {
+        Snapshot result;
+        for (const auto &entry : shards_)
+        {
+            const Shard *shard = entry.load(std::memory_order_acquire);
+            if (!shard)
+            {
+                continue;
+            }
+            for (size_t i = 0; i < BUCKET_COUNT; ++i)
+            {
+                result.buckets[i] += shard->buckets[i].load(std::memory_order_relaxed);
+            }
+            result.count += shard->count.load(std::memory_order_relaxed);
+            result.sum += shard->sum.load(std::memory_order_relaxed);
+            result.max = std::max(result.max, shard->max.load(std::memory_order_relaxed));
+        }
+        return result;
+    }
+
+    // 값 -> 버킷 번호. SUB_COUNT 미만은 선형, 이후는 최상위 비트 구간별로 SUB_COUNT 등분
+    static size_t bucketIndex(uint64_t value)
+    {
+        if (value < SUB_COUNT)
+        {
+            return static_cast<size_t>(value);
+        }
+        int msb = 63 - __builtin_clzll(value);
+        uint64_t mantissa = (value >> (msb - SUB_BITS)) & (SUB_COUNT - 1);
+        return static_cast<size_t>((msb - SUB_BITS + 1) * SUB_COUNT + mantissa);
+    }
+
+    static uint64_t bucketUpperBound(size_t index)
+    {
+        if (index < SUB_COUNT)
+        {
+            return index;
+        }
+        uint64_t group = index / SUB_COUNT;
+        uint64_t mantissa = index % SUB_COUNT;
+        int shift = static_cast<int>(group) - 1;
+        return ((SUB_COUNT + mantissa + 1) << shift) - 1;
+    }
+
+    const std::string &name() const { return name_; }
+    const std::string &labels() const { return labels_; }
+    const std::string &help() const { return help_; }
+
+private:
+    struct Shard
+    {
+        std::array<std::atomic<uint64_t>, BUCKET_COUNT> buckets{};
+        std::atomic<uint64_t> count{0};
+        std::atomic<uint64_t> sum{0};
+        std::atomic<uint64_t> max{0};
+    };
+
+    // 슬롯의 shard 는 최초 기록 시 할당. 슬롯을 공유하는 스레드끼리 경합하면 CAS 로 하나만 채택
+    Shard &localShard()
+    {
+        auto &entry = shards_[metricsThreadSlot()];
+        Shard *shard = entry.load(std::memory_order_acquire);
+        if (shard)
+        {
+            return *shard;
+        }
+
+        Shard *created = new Shard();
+        if (entry.compare_exchange_strong(shard, created, std::memory_order_acq_rel))
+        {
+            return *created;
+        }
+        delete created;
+        return *shard;
+    }
+
+    std::string name_;
+    std::string labels_;
+    std::string help_;
+    std::array<std::atomic<Shard *>, METRICS_MAX_THREADS> shards_{};
+};
+
+// 구간 시간을 측정해 히스토그램에 기록하는 RAII 타이머
+class ScopedTimer
+{
+public:
+    explicit ScopedTimer(Histogram &histogram) : histogram_(histogram), start_(metricsNowNs()) {}
+    ~ScopedTimer() { histogram_.record(metricsNowNs() - start_); }
+
+    ScopedTimer(const ScopedTimer &) = delete;
+    ScopedTimer &operator=(const ScopedTimer &) = delete;
+
+private:
+    Histogram &histogram_;
+    uint64_t start_;
+};
+
+// 메트릭 등록 및 Prometheus 텍스트 출력
+// 등록은 시작 시점에만 수행하고, 반환된 참조를 보관해 기록 경로에서 사용
+class MetricsRegistry
+{
+public:
+    static MetricsRegistry &instance()
+    {
+        static MetricsRegistry registry;
+        return registry;
+    }
+
+    Counter &counter(const std::string &name, const std::string &help)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (auto &counter : counters_)
+        {
+            if (counter->name() == name)
+            {
+                return *counter;
+            }
+        }
+        counters_.push_back(std::make_unique<Counter>(name, help));
+        return *counters_.back();
+    }
+
+    // labels 예: "stage=\"decode\""
+    Histogram &histogram(const std::string &name, const std::string &labels, const std::string &help)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (auto &histogram : histograms_)
+        {
+            if (histogram->name() == name && histogram->labels() == labels)
+            {
+                return *histogram;
+            }
+        }
+        histograms_.push_back(std::make_unique<Histogram>(name, labels, help));
+        return *histograms_.back();
+    }
+
+    // 지연 시간은 summary (분위수 + 합계 + 개수, 초 단위) 로 출력
+    std::string renderPrometheus() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::ostringstream out;
+
+        for (const auto &counter : counters_)
+        {
+            out << "# HELP " << counter->name() << " " << counter->help() << "\n"
+                << "# TYPE " << counter->name() << " counter\n"
+                << counter->name() << " " << counter->value() << "\n";
+        }
+
+        // 같은 이름(레이블만 다른)의 히스토그램은 한 메트릭 패밀리로 묶어서 출력
+        std::vector<std::string> names;
+        for (const auto &histogram : histograms_)
+        {
+            if (std::find(names.begin(), names.end(), histogram->name()) == names.end())
+            {
+                names.push_back(histogram->name());
+            }
+        }
+
+        for (const auto &name : names)
+        {
+            bool headerWritten = false;
+            for (const auto &histogram : histograms_)
+            {
+                if (histogram->name() != name)
+                {
+                    continue;
+                }
+                if (!headerWritten)
+                {
+                    out << "# HELP " << name << " " << histogram->help() << "\n"
+                        << "# TYPE " << name << " summary\n";
+                    headerWritten = true;
+                }
+
+                Histogram::Snapshot snap = histogram->snapshot();
+                std::string prefix = histogram->labels().empty() ? "" : histogram->labels() + ",";
+                for (double q : {0.5, 0.9, 0.99, 0.999})
+                {
+                    out << name << "{" << prefix << "quantile=\"" << q << "\"} "
+                        << nsToSeconds(snap.quantile(q)) << "\n";
+                }
+                std::string labelSet = histogram->labels().empty() ? "" : "{" + histogram->labels() + "}";
+                out << name << "_sum" << labelSet << " " << nsToSeconds(snap.sum) << "\n"
+                    << name << "_count" << labelSet << " " << snap.count << "\n"
+                    << name << "_max" << labelSet << " " << nsToSeconds(snap.max) << "\n";
+            }
+        }
+        return out.str();
+    }
+
+private:
+    MetricsRegistry() = default;
+
+    static std::string nsToSeconds(uint64_t ns)
+    {
+        char buf[32];
+        snprintf(buf, sizeof(buf), "%.9f", static_cast<double>(ns) / 1e9);
+        return buf;
+    }
+
+    mutable std::mutex mutex_;
+    std::vector<std::unique_ptr<Counter>> counters_;
+    std::vector<std::unique_ptr<Histogram>> histograms_;
+};
+
+// 일정 주기로 스냅샷을 파일에 기록 (임시 파일에 쓴 뒤 rename 하여 읽는 쪽이 잘린 파일을 보지 않게 함)
+class MetricsFileDumper
+{
+public:
+    MetricsFileDumper(std::string path, std::chrono::seconds interval)
+        : path_(std::move(path)), interval_(interval), thread_(&MetricsFileDumper::run, this) {}
+
+    ~MetricsFileDumper()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        cv_.notify_one();
+        thread_.join();
+        dump(); // 종료 시점의 최종 값 기록
+    }
+
+    void dump() const
+    {
+        std::string tmpPath = path_ + ".tmp";
+        {
+            std::ofstream out(tmpPath, std::ios::trunc);
+            if (!out)
+            {
+                return;
+            }
+            out << MetricsRegistry::instance().renderPrometheus();
+        }
+        std::rename(tmpPath.c_str(), path_.c_str());
+    }
+
+private:
+    void run()
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (!cv_.wait_for(lock, interval_, [this]
+                             { return stopping_; }))
+        {
+            dump();
+        }
+    }
+
+    std::string path_;
+    std::chrono::seconds interval_;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    bool stopping_ = false;
+    std::thread thread_; // 다른 멤버 초기화 후 시작되도록 마지막에 선언
+};
+
+#endif // METRICS_H
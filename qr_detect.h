@@ -0,0 +1,432 @@
+#ifndef QR_DETECT_H
+#define QR_DETECT_H
+
+#include <opencv2/opencv.hpp>
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <vector>
+#include "qr_finder.h"
+
+// QR 코드 검출 + 디코딩 단계
+//
+// cv::QRCodeDetector::detectAndDecodeMulti 는 전체 프레임에서 돌리면 Pi 에서 너무 느리므로
+// QrFinderScanner 로 파인더 패턴 후보를 먼저 찾고, 후보가 묶인 ROI 에서만 검출기를 돌림.
+// 후보가 없으면 검출기를 아예 돌리지 않음 (코드가 없는 프레임이 대부분인 경우 비용이 행 스캔뿐).
+//
+// 프레임마다 피라미드(1/2 씩)를 한 번 만들고
+//   - 가장 거친 레벨부터 파인더를 찾음. 아래 레벨은 위 레벨에서 모듈이 너무 작아 안 보이는 코드만 찾음
+//   - 검출기는 모듈이 detectModule px 이상 남는 가장 거친 레벨의 ROI 에서 돌리고, 디코딩에 실패하면 한 레벨씩 내려감
+//   - 원본에서도 모듈이 작은 코드는 ROI 를 2배 키워 디코딩 (작은 코드 인식률)
+// 찾은 코드는 추적해서 다음 프레임에는 예측 위치의 ROI 만 재확인하고, 추적을 잃었거나
+// searchEvery 프레임이 지났을 때만 피라미드 전체 탐색을 다시 함.
+
+struct QrDetection
+{
+    std::string text;                 // 디코딩 실패 시 빈 문자열 (위치만 검출)
+    std::vector<cv::Point2f> corners; // 원본 프레임 좌표의 네 꼭짓점
+    float module = 0;                 // 추정 모듈 크기 (원본 px, 모르면 0)
+    uint32_t track = 0;               // 추적 번호 (0 이면 추적하지 않음)
+};
+
+struct QrDetectConfig
+{
+    bool preLocalize = true;     // false 면 항상 전체 프레임 검출 (피라미드 / 추적 없음)
+    int fullFrameEvery = 0;      // 탐색 N 번마다 한 번은 전체 프레임 검출 (파인더를 놓친 코드 보완, 0 이면 끔)
+    int pyramidLevels = 3;       // 1 이면 원본 해상도만. x86 qr_bench 에서는 1 보다 빠르지 않았음 (Pi 에서 다시 잴 것)
+    float detectModule = 4.0f;   // 검출기를 돌릴 레벨에서 남아야 하는 최소 모듈 크기 (px)
+    float upscaleBelow = 3.0f;   // 원본 모듈이 이보다 작으면 ROI 를 2배 키워 검출
+    bool track = true;           // 프레임 사이 코드 추적
+    int maxMissed = 2;           // 연속 재확인 실패가 이보다 많으면 추적 종료
+    int searchEvery = 15;        // 추적 중에도 N 프레임마다 새 코드 탐색
+    size_t maxTracks = 16;
+    QrFinderConfig finder;
+};
+
+struct QrDetectStats
+{
+    size_t candidates = 0;   // 파인더 후보 수 (모든 레벨 합)
+    size_t dropped = 0;      // maxCandidates 를 넘어 버린 후보 수 (모든 레벨 합)
+    size_t rois = 0;         // 검출기를 돌린 ROI 수 (추적 재확인 포함)
+    double roiFraction = 0;  // 검출기에 넘긴 픽셀 수 / 프레임 픽셀 수
+    bool fullFrame = false;  // 전체 프레임 검출을 했는지
+    bool searched = false;   // 피라미드 탐색(또는 전체 프레임 검출)을 했는지
+    size_t tracked = 0;      // 재확인에 성공한 추적 수
+    size_t lost = 0;         // 이번 프레임에 잃은 추적 수
+};
+
+class QrDetectStage
+{
+public:
+    explicit QrDetectStage(const QrDetectConfig &config = QrDetectConfig()) : config_(config) {}
+
+    // BGR 또는 그레이 8비트 프레임에서 QR 코드 검출
+    std::vector<QrDetection> detect(const cv::Mat &image)
+    {
+        std::vector<QrDetection> detections;
+        stats_ = QrDetectStats();
+        detectorPixels_ = 0;
+        if (image.empty())
+        {
+            return detections;
+        }
+
+        if (image.channels() == 1)
+        {
+            gray_ = image;
+        }
+        else
+        {
+            cv::cvtColor(image, gray_, cv::COLOR_BGR2GRAY);
+        }
+        ++frames_;
+
+        if (!config_.preLocalize)
+        {
+            stats_.fullFrame = stats_.searched = true;
+            detectAt(0, cv::Rect(0, 0, gray_.cols, gray_.rows), 0, true, detections);
+            finishStats();
+            return detections;
+        }
+
+        buildPyramid();
+        if (config_.track)
+        {
+            verifyTracks(detections);
+        }
+
+        bool search = !config_.track || tracks_.empty() || stats_.lost > 0 || frames_ - lastSearch_ >= static_cast<uint64_t>(std::max(1, config_.searchEvery));
+        if (search)
+        {
+            lastSearch_ = frames_;
+            stats_.searched = true;
+            ++searches_;
+            if (config_.fullFrameEvery > 0 && searches_ % config_.fullFrameEvery == 0)
+            {
+                stats_.fullFrame = true;
+                detectAt(0, cv::Rect(0, 0, gray_.cols, gray_.rows), 0, true, detections);
+            }
+            else
+            {
+                searchPyramid(detections);
+            }
+        }
+
+        if (config_.track)
+        {
+            addTracks(detections);
+        }
+        finishStats();
+        return detections;
+    }
+
+    const QrDetectStats &lastStats() const { return stats_; }
+
+private:
+    struct Track
+    {
+        uint32_t id;
+        std::string text;
+        std::vector<cv::Point2f> corners;
+        cv::Point2f velocity; // 프레임당 중심 이동
+        float module;
+        int missed;
+    };
+
+    static cv::Point2f center(const std::vector<cv::Point2f> &corners)
+    {
+        cv::Point2f sum(0, 0);
+        for (const auto &p : corners)
+        {
+            sum.x += p.x / corners.size();
+            sum.y += p.y / corners.size();
+        }
+        return sum;
+    }
+
+    static float side(const std::vector<cv::Point2f> &corners)
+    {
+        float total = 0;
+        for (size_t k = 0; k < corners.size(); ++k)
+        {
+            const cv::Point2f &a = corners[k];
+            const cv::Point2f &b = corners[(k + 1) % corners.size()];
+            total += std::hypot(a.x - b.x, a.y - b.y);
+        }
+        return corners.empty() ? 0 : total / corners.size();
+    }
+
+    // 원본 영상(0)과 1/2 씩 줄인 레벨들. 레벨 크기가 그대로면 이전 프레임의 버퍼를 재사용
+    void buildPyramid()
+    {
+        int levels = std::max(1, std::min(config_.pyramidLevels, 6));
+        pyramid_.resize(levels);
+        pyramid_[0] = gray_;
+        levels_ = 1;
+        while (levels_ < levels && pyramid_[levels_ - 1].cols >= 128 && pyramid_[levels_ - 1].rows >= 128)
+        {
+            cv::pyrDown(pyramid_[levels_ - 1], pyramid_[levels_]);
+            ++levels_;
+        }
+
+        if (scanners_.size() != static_cast<size_t>(levels_))
+        {
+            // 위 레벨에서 모듈이 minModule 이상이면 거기서 찾으므로, 아래 레벨은 모듈 2 * minModule 근처까지만 봄
+            QrFinderConfig finer = config_.finder;
+            finer.maxModule = std::min(finer.maxModule, 2 * finer.minModule + 1);
+            scanners_.clear();
+            for (int level = 0; level < levels_; ++level)
+            {
+                scanners_.emplace_back(level == levels_ - 1 ? config_.finder : finer);
+            }
+        }
+    }
+
+    // 거친 레벨부터 파인더 탐색. 이미 처리한 영역(추적 재확인, 위 레벨 ROI)과 대부분 겹치는 ROI 는 건너뜀
+    void searchPyramid(std::vector<QrDetection> &detections)
+    {
+        std::vector<cv::Rect> covered;
+        for (const auto &detection : detections)
+        {
+            covered.push_back(boundingRect(detection.corners));
+        }
+
+        for (int level = levels_ - 1; level >= 0; --level)
+        {
+            const cv::Mat &img = pyramid_[level];
+            QrFinderScanner &scanner = scanners_[level];
+            stats_.candidates += scanner.scan(img.ptr<uint8_t>(0), img.cols, img.rows, img.step).size();
+            stats_.dropped += scanner.dropped();
+            for (const QrRoi &roi : scanner.regions())
+            {
+                int scale = 1 << level;
+                cv::Rect rect(roi.x * scale, roi.y * scale, roi.width * scale, roi.height * scale);
+                rect &= cv::Rect(0, 0, gray_.cols, gray_.rows);
+                if (mostlyCovered(rect, covered))
+                {
+                    continue;
+                }
+                covered.push_back(rect);
+                detectRefined(rect, roi.module * scale, detections);
+            }
+        }
+    }
+
+    static bool mostlyCovered(const cv::Rect &rect, const std::vector<cv::Rect> &covered)
+    {
+        for (const auto &other : covered)
+        {
+            if (2 * (rect & other).area() >= rect.area())
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    static cv::Rect boundingRect(const std::vector<cv::Point2f> &corners)
+    {
+        float minX = 1e9f, minY = 1e9f, maxX = -1e9f, maxY = -1e9f;
+        for (const auto &p : corners)
+        {
+            minX = std::min(minX, p.x);
+            minY = std::min(minY, p.y);
+            maxX = std::max(maxX, p.x);
+            maxY = std::max(maxY, p.y);
+        }
+        return cv::Rect(static_cast<int>(std::floor(minX)), static_cast<int>(std::floor(minY)),
+                        static_cast<int>(std::ceil(maxX - minX)) + 1, static_cast<int>(std::ceil(maxY - minY)) + 1);
+    }
+
+    // 모듈이 detectModule 이상 남는 가장 거친 레벨부터 검출, 디코딩에 실패하면 한 레벨씩 내려감
+    // rect 는 원본 좌표. 디코딩한 코드가 하나라도 있으면 true
+    bool detectRefined(const cv::Rect &rect, float module, std::vector<QrDetection> &detections)
+    {
+        int level = 0;
+        while (level + 1 < levels_ && module / (2 << level) >= config_.detectModule)
+        {
+            ++level;
+        }
+        for (; level >= 0; --level)
+        {
+            if (detectAt(level, rect, module, level == 0, detections))
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // level 영상의 rect(원본 좌표) 영역에서 검출. 디코딩한 코드는 항상, 디코딩 못 한 위치는 keepUndecoded 일 때만 추가
+    bool detectAt(int level, const cv::Rect &rect, float module, bool keepUndecoded, std::vector<QrDetection> &detections)
+    {
+        const cv::Mat &img = level == 0 ? gray_ : pyramid_[level];
+        int scale = 1 << level;
+        cv::Rect region(rect.x / scale, rect.y / scale, (rect.width + scale - 1) / scale, (rect.height + scale - 1) / scale);
+        region &= cv::Rect(0, 0, img.cols, img.rows);
+        if (region.width < 21 || region.height < 21)
+        {
+            return false;
+        }
+        ++stats_.rois;
+
+        cv::Mat view = img(region);
+        float up = 1;
+        if (level == 0 && module > 0 && module < config_.upscaleBelow)
+        {
+            cv::resize(view, upscaled_, cv::Size(), 2, 2, cv::INTER_CUBIC);
+            view = upscaled_;
+            up = 2;
+        }
+        detectorPixels_ += static_cast<double>(view.cols) * view.rows;
+
+        std::vector<std::string> texts;
+        std::vector<cv::Point2f> points;
+        if (!detector_.detectAndDecodeMulti(view, texts, points))
+        {
+            return false;
+        }
+
+        bool decoded = false;
+        for (size_t i = 0; i + 3 < points.size(); i += 4)
+        {
+            QrDetection detection;
+            detection.text = i / 4 < texts.size() ? texts[i / 4] : std::string();
+            if (detection.text.empty() && !keepUndecoded)
+            {
+                continue;
+            }
+            for (size_t k = 0; k < 4; ++k)
+            {
+                detection.corners.emplace_back((points[i + k].x / up + region.x) * scale, (points[i + k].y / up + region.y) * scale);
+            }
+            detection.module = module;
+            if (isDuplicate(detection, detections))
+            {
+                continue;
+            }
+            decoded = decoded || !detection.text.empty();
+            detections.push_back(std::move(detection));
+        }
+        return decoded;
+    }
+
+    // 같은 내용의 코드가 이미 같은 자리에서 검출됐는지 (재확인 ROI 와 탐색 ROI 가 겹친 경우)
+    static bool isDuplicate(const QrDetection &detection, const std::vector<QrDetection> &detections)
+    {
+        cv::Point2f c = center(detection.corners);
+        float radius = side(detection.corners);
+        for (const auto &other : detections)
+        {
+            cv::Point2f o = center(other.corners);
+            if (other.text == detection.text && std::hypot(c.x - o.x, c.y - o.y) < radius)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // 추적 중인 코드를 예측 위치(이전 위치 + 속도) 주변에서만 재확인
+    void verifyTracks(std::vector<QrDetection> &detections)
+    {
+        for (auto it = tracks_.begin(); it != tracks_.end();)
+        {
+            Track &track = *it;
+            std::vector<cv::Point2f> predicted = track.corners;
+            for (auto &p : predicted)
+            {
+                p.x += track.velocity.x;
+                p.y += track.velocity.y;
+            }
+            cv::Rect rect = boundingRect(predicted);
+            int margin = static_cast<int>(side(predicted) * 0.35f + std::hypot(track.velocity.x, track.velocity.y) + 4 * track.module);
+            rect = cv::Rect(rect.x - margin, rect.y - margin, rect.width + 2 * margin, rect.height + 2 * margin) &
+                   cv::Rect(0, 0, gray_.cols, gray_.rows);
+
+            size_t first = detections.size();
+            detectRefined(rect, track.module, detections);
+            QrDetection *match = nullptr;
+            for (size_t i = first; i < detections.size(); ++i)
+            {
+                if (detections[i].text == track.text)
+                {
+                    match = &detections[i];
+                    break;
+                }
+            }
+
+            if (match == nullptr)
+            {
+                if (++track.missed > config_.maxMissed)
+                {
+                    ++stats_.lost;
+                    it = tracks_.erase(it);
+                    continue;
+                }
+                ++it;
+                continue;
+            }
+
+            cv::Point2f before = center(track.corners);
+            cv::Point2f after = center(match->corners);
+            float oldSide = side(track.corners);
+            track.velocity.x = 0.5f * track.velocity.x + 0.5f * (after.x - before.x);
+            track.velocity.y = 0.5f * track.velocity.y + 0.5f * (after.y - before.y);
+            if (oldSide > 0)
+            {
+                track.module *= side(match->corners) / oldSide;
+            }
+            track.corners = match->corners;
+            track.missed = 0;
+            match->module = track.module;
+            match->track = track.id;
+            ++stats_.tracked;
+            ++it;
+        }
+    }
+
+    // 새로 디코딩한 코드를 추적 목록에 추가
+    void addTracks(std::vector<QrDetection> &detections)
+    {
+        for (auto &detection : detections)
+        {
+            if (detection.track != 0 || detection.text.empty() || tracks_.size() >= config_.maxTracks)
+            {
+                continue;
+            }
+            Track track;
+            track.id = nextTrack_++;
+            track.text = detection.text;
+            track.corners = detection.corners;
+            track.velocity = cv::Point2f(0, 0);
+            // 전체 프레임 검출처럼 모듈을 모르면 버전 2 (25 모듈) 로 가정
+            track.module = detection.module > 0 ? detection.module : side(detection.corners) / 25;
+            track.missed = 0;
+            detection.track = track.id;
+            tracks_.push_back(std::move(track));
+        }
+    }
+
+    void finishStats()
+    {
+        stats_.roiFraction = detectorPixels_ / (static_cast<double>(gray_.cols) * gray_.rows);
+    }
+
+    QrDetectConfig config_;
+    std::vector<QrFinderScanner> scanners_; // 피라미드 레벨별
+    cv::QRCodeDetector detector_;
+    cv::Mat gray_;
+    cv::Mat upscaled_;
+    std::vector<cv::Mat> pyramid_;
+    int levels_ = 1;
+    std::vector<Track> tracks_;
+    uint32_t nextTrack_ = 1;
+    uint64_t frames_ = 0;
+    uint64_t lastSearch_ = 0;
+    uint64_t searches_ = 0;
+    double detectorPixels_ = 0;
+    QrDetectStats stats_;
+};
+
+#endif // QR_DETECT_H
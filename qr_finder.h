@@ -0,0 +1,479 @@
+#ifndef QR_FINDER_H
+#define QR_FINDER_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+
+// QR 코드 파인더 패턴 빠른 사전 탐지 (OpenCV 불필요, 8비트 그레이 버퍼 입력)
+//
+// 1. rowStep 행마다 한 행만 지역 평균으로 이진화하고 어두움/밝음 run 길이를 셈
+// 2. 연속한 5 개 run 이 1:1:3:1:1 (어두움부터) 이면 후보 → 가운데 열에서 세로로 같은 비율인지 교차 확인
+// 3. 가까운 후보는 하나로 합치고, 모듈 크기가 비슷하고 서로 가까운 후보끼리 묶어 코드 영역(ROI) 추정
+//
+// 잡음이 많은 장면에서도 시간이 후보 수의 제곱으로 늘지 않도록, 합칠 후보는 격자 칸(QR_FINDER_CELL px)으로 찾고
+// 묶을 후보는 모듈 크기순으로 정렬해 크기 비율 안의 것만 비교함. 후보 수는 maxCandidates 로 제한 (넘으면 버리고 셈)
+//
+// 전체 프레임 대신 이 ROI 에서만 cv::QRCodeDetector 를 돌리기 위한 단계 (qr_detect.h)
+
+struct QrFinderConfig
+{
+    int rowStep = 2;            // 검사할 행 간격 (작은 코드를 놓치지 않으려면 최소 모듈 크기 이하)
+    int minModule = 2;          // 허용 모듈 크기 (px)
+    int maxModule = 64;
+    int thresholdRadius = 0;    // 지역 평균 반경 (0 이면 너비 / 8)
+    int minContrast = 24;       // 행 전체 최대-최소 밝기 차가 이보다 작으면 건너뜀
+    float maxModulesApart = 60; // 같은 코드로 묶을 파인더 중심 거리 한도 (모듈 수, 버전 13 정도)
+    float quietZone = 4;        // ROI 에 더할 여백 (모듈 수)
+    int minHits = 2;            // ROI 에 쓸 후보의 최소 검출 행 수 (잡음으로 생긴 한 줄짜리 후보 제외)
+    int maxCandidates = 256;    // 프레임당 최대 후보 수
+};
+
+#define QR_FINDER_CELL 32 // 후보 합치기용 격자 칸 크기 (px)
+
+struct QrFinderCandidate
+{
+    float x;
+    float y;
+    float module; // 추정 모듈 크기 (px)
+    int hits;     // 합쳐진 검출 수
+};
+
+struct QrRoi
+{
+    int x;
+    int y;
+    int width;
+    int height;
+    int finders;  // 이 영역을 만든 파인더 후보 수
+    float module; // 묶인 후보 중 가장 큰 모듈 크기 (px)
+};
+
+class QrFinderScanner
+{
+public:
+    explicit QrFinderScanner(const QrFinderConfig &config = QrFinderConfig()) : config_(config) {}
+
+    // 파인더 후보 탐색. data 는 step 바이트 간격의 8비트 그레이 행
+    const std::vector<QrFinderCandidate> &scan(const uint8_t *data, int width, int height, size_t step)
+    {
+        data_ = data;
+        width_ = width;
+        height_ = height;
+        step_ = step;
+        candidates_.clear();
+        dropped_ = 0;
+        for (uint32_t cell : usedCells_)
+            grid_[cell].clear();
+        usedCells_.clear();
+        gridWidth_ = width / QR_FINDER_CELL + 1;
+        grid_.resize(static_cast<size_t>(gridWidth_) * (height / QR_FINDER_CELL + 1));
+        int radius = config_.thresholdRadius > 0 ? config_.thresholdRadius : std::max(8, width / 8);
+        int rowStep = std::max(1, config_.rowStep);
+
+        prefix_.resize(width + 1);
+        dark_.resize(width);
+        for (int y = rowStep / 2; y < height; y += rowStep)
+        {
+            const uint8_t *row = data + y * step;
+            if (!binarizeRow(row, width, radius))
+            {
+                continue;
+            }
+            scanRow(y);
+        }
+        return candidates_;
+    }
+
+    // 후보를 코드 단위로 묶어 ROI 반환 (파인더가 2 개 이상인 묶음만)
+    std::vector<QrRoi> regions() const
+    {
+        std::vector<QrFinderCandidate> candidates;
+        for (const auto &candidate : candidates_)
+        {
+            if (candidate.hits >= config_.minHits)
+                candidates.push_back(candidate);
+        }
+        // 모듈 크기 비율이 1.6 이상이면 묶지 않으므로 크기순으로 정렬해 그 안의 후보만 비교
+        std::sort(candidates.begin(), candidates.end(), [](const QrFinderCandidate &a, const QrFinderCandidate &b)
+                  { return a.module < b.module; });
+        size_t n = candidates.size();
+        std::vector<size_t> parent(n);
+        for (size_t i = 0; i < n; ++i)
+            parent[i] = i;
+        auto find = [&](size_t i)
+        {
+            while (parent[i] != i)
+                i = parent[i] = parent[parent[i]];
+            return i;
+        };
+
+        for (size_t i = 0; i < n; ++i)
+        {
+            const QrFinderCandidate &a = candidates[i];
+            for (size_t j = i + 1; j < n && candidates[j].module < 1.6f * a.module; ++j)
+            {
+                const QrFinderCandidate &b = candidates[j];
+                float distance = std::hypot(a.x - b.x, a.y - b.y);
+                // 같은 코드의 파인더는 최소 14 모듈(버전 1) 떨어져 있음
+                if (distance <= config_.maxModulesApart * b.module && distance >= 10 * a.module)
+                {
+                    parent[find(i)] = find(j);
+                }
+            }
+        }
+
+        std::vector<std::vector<size_t>> groups(n);
+        for (size_t i = 0; i < n; ++i)
+            groups[find(i)].push_back(i);
+
+        std::vector<QrRoi> rois;
+        for (const auto &group : groups)
+        {
+            if (group.size() < 2)
+            {
+                continue;
+            }
+            float minX = 1e9f, minY = 1e9f, maxX = -1e9f, maxY = -1e9f, module = 0;
+            auto include = [&](float x, float y)
+            {
+                minX = std::min(minX, x);
+                minY = std::min(minY, y);
+                maxX = std::max(maxX, x);
+                maxY = std::max(maxY, y);
+            };
+            for (size_t i : group)
+            {
+                include(candidates[i].x, candidates[i].y);
+                module = std::max(module, candidates[i].module);
+            }
+
+            float margin = (3.5f + config_.quietZone) * module;
+            if (group.size() == 3)
+            {
+                // 직각 꼭짓점(가장 긴 변의 맞은편) A 에 대해 네 번째 꼭짓점 B + C - A 도 포함 (회전된 코드)
+                const QrFinderCandidate *p[3] = {&candidates[group[0]], &candidates[group[1]], &candidates[group[2]]};
+                int corner = 0;
+                float longest = -1;
+                for (int k = 0; k < 3; ++k)
+                {
+                    const QrFinderCandidate &b = *p[(k + 1) % 3];
+                    const QrFinderCandidate &c = *p[(k + 2) % 3];
+                    float d = std::hypot(b.x - c.x, b.y - c.y);
+                    if (d > longest)
+                    {
+                        longest = d;
+                        corner = k;
+                    }
+                }
+                const QrFinderCandidate &a = *p[corner];
+                const QrFinderCandidate &b = *p[(corner + 1) % 3];
+                const QrFinderCandidate &c = *p[(corner + 2) % 3];
+                include(b.x + c.x - a.x, b.y + c.y - a.y);
+            }
+            else if (group.size() == 2)
+            {
+                // 세 번째 파인더를 못 찾은 경우: 두 중심 거리만큼 사방으로 확장
+                margin += std::hypot(maxX - minX, maxY - minY);
+            }
+
+            int x0 = std::max(0, static_cast<int>(std::floor(minX - margin)));
+            int y0 = std::max(0, static_cast<int>(std::floor(minY - margin)));
+            int x1 = std::min(width_, static_cast<int>(std::ceil(maxX + margin)));
+            int y1 = std::min(height_, static_cast<int>(std::ceil(maxY + margin)));
+            if (x1 > x0 && y1 > y0)
+            {
+                rois.push_back({x0, y0, x1 - x0, y1 - y0, static_cast<int>(group.size()), module});
+            }
+        }
+        return mergeOverlapping(std::move(rois));
+    }
+
+    const std::vector<QrFinderCandidate> &candidates() const { return candidates_; }
+
+    // 마지막 scan 에서 maxCandidates 를 넘어 버린 후보 수
+    size_t dropped() const { return dropped_; }
+
+    // 겹치는 ROI 를 하나로 합침
+    static std::vector<QrRoi> mergeOverlapping(std::vector<QrRoi> rois)
+    {
+        bool merged = true;
+        while (merged)
+        {
+            merged = false;
+            for (size_t i = 0; i < rois.size() && !merged; ++i)
+            {
+                for (size_t j = i + 1; j < rois.size(); ++j)
+                {
+                    QrRoi &a = rois[i];
+                    const QrRoi &b = rois[j];
+                    if (a.x < b.x + b.width && b.x < a.x + a.width && a.y < b.y + b.height && b.y < a.y + a.height)
+                    {
+                        int x1 = std::max(a.x + a.width, b.x + b.width);
+                        int y1 = std::max(a.y + a.height, b.y + b.height);
+                        a.x = std::min(a.x, b.x);
+                        a.y = std::min(a.y, b.y);
+                        a.width = x1 - a.x;
+                        a.height = y1 - a.y;
+                        a.finders += b.finders;
+                        a.module = std::max(a.module, b.module);
+                        rois.erase(rois.begin() + j);
+                        merged = true;
+                        break;
+                    }
+                }
+            }
+        }
+        return rois;
+    }
+
+private:
+    // 지역 평균(반경 radius)보다 어두우면 1. 대비가 너무 낮은 행은 false
+    bool binarizeRow(const uint8_t *row, int width, int radius)
+    {
+        uint8_t lo = 255, hi = 0;
+        prefix_[0] = 0;
+        for (int x = 0; x < width; ++x)
+        {
+            lo = std::min(lo, row[x]);
+            hi = std::max(hi, row[x]);
+            prefix_[x + 1] = prefix_[x] + row[x];
+        }
+        if (hi - lo < config_.minContrast)
+        {
+            return false;
+        }
+        for (int x = 0; x < width; ++x)
+        {
+            int x0 = std::max(0, x - radius);
+            int x1 = std::min(width, x + radius + 1);
+            // row[x] < 평균 을 나눗셈 없이 비교
+            dark_[x] = static_cast<uint8_t>(static_cast<uint32_t>(row[x]) * (x1 - x0) < prefix_[x1] - prefix_[x0]);
+        }
+        return true;
+    }
+
+    void scanRow(int y)
+    {
+        int counts[5] = {0, 0, 0, 0, 0};
+        int state = 0; // counts 의 현재 위치. 짝수는 어두움, 홀수는 밝음
+        for (int x = 0; x < width_; ++x)
+        {
+            bool dark = dark_[x] != 0;
+            if (dark == (state % 2 == 0))
+            {
+                ++counts[state];
+                continue;
+            }
+            if (state == 0 && counts[0] == 0)
+            {
+                continue; // 첫 어두운 run 이 시작되기 전의 밝은 픽셀
+            }
+            if (state < 4)
+            {
+                ++state;
+                counts[state] = 1;
+                continue;
+            }
+
+            // 다섯 번째(어두움) run 이 끝남
+            if (ratioMatches(counts))
+            {
+                int total = counts[0] + counts[1] + counts[2] + counts[3] + counts[4];
+                float centerX = x - counts[4] - counts[3] - counts[2] / 2.0f;
+                threshold_ = localThreshold(y, static_cast<int>(centerX), total);
+                confirm(centerX, y, total);
+            }
+            // 마지막 두 run 을 앞으로 옮겨 다음 패턴 후보로 계속
+            counts[0] = counts[2];
+            counts[1] = counts[3];
+            counts[2] = counts[4];
+            counts[3] = 1;
+            counts[4] = 0;
+            state = 3;
+        }
+    }
+
+    bool ratioMatches(const int counts[5]) const
+    {
+        int total = 0;
+        for (int i = 0; i < 5; ++i)
+        {
+            if (counts[i] == 0)
+                return false;
+            total += counts[i];
+        }
+        if (total < 7 * config_.minModule || total > 7 * config_.maxModule)
+        {
+            return false;
+        }
+        float module = total / 7.0f;
+        float variance = module / 2.0f;
+        return std::fabs(module - counts[0]) < variance && std::fabs(module - counts[1]) < variance &&
+               std::fabs(3 * module - counts[2]) < 3 * variance && std::fabs(module - counts[3]) < variance &&
+               std::fabs(module - counts[4]) < variance;
+    }
+
+    // 세로 교차 확인용 임계값: 가로 패턴 구간의 평균
+    int localThreshold(int y, int centerX, int total) const
+    {
+        const uint8_t *row = data_ + y * step_;
+        int x0 = std::max(0, centerX - total / 2);
+        int x1 = std::min(width_, centerX + total / 2 + 1);
+        uint32_t sum = 0;
+        for (int x = x0; x < x1; ++x)
+            sum += row[x];
+        return x1 > x0 ? static_cast<int>(sum / (x1 - x0)) : 128;
+    }
+
+    bool isDark(int x, int y) const
+    {
+        return data_[y * step_ + x] < threshold_;
+    }
+
+    // (centerX, y) 를 지나는 세로선에서 1:1:3:1:1 을 확인하고 세로 중심을 구함. 실패하면 음수
+    float crossCheckVertical(int centerX, int y, int maxCount, int totalHorizontal) const
+    {
+        int counts[5] = {0, 0, 0, 0, 0};
+        int i = y;
+        while (i >= 0 && isDark(centerX, i))
+        {
+            ++counts[2];
+            --i;
+        }
+        if (i < 0)
+            return -1;
+        while (i >= 0 && !isDark(centerX, i) && counts[1] <= maxCount)
+        {
+            ++counts[1];
+            --i;
+        }
+        if (i < 0 || counts[1] > maxCount)
+            return -1;
+        while (i >= 0 && isDark(centerX, i) && counts[0] <= maxCount)
+        {
+            ++counts[0];
+            --i;
+        }
+        if (counts[0] > maxCount)
+            return -1;
+
+        i = y + 1;
+        while (i < height_ && isDark(centerX, i))
+        {
+            ++counts[2];
+            ++i;
+        }
+        if (i == height_)
+            return -1;
+        while (i < height_ && !isDark(centerX, i) && counts[3] < maxCount)
+        {
+            ++counts[3];
+            ++i;
+        }
+        if (i == height_ || counts[3] >= maxCount)
+            return -1;
+        while (i < height_ && isDark(centerX, i) && counts[4] < maxCount)
+        {
+            ++counts[4];
+            ++i;
+        }
+        if (counts[4] >= maxCount)
+            return -1;
+
+        int total = counts[0] + counts[1] + counts[2] + counts[3] + counts[4];
+        // 가로/세로 크기가 크게 다르면 (긴 막대 등) 거부
+        if (5 * std::abs(total - totalHorizontal) >= 2 * totalHorizontal || !ratioMatches(counts))
+        {
+            return -1;
+        }
+        return i - counts[4] - counts[3] - counts[2] / 2.0f;
+    }
+
+    void confirm(float centerX, int y, int total)
+    {
+        int cx = static_cast<int>(centerX);
+        if (cx < 0 || cx >= width_)
+        {
+            return;
+        }
+        float centerY = crossCheckVertical(cx, y, total, total);
+        if (centerY < 0)
+        {
+            return;
+        }
+        float module = total / 7.0f;
+
+        // 이미 찾은 후보와 같으면 합침 (중심에서 2 모듈 안에 걸치는 격자 칸만 확인)
+        int cx0 = cellX(centerX - 2 * module), cx1 = cellX(centerX + 2 * module);
+        int cy0 = cellY(centerY - 2 * module), cy1 = cellY(centerY + 2 * module);
+        for (int gy = cy0; gy <= cy1; ++gy)
+        {
+            for (int gx = cx0; gx <= cx1; ++gx)
+            {
+                uint32_t cell = static_cast<uint32_t>(gy * gridWidth_ + gx);
+                for (uint32_t index : grid_[cell])
+                {
+                    QrFinderCandidate &candidate = candidates_[index];
+                    if (std::fabs(candidate.x - centerX) <= 2 * module && std::fabs(candidate.y - centerY) <= 2 * module &&
+                        std::fabs(candidate.module - module) <= std::max(1.0f, candidate.module / 2))
+                    {
+                        float w = static_cast<float>(candidate.hits);
+                        candidate.x = (candidate.x * w + centerX) / (w + 1);
+                        candidate.y = (candidate.y * w + centerY) / (w + 1);
+                        candidate.module = (candidate.module * w + module) / (w + 1);
+                        ++candidate.hits;
+                        uint32_t moved = cellOf(candidate.x, candidate.y);
+                        if (moved != cell)
+                        {
+                            auto &from = grid_[cell];
+                            from.erase(std::find(from.begin(), from.end(), index));
+                            addToCell(moved, index);
+                        }
+                        return;
+                    }
+                }
+            }
+        }
+        if (candidates_.size() >= static_cast<size_t>(std::max(1, config_.maxCandidates)))
+        {
+            ++dropped_;
+            return;
+        }
+        candidates_.push_back({centerX, centerY, module, 1});
+        addToCell(cellOf(centerX, centerY), static_cast<uint32_t>(candidates_.size() - 1));
+    }
+
+    int cellX(float x) const { return std::min(std::max(static_cast<int>(x) / QR_FINDER_CELL, 0), gridWidth_ - 1); }
+    int cellY(float y) const
+    {
+        return std::min(std::max(static_cast<int>(y) / QR_FINDER_CELL, 0), static_cast<int>(grid_.size() / gridWidth_) - 1);
+    }
+    uint32_t cellOf(float x, float y) const { return static_cast<uint32_t>(cellY(y) * gridWidth_ + cellX(x)); }
+
+    void addToCell(uint32_t cell, uint32_t index)
+    {
+        if (grid_[cell].empty())
+            usedCells_.push_back(cell);
+        grid_[cell].push_back(index);
+    }
+
+    QrFinderConfig config_;
+    const uint8_t *data_ = nullptr;
+    int width_ = 0;
+    int height_ = 0;
+    size_t step_ = 0;
+    int threshold_ = 128;
+    std::vector<uint32_t> prefix_;
+    std::vector<uint8_t> dark_;
+    std::vector<QrFinderCandidate> candidates_;
+    size_t dropped_ = 0;
+    int gridWidth_ = 1;
+    std::vector<std::vector<uint32_t>> grid_; // 칸마다 candidates_ 색인
+    std::vector<uint32_t> usedCells_;         // 다음 scan 때 비울 칸
+};
+
+#endif // QR_FINDER_H
@@ -0,0 +1,265 @@
+#ifndef SCAN_AGGREGATOR_H
+#define SCAN_AGGREGATOR_H
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <tuple>
+#include <vector>
+#include "scan_batch.h"
+
+// BLE 스캔 항목 중복 제거 / 시간 창 집계
+//
+// 같은 (hubId, serverId, uuid) 가 반복해서 보이는 BLE 스캔 결과를 시간 창(window) 단위로 모아
+// 키마다 횟수, 처음/마지막 관측 시각, 신호 세기(최소/최대/평균)만 남긴 요약으로 내보냄.
+//
+// - 고정 크기 open addressing 해시 테이블 (선형 탐사). 생성 후 추가 할당 없음
+// - 키 수가 maxKeys 를 넘거나 탐사 길이가 MAX_PROBE 를 넘으면 새 키는 버리고 overflow 로만 셈
+//   (임의의 ID 를 쏟아내는 입력에도 메모리는 늘지 않음). 해시는 프로세스마다 다른 seed 를 섞음
+// - 창을 닫을 때는 사용한 슬롯 목록만 순회/초기화하므로 비용은 창 안의 고유 키 수에 비례
+//
+// 스레드 안전하지 않음 (스캔 스레드 하나가 소유하거나 호출 측에서 잠금)
+
+// 키 하나의 창 요약
+struct ScanSummary
+{
+    ScanId hubId;
+    ScanId serverId;
+    int32_t uuid;
+    uint32_t count;       // 창 안의 관측 횟수
+    uint64_t firstSeenNs; // 처음 / 마지막 관측 시각 (steady clock)
+    uint64_t lastSeenNs;
+    int8_t rssiMin;       // 신호 세기를 모르면 SCAN_RSSI_UNKNOWN
+    int8_t rssiMax;
+    float rssiMean;
+};
+
+// ScanWindow::toScanResults 의 endWallUs 로 쓸 현재 벽시계 (UNIX epoch us)
+static inline uint64_t scanWallClockUs()
+{
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+                                     std::chrono::system_clock::now().time_since_epoch())
+                                     .count());
+}
+
+// 닫힌 창 하나의 결과
+struct ScanWindow
+{
+    uint64_t startNs = 0;
+    uint64_t endNs = 0;
+    uint64_t sightings = 0; // 입력된 전체 관측 수
+    uint64_t overflow = 0;  // 테이블이 가득 차서 집계하지 못한 관측 수
+    std::vector<ScanSummary> summaries; // (hubId, serverId, uuid) 순으로 정렬
+
+    // 기존 구조체로 변환 (허브별로 묶고 키마다 항목 하나, 요약은 Entry::stats 로)
+    // endWallUs 는 endNs 시점의 벽시계 (UNIX epoch us). 관측 시각(steady clock)을 이 기준으로 환산
+    std::vector<ScanResult> toScanResults(const ScanIdTable &ids, uint64_t endWallUs) const
+    {
+        auto wallUs = [&](uint64_t ns)
+        {
+            uint64_t agoUs = (endNs - std::min(endNs, ns)) / 1000;
+            return endWallUs - std::min(endWallUs, agoUs);
+        };
+        std::vector<ScanResult> results;
+        for (const auto &summary : summaries)
+        {
+            if (results.empty() || results.back().hubId != ids.name(summary.hubId))
+            {
+                results.push_back({ids.name(summary.hubId), {}});
+            }
+            ScanStats stats;
+            stats.count = summary.count;
+            stats.firstSeenUs = wallUs(summary.firstSeenNs);
+            stats.lastSeenUs = wallUs(summary.lastSeenNs);
+            stats.rssiMin = summary.rssiMin;
+            stats.rssiMax = summary.rssiMax;
+            stats.rssiMean = summary.rssiMin == SCAN_RSSI_UNKNOWN ? SCAN_RSSI_UNKNOWN
+                                                                 : static_cast<int8_t>(std::lround(summary.rssiMean));
+            results.back().logList.push_back({ids.name(summary.serverId), summary.uuid, stats});
+        }
+        return results;
+    }
+};
+
+class ScanAggregator
+{
+public:
+    static constexpr size_t MAX_PROBE = 32;
+
+    explicit ScanAggregator(uint64_t windowNs = 5000000000ULL, size_t maxKeys = 4096)
+        : windowNs_(windowNs), maxKeys_(std::max<size_t>(maxKeys, 1))
+    {
+        // 부하율 50% 이하가 되도록 2의 거듭제곱 크기
+        size_t capacity = 16;
+        while (capacity < maxKeys_ * 2)
+        {
+            capacity <<= 1;
+        }
+        mask_ = capacity - 1;
+        slots_.reset(new Slot[capacity]());
+        used_.reserve(maxKeys_);
+        seed_ = (static_cast<uint64_t>(std::random_device{}()) << 32) ^ std::random_device{}();
+    }
+
+    ScanAggregator(const ScanAggregator &) = delete;
+    ScanAggregator &operator=(const ScanAggregator &) = delete;
+
+    // 관측 하나 추가. 집계되면 true, 테이블이 가득 차 버려지면 false
+    bool add(ScanId hubId, ScanId serverId, int32_t uuid, int8_t rssi, uint64_t nowNs)
+    {
+        if (windowStartNs_ == 0)
+        {
+            windowStartNs_ = nowNs;
+        }
+        ++sightings_;
+
+        size_t index = hash(hubId, serverId, uuid) & mask_;
+        for (size_t probe = 0; probe < MAX_PROBE; ++probe, index = (index + 1) & mask_)
+        {
+            Slot &slot = slots_[index];
+            if (slot.count == 0)
+            {
+                if (used_.size() >= maxKeys_)
+                {
+                    break;
+                }
+                slot = {hubId, serverId, uuid, 1, nowNs, nowNs, 0, 0, rssi, rssi};
+                addRssi(slot, rssi, true);
+                used_.push_back(static_cast<uint32_t>(index));
+                return true;
+            }
+            if (slot.hubId == hubId && slot.serverId == serverId && slot.uuid == uuid)
+            {
+                ++slot.count;
+                slot.lastSeenNs = std::max(slot.lastSeenNs, nowNs);
+                addRssi(slot, rssi, false);
+                return true;
+            }
+        }
+        ++overflow_;
+        return false;
+    }
+
+    // 스캔 배치 전체 추가 (같은 시각으로 기록)
+    void add(const ScanBatch &batch, uint64_t nowNs)
+    {
+        const ScanHubRange *hubs = batch.hubs();
+        const ScanId *serverIds = batch.serverIds();
+        const int32_t *uuids = batch.uuids();
+        const int8_t *rssis = batch.rssis();
+        for (size_t h = 0; h < batch.hubCount(); ++h)
+        {
+            for (uint32_t i = hubs[h].begin; i < hubs[h].begin + hubs[h].count; ++i)
+            {
+                add(hubs[h].hubId, serverIds[i], uuids[i], rssis[i], nowNs);
+            }
+        }
+    }
+
+    // 현재 창이 시작된 뒤 windowNs 가 지났는지
+    bool windowElapsed(uint64_t nowNs) const
+    {
+        return windowStartNs_ != 0 && nowNs - windowStartNs_ >= windowNs_;
+    }
+
+    // 현재 창의 요약을 window 에 채움 (창은 유지)
+    void collect(ScanWindow &window, uint64_t nowNs) const
+    {
+        window.startNs = windowStartNs_;
+        window.endNs = nowNs;
+        window.sightings = sightings_;
+        window.overflow = overflow_;
+        window.summaries.clear();
+        window.summaries.reserve(used_.size());
+        for (uint32_t index : used_)
+        {
+            const Slot &slot = slots_[index];
+            bool hasRssi = slot.rssiCount > 0;
+            window.summaries.push_back({slot.hubId, slot.serverId, slot.uuid, slot.count, slot.firstSeenNs, slot.lastSeenNs,
+                                        hasRssi ? slot.rssiMin : SCAN_RSSI_UNKNOWN, hasRssi ? slot.rssiMax : SCAN_RSSI_UNKNOWN,
+                                        hasRssi ? static_cast<float>(slot.rssiSum) / slot.rssiCount : 0.0f});
+        }
+        std::sort(window.summaries.begin(), window.summaries.end(), [](const ScanSummary &a, const ScanSummary &b)
+                  { return std::tie(a.hubId, a.serverId, a.uuid) < std::tie(b.hubId, b.serverId, b.uuid); });
+    }
+
+    // 현재 창을 닫고 요약을 window 에 채운 뒤 새 창 시작
+    void closeWindow(ScanWindow &window, uint64_t nowNs)
+    {
+        collect(window, nowNs);
+        for (uint32_t index : used_)
+        {
+            slots_[index].count = 0;
+        }
+        used_.clear();
+        sightings_ = 0;
+        overflow_ = 0;
+        windowStartNs_ = 0;
+    }
+
+    size_t uniqueKeys() const { return used_.size(); }
+    uint64_t sightings() const { return sightings_; }
+    uint64_t overflow() const { return overflow_; }
+
+private:
+    struct Slot
+    {
+        ScanId hubId;
+        ScanId serverId;
+        int32_t uuid;
+        uint32_t count; // 0 이면 빈 슬롯
+        uint64_t firstSeenNs;
+        uint64_t lastSeenNs;
+        int32_t rssiSum;
+        uint32_t rssiCount;
+        int8_t rssiMin;
+        int8_t rssiMax;
+    };
+
+    static void addRssi(Slot &slot, int8_t rssi, bool first)
+    {
+        if (rssi == SCAN_RSSI_UNKNOWN)
+        {
+            return;
+        }
+        if (first || slot.rssiCount == 0)
+        {
+            slot.rssiMin = slot.rssiMax = rssi;
+        }
+        else
+        {
+            slot.rssiMin = std::min(slot.rssiMin, rssi);
+            slot.rssiMax = std::max(slot.rssiMax, rssi);
+        }
+        slot.rssiSum += rssi;
+        ++slot.rssiCount;
+    }
+
+    // 64비트 혼합 (murmur3 fmix64) + 프로세스별 seed
+    size_t hash(ScanId hubId, ScanId serverId, int32_t uuid) const
+    {
+        uint64_t h = seed_ ^ (static_cast<uint64_t>(hubId) << 32 | serverId);
+        h ^= static_cast<uint64_t>(static_cast<uint32_t>(uuid)) * 0x9E3779B97F4A7C15ULL;
+        h ^= h >> 33;
+        h *= 0xFF51AFD7ED558CCDULL;
+        h ^= h >> 33;
+        h *= 0xC4CEB9FE1A85EC53ULL;
+        h ^= h >> 33;
+        return static_cast<size_t>(h);
+    }
+
+    uint64_t windowNs_;
+    size_t maxKeys_;
+    size_t mask_;
+    uint64_t seed_;
+    std::unique_ptr<Slot[]> slots_;
+    std::vector<uint32_t> used_; // 이번 창에 사용한 슬롯 번호
+    uint64_t windowStartNs_ = 0;
+    uint64_t sightings_ = 0;
+    uint64_t overflow_ = 0;
+};
+
+#endif // SCAN_AGGREGATOR_H
@@ -0,0 +1,314 @@
+#ifndef SCAN_BATCH_H
+#define SCAN_BATCH_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include "scan_result.h"
+
+// 스캔 결과의 압축 표현 (Edge / MAC Server 공용)
+//
+// - ScanIdTable : hubId / serverId 문자열을 32비트 ID 로 바꾸는 인터닝 테이블. 같은 문자열은 한 번만 저장.
+//                 기기가 계속 바뀌면 테이블이 가득 차므로 소유자가 주기적으로 clear (세대 번호 증가, 이전 ID 무효)
+// - ScanArena   : 스캔 주기마다 reset 하는 bump 할당기. reset 때 블록들을 전체 크기의 블록 하나로 합쳐 재사용
+// - ScanBatch   : 허브 구간 배열 + 항목별 (serverId, uuid, rssi) 배열 (struct-of-arrays). 메모리는 전부 ScanArena 에서 할당
+//
+// 한 스캔 주기 안에서 항목을 추가할 때 힙 할당이 없고(아레나가 커질 때 제외), 같은 ID 문자열을 반복 복사하지 않음.
+// 기존 ScanResult / Entry 와는 fromScanResults / toScanResults 로 변환.
+
+using ScanId = uint32_t;
+
+// 테이블이 가득 찼을 때 반환되는 ID (악의적/비정상 입력으로 테이블이 무한히 커지지 않도록)
+static constexpr ScanId SCAN_ID_OVERFLOW = 0xFFFFFFFFu;
+
+class ScanIdTable
+{
+public:
+    explicit ScanIdTable(size_t maxIds = 1u << 16) : maxIds_(maxIds) {}
+
+    ScanIdTable(const ScanIdTable &) = delete;
+    ScanIdTable &operator=(const ScanIdTable &) = delete;
+
+    // 문자열의 ID (처음 보는 문자열이면 새로 등록). 테이블이 가득 차면 SCAN_ID_OVERFLOW
+    ScanId intern(std::string_view value)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = ids_.find(value);
+        if (it != ids_.end())
+        {
+            return it->second;
+        }
+        if (names_.size() >= maxIds_)
+        {
+            return SCAN_ID_OVERFLOW;
+        }
+        // deque 원소는 주소가 바뀌지 않으므로 키(string_view)가 가리키는 문자열이 유지됨
+        names_.emplace_back(value);
+        ScanId id = static_cast<ScanId>(names_.size() - 1);
+        ids_.emplace(names_.back(), id);
+        return id;
+    }
+
+    // 등록된 ID 만 조회 (없으면 SCAN_ID_OVERFLOW)
+    ScanId find(std::string_view value) const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = ids_.find(value);
+        return it != ids_.end() ? it->second : SCAN_ID_OVERFLOW;
+    }
+
+    // ID 의 문자열. 반환된 참조는 다음 clear 전까지 유효
+    const std::string &name(ScanId id) const
+    {
+        static const std::string overflow = "?";
+        std::lock_guard<std::mutex> lock(mutex_);
+        return id < names_.size() ? names_[id] : overflow;
+    }
+
+    size_t size() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return names_.size();
+    }
+
+    size_t capacity() const { return maxIds_; }
+
+    // 모든 ID 를 지우고 세대 번호를 올림. 이전 세대의 ID 를 들고 있는 쪽은 문자열로 다시 intern 해야 함
+    void clear()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ids_.clear();
+        names_.clear();
+        generation_.fetch_add(1, std::memory_order_release);
+    }
+
+    uint64_t generation() const { return generation_.load(std::memory_order_acquire); }
+
+private:
+    size_t maxIds_;
+    std::atomic<uint64_t> generation_{0};
+    mutable std::mutex mutex_;
+    std::deque<std::string> names_;
+    std::unordered_map<std::string_view, ScanId> ids_;
+};
+
+class ScanArena
+{
+public:
+    explicit ScanArena(size_t blockSize = 64 * 1024) : blockSize_(std::max<size_t>(blockSize, 1024)) {}
+
+    ScanArena(const ScanArena &) = delete;
+    ScanArena &operator=(const ScanArena &) = delete;
+
+    void *allocate(size_t bytes, size_t align = alignof(std::max_align_t))
+    {
+        if (!blocks_.empty())
+        {
+            size_t offset = (used_ + align - 1) & ~(align - 1);
+            if (offset + bytes <= blocks_.back().size)
+            {
+                used_ = offset + bytes;
+                return blocks_.back().data.get() + offset;
+            }
+        }
+        // 새 블록 (큰 요청은 그 크기만큼)
+        size_t size = std::max(blockSize_, bytes + align);
+        blocks_.push_back({std::unique_ptr<char[]>(new char[size]), size});
+        capacity_ += size;
+        uintptr_t base = reinterpret_cast<uintptr_t>(blocks_.back().data.get());
+        size_t offset = ((base + align - 1) & ~(align - 1)) - base;
+        used_ = offset + bytes;
+        return blocks_.back().data.get() + offset;
+    }
+
+    template <class T>
+    T *allocateArray(size_t count)
+    {
+        return static_cast<T *>(allocate(sizeof(T) * count, alignof(T)));
+    }
+
+    // 이번 주기에 할당한 메모리를 모두 해제. 블록이 여러 개였으면 전체 크기의 블록 하나로 합쳐
+    // 다음 주기부터는 같은 양을 새 할당 없이 처리함
+    void reset()
+    {
+        if (blocks_.size() > 1)
+        {
+            size_t total = capacity_;
+            blocks_.clear();
+            blocks_.push_back({std::unique_ptr<char[]>(new char[total]), total});
+            capacity_ = total;
+        }
+        used_ = 0;
+    }
+
+    size_t capacity() const { return capacity_; }
+
+private:
+    struct Block
+    {
+        std::unique_ptr<char[]> data;
+        size_t size;
+    };
+
+    size_t blockSize_;
+    std::vector<Block> blocks_;
+    size_t used_ = 0;
+    size_t capacity_ = 0;
+};
+
+// 허브 하나의 항목 구간 [begin, begin + count)
+struct ScanHubRange
+{
+    ScanId hubId;
+    uint32_t begin;
+    uint32_t count;
+};
+
+class ScanBatch
+{
+public:
+    explicit ScanBatch(ScanIdTable &ids, size_t arenaBlockSize = 64 * 1024)
+        : ids_(ids), arena_(arenaBlockSize), generation_(ids.generation()) {}
+
+    ScanBatch(const ScanBatch &) = delete;
+    ScanBatch &operator=(const ScanBatch &) = delete;
+
+    // 새 스캔 주기 시작. 이전 주기의 배열은 모두 무효화됨
+    void reset()
+    {
+        generation_ = ids_.generation();
+        arena_.reset();
+        hubs_ = nullptr;
+        serverIds_ = nullptr;
+        uuids_ = nullptr;
+        rssis_ = nullptr;
+        hubCount_ = hubCapacity_ = 0;
+        entryCount_ = entryCapacity_ = 0;
+    }
+
+    // 허브 시작. 이후 addEntry 는 이 허브에 속함
+    void beginHub(ScanId hubId)
+    {
+        if (hubCount_ == hubCapacity_)
+        {
+            grow(hubs_, hubCount_, hubCapacity_);
+        }
+        hubs_[hubCount_++] = {hubId, static_cast<uint32_t>(entryCount_), 0};
+    }
+
+    void beginHub(std::string_view hubId) { beginHub(ids_.intern(hubId)); }
+
+    void addEntry(ScanId serverId, int32_t uuid, int8_t rssi = SCAN_RSSI_UNKNOWN)
+    {
+        if (hubCount_ == 0)
+        {
+            beginHub(SCAN_ID_OVERFLOW);
+        }
+        if (entryCount_ == entryCapacity_)
+        {
+            size_t capacity = entryCapacity_;
+            grow(serverIds_, entryCount_, capacity);
+            capacity = entryCapacity_;
+            grow(uuids_, entryCount_, capacity);
+            grow(rssis_, entryCount_, entryCapacity_);
+        }
+        serverIds_[entryCount_] = serverId;
+        uuids_[entryCount_] = uuid;
+        rssis_[entryCount_] = rssi;
+        ++entryCount_;
+        ++hubs_[hubCount_ - 1].count;
+    }
+
+    void addEntry(std::string_view serverId, int32_t uuid, int8_t rssi = SCAN_RSSI_UNKNOWN)
+    {
+        addEntry(ids_.intern(serverId), uuid, rssi);
+    }
+
+    // 기존 구조체에서 채움 (reset 후 추가)
+    void fromScanResults(const std::vector<ScanResult> &results)
+    {
+        reset();
+        for (const auto &result : results)
+        {
+            beginHub(result.hubId);
+            for (const auto &entry : result.logList)
+            {
+                addEntry(entry.serverId, entry.uuid);
+            }
+        }
+    }
+
+    // 기존 구조체로 변환 (로그 / 레거시 전송 경로 호환)
+    std::vector<ScanResult> toScanResults() const
+    {
+        std::vector<ScanResult> results;
+        results.reserve(hubCount_);
+        for (size_t h = 0; h < hubCount_; ++h)
+        {
+            const ScanHubRange &hub = hubs_[h];
+            ScanResult result;
+            result.hubId = ids_.name(hub.hubId);
+            result.logList.reserve(hub.count);
+            for (uint32_t i = hub.begin; i < hub.begin + hub.count; ++i)
+            {
+                ScanStats stats;
+                stats.rssiMin = stats.rssiMax = stats.rssiMean = rssis_[i];
+                result.logList.push_back({ids_.name(serverIds_[i]), uuids_[i], stats});
+            }
+            results.push_back(std::move(result));
+        }
+        return results;
+    }
+
+    size_t hubCount() const { return hubCount_; }
+    size_t entryCount() const { return entryCount_; }
+    bool empty() const { return hubCount_ == 0; }
+
+    // reset 이후 ID 테이블이 clear 됨 (담긴 ID 가 다른 문자열을 가리킬 수 있으므로 쓰지 말 것)
+    bool stale() const { return generation_ != ids_.generation(); }
+
+    const ScanHubRange *hubs() const { return hubs_; }
+    const ScanId *serverIds() const { return serverIds_; }
+    const int32_t *uuids() const { return uuids_; }
+    const int8_t *rssis() const { return rssis_; }
+
+    ScanIdTable &ids() const { return ids_; }
+
+private:
+    // 아레나에서 두 배 크기 배열을 새로 받아 복사 (이전 배열은 reset 때 함께 해제)
+    template <class T>
+    void grow(T *&array, size_t count, size_t &capacity)
+    {
+        size_t newCapacity = capacity ? capacity * 2 : 16;
+        T *grown = arena_.allocateArray<T>(newCapacity);
+        if (count)
+        {
+            std::memcpy(grown, array, count * sizeof(T));
+        }
+        array = grown;
+        capacity = newCapacity;
+    }
+
+    ScanIdTable &ids_;
+    ScanArena arena_;
+    uint64_t generation_; // reset 시점의 ID 테이블 세대
+    ScanHubRange *hubs_ = nullptr;
+    ScanId *serverIds_ = nullptr;
+    int32_t *uuids_ = nullptr;
+    int8_t *rssis_ = nullptr;
+    size_t hubCount_ = 0;
+    size_t hubCapacity_ = 0;
+    size_t entryCount_ = 0;
+    size_t entryCapacity_ = 0;
+};
+
+#endif // SCAN_BATCH_H
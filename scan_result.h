@@ -1,14 +1,30 @@
 #ifndef SCAN_RESULT_H
 #define SCAN_RESULT_H
 
+#include <cstdint>
 #include <string>
 #include <vector>
 
+// 신호 세기(dBm)를 모르는 항목 (기존 ScanResult 에서 변환한 경우)
+static constexpr int8_t SCAN_RSSI_UNKNOWN = INT8_MIN;
+
+// 시간 창 요약 (ScanAggregator). 원시 관측 하나를 그대로 담으면 count 1 이고 나머지는 모름
+struct ScanStats
+{
+    uint32_t count = 1;       // 창 안의 관측 횟수
+    uint64_t firstSeenUs = 0; // 처음 / 마지막 관측 시각 (UNIX epoch us, 0 이면 모름)
+    uint64_t lastSeenUs = 0;
+    int8_t rssiMin = SCAN_RSSI_UNKNOWN;
+    int8_t rssiMax = SCAN_RSSI_UNKNOWN;
+    int8_t rssiMean = SCAN_RSSI_UNKNOWN;
+};
+
 // 로그 항목 정의
 struct Entry
 {
     std::string serverId;
     int uuid;
+    ScanStats stats;
 };
 
 // 스캔 결과 정의
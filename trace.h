@@ -0,0 +1,271 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+// 프레임 단계별 트레이스 (Edge / MAC Server 공용)
+//
+// TRACE_SCOPE("canny") 처럼 구간을 표시하면 시작 / 길이(ns)를 스레드별 링 버퍼에 기록하고, TraceFileDumper 가
+// Chrome trace-event JSON (chrome://tracing, Perfetto 에서 열림) 으로 주기적으로 덮어씀.
+// TRACE_FRAME(seq) 로 현재 스레드의 프레임 시퀀스 번호(FrameHeader::seq)를 정해 두면 그 안의 구간에 args.seq 로 붙으므로
+// Edge 와 서버 트레이스를 trace_merge 로 합쳐 같은 프레임을 한 타임라인에서 볼 수 있음.
+//
+// FRAME_TRACE=1 로 빌드했을 때만 들어감 (CMake 옵션 FRAME_TRACE, image_ops.cmake). 0 이면 매크로가 모두 (void)0 이고
+// 인자도 평가하지 않음. 켜고 빌드해도 FrameTracer::start 전에는 구간마다 atomic load 하나로 끝남.
+
+#ifndef FRAME_TRACE
+#define FRAME_TRACE 0
+#endif
+
+#if FRAME_TRACE
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "metrics.h"
+
+struct TraceEvent
+{
+    const char *name; // 문자열 리터럴만 (포인터만 저장)
+    uint64_t startNs; // metricsNowNs 기준
+    uint64_t durationNs;
+    int64_t seq; // 프레임 시퀀스 번호, 없으면 -1
+};
+
+class FrameTracer
+{
+public:
+    static FrameTracer &instance()
+    {
+        static FrameTracer *tracer = new FrameTracer(); // 종료 중인 스레드도 기록할 수 있도록 해제하지 않음
+        return *tracer;
+    }
+
+    // 기록 시작. process 는 트레이스의 프로세스 이름 ("edge" / "server"), capacity 는 스레드별 최근 이벤트 수
+    void start(const std::string &process, size_t capacity = 1 << 16)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            process_ = process;
+            capacity_ = std::max<size_t>(capacity, 1);
+            originNs_ = metricsNowNs();
+            epochNs_ = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                                 std::chrono::system_clock::now().time_since_epoch())
+                                                 .count());
+        }
+        enabled_.store(true, std::memory_order_release);
+    }
+
+    bool enabled() const { return enabled_.load(std::memory_order_acquire); }
+
+    // 현재 스레드의 프레임 시퀀스 번호 (TRACE_FRAME 이 설정 / 복원)
+    static int64_t &currentFrame()
+    {
+        thread_local int64_t seq = -1;
+        return seq;
+    }
+
+    void record(const char *name, uint64_t startNs, uint64_t endNs)
+    {
+        if (!enabled())
+        {
+            return;
+        }
+        Buffer &buffer = threadBuffer();
+        std::lock_guard<std::mutex> lock(buffer.mutex); // 덤프할 때만 경합
+        TraceEvent event{name, startNs, endNs > startNs ? endNs - startNs : 0, currentFrame()};
+        if (buffer.events.size() < capacity_)
+        {
+            buffer.events.push_back(event);
+        }
+        else
+        {
+            buffer.events[buffer.next] = event; // 가득 차면 가장 오래된 이벤트부터 덮어씀
+            buffer.next = (buffer.next + 1) % buffer.events.size();
+            ++buffer.dropped;
+        }
+    }
+
+    // Chrome trace-event JSON 으로 저장 (tmp 파일에 쓴 뒤 rename). 이벤트는 한 줄에 하나 (trace_merge 가 줄 단위로 읽음)
+    // ts / dur 는 start() 시점 기준 us (소수점 아래 ns), otherData.epochNs 는 그 시점의 벽시계
+    bool writeJson(const std::string &path) const
+    {
+        if (!enabled())
+        {
+            return false;
+        }
+        std::string tmpPath = path + ".tmp";
+        {
+            std::ofstream out(tmpPath, std::ios::trunc);
+            if (!out)
+            {
+                std::cerr << "Failed to write trace to " << tmpPath << std::endl;
+                return false;
+            }
+
+            std::lock_guard<std::mutex> lock(mutex_);
+            char line[256];
+            out << "{\"traceEvents\":[\n";
+            out << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"" << process_ << "\"}}";
+            uint64_t dropped = 0;
+            for (const auto &buffer : buffers_)
+            {
+                std::lock_guard<std::mutex> bufferLock(buffer->mutex);
+                dropped += buffer->dropped;
+                for (const TraceEvent &event : buffer->events)
+                {
+                    if (event.startNs < originNs_)
+                    {
+                        continue; // start() 이전 기록 (다시 start 한 경우)
+                    }
+                    uint64_t ts = event.startNs - originNs_;
+                    int length = std::snprintf(line, sizeof(line),
+                                               ",\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%llu.%03llu,"
+                                               "\"dur\":%llu.%03llu,\"args\":{\"seq\":%lld}}",
+                                               event.name, buffer->tid, static_cast<unsigned long long>(ts / 1000),
+                                               static_cast<unsigned long long>(ts % 1000),
+                                               static_cast<unsigned long long>(event.durationNs / 1000),
+                                               static_cast<unsigned long long>(event.durationNs % 1000),
+                                               static_cast<long long>(event.seq));
+                    out.write(line, std::min<int>(length, sizeof(line) - 1));
+                }
+            }
+            out << "\n],\n\"displayTimeUnit\":\"ns\",\n";
+            out << "\"otherData\":{\"process\":\"" << process_ << "\",\"epochNs\":" << epochNs_ << ",\"dropped\":" << dropped
+                << "}}\n";
+        }
+        return std::rename(tmpPath.c_str(), path.c_str()) == 0;
+    }
+
+private:
+    struct Buffer
+    {
+        mutable std::mutex mutex;
+        std::vector<TraceEvent> events;
+        size_t next = 0; // 가득 찬 뒤 다음에 덮어쓸 위치
+        uint64_t dropped = 0;
+        unsigned tid = 0;
+    };
+
+    FrameTracer() = default;
+
+    // 스레드마다 처음 기록할 때 한 번 등록. 스레드가 끝나도 버퍼는 남겨 덤프에 포함
+    Buffer &threadBuffer()
+    {
+        thread_local Buffer *buffer = nullptr;
+        if (!buffer)
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            buffers_.push_back(std::make_unique<Buffer>());
+            buffer = buffers_.back().get();
+            buffer->tid = static_cast<unsigned>(buffers_.size());
+            buffer->events.reserve(std::min<size_t>(capacity_, 1024));
+        }
+        return *buffer;
+    }
+
+    std::atomic<bool> enabled_{false};
+    mutable std::mutex mutex_; // buffers_ 목록 / 설정 보호
+    std::vector<std::unique_ptr<Buffer>> buffers_;
+    std::string process_;
+    size_t capacity_ = 1 << 16;
+    uint64_t originNs_ = 0;
+    uint64_t epochNs_ = 0;
+};
+
+// 생성부터 소멸까지를 한 구간으로 기록
+class TraceScope
+{
+public:
+    explicit TraceScope(const char *name) : name_(name), startNs_(FrameTracer::instance().enabled() ? metricsNowNs() : 0) {}
+    ~TraceScope()
+    {
+        if (startNs_ != 0)
+        {
+            FrameTracer::instance().record(name_, startNs_, metricsNowNs());
+        }
+    }
+
+    TraceScope(const TraceScope &) = delete;
+    TraceScope &operator=(const TraceScope &) = delete;
+
+private:
+    const char *name_;
+    uint64_t startNs_;
+};
+
+// 범위 안에서 현재 스레드의 프레임 시퀀스 번호를 바꾸고 끝나면 이전 값으로 복원 (중첩 가능)
+class TraceFrame
+{
+public:
+    explicit TraceFrame(int64_t seq) : previous_(FrameTracer::currentFrame()) { FrameTracer::currentFrame() = seq; }
+    ~TraceFrame() { FrameTracer::currentFrame() = previous_; }
+
+    TraceFrame(const TraceFrame &) = delete;
+    TraceFrame &operator=(const TraceFrame &) = delete;
+
+private:
+    int64_t previous_;
+};
+
+// 주기적으로 트레이스 파일을 덮어씀 (서버처럼 종료 시점이 없는 프로세스용). 소멸 시 마지막으로 한 번 더 기록
+class TraceFileDumper
+{
+public:
+    TraceFileDumper(std::string path, std::chrono::seconds interval)
+        : path_(std::move(path)), interval_(interval), thread_(&TraceFileDumper::run, this) {}
+
+    ~TraceFileDumper()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        cv_.notify_one();
+        thread_.join();
+        FrameTracer::instance().writeJson(path_);
+    }
+
+private:
+    void run()
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (!cv_.wait_for(lock, interval_, [this]
+                             { return stopping_; }))
+        {
+            FrameTracer::instance().writeJson(path_);
+        }
+    }
+
+    std::string path_;
+    std::chrono::seconds interval_;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    bool stopping_ = false;
+    std::thread thread_; // 다른 멤버 초기화 후 시작되도록 마지막에 선언
+};
+
+#define TRACE_CONCAT_(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_(a, b)
+#define TRACE_SCOPE(name) TraceScope TRACE_CONCAT(traceScope_, __LINE__)(name)
+#define TRACE_FRAME(seq) TraceFrame TRACE_CONCAT(traceFrame_, __LINE__)(static_cast<int64_t>(seq))
+// 스코프로 감쌀 수 없는 구간 (비동기 수신 등). startNs / endNs 는 metricsNowNs 값
+#define TRACE_COMPLETE(name, startNs, endNs) FrameTracer::instance().record(name, startNs, endNs)
+
+#else
+
+#define TRACE_SCOPE(name) ((void)0)
+#define TRACE_FRAME(seq) ((void)0)
+#define TRACE_COMPLETE(name, startNs, endNs) ((void)0)
+
+#endif // FRAME_TRACE
+
+#endif // TRACE_H